@@ -319,22 +319,7 @@ template<> struct ldlt_inplace<Lower>
 
       transpositions.coeffRef(k) = IndexType(index_of_biggest_in_corner);
       if(k != index_of_biggest_in_corner)
-      {
-        // apply the transposition while taking care to consider only
-        // the lower triangular part
-        Index s = size-index_of_biggest_in_corner-1; // trailing size after the biggest element
-        mat.row(k).head(k).swap(mat.row(index_of_biggest_in_corner).head(k));
-        mat.col(k).tail(s).swap(mat.col(index_of_biggest_in_corner).tail(s));
-        std::swap(mat.coeffRef(k,k),mat.coeffRef(index_of_biggest_in_corner,index_of_biggest_in_corner));
-        for(Index i=k+1;i<index_of_biggest_in_corner;++i)
-        {
-          Scalar tmp = mat.coeffRef(i,k);
-          mat.coeffRef(i,k) = numext::conj(mat.coeffRef(index_of_biggest_in_corner,i));
-          mat.coeffRef(index_of_biggest_in_corner,i) = numext::conj(tmp);
-        }
-        if(NumTraits<Scalar>::IsComplex)
-          mat.coeffRef(index_of_biggest_in_corner,k) = numext::conj(mat.coeff(index_of_biggest_in_corner,k));
-      }
+        swap_symmetric(mat, k, index_of_biggest_in_corner);
 
       // partition the matrix:
       //       A00 |  -  |  -
@@ -381,19 +366,142 @@ template<> struct ldlt_inplace<Lower>
       if(found_zero_pivot && pivot_is_valid) ret = false; // factorization failed
       else if(!pivot_is_valid) found_zero_pivot = true;
 
-      if (sign == PositiveSemiDef) {
-        if (realAkk < static_cast<RealScalar>(0)) sign = Indefinite;
-      } else if (sign == NegativeSemiDef) {
-        if (realAkk > static_cast<RealScalar>(0)) sign = Indefinite;
-      } else if (sign == ZeroSign) {
-        if (realAkk > static_cast<RealScalar>(0)) sign = PositiveSemiDef;
-        else if (realAkk < static_cast<RealScalar>(0)) sign = NegativeSemiDef;
+      update_sign(sign, realAkk);
+    }
+
+    return ret;
+  }
+
+  /** \internal Blocked version of unblocked(), with the same pivots.
+    * The columns of a panel are computed from the updates of the previous columns of the panel, which are
+    * accumulated in \a W = L D, while the trailing matrix is updated once per panel by a triangular matrix
+    * product. Like unblocked(), the pivots are chosen among the diagonal coefficients of the input matrix,
+    * which are kept in \a temp since the panel updates overwrite them.
+    */
+  template<typename MatrixType, typename TranspositionType, typename Workspace>
+  static bool blocked(MatrixType& mat, TranspositionType& transpositions, Workspace& temp, SignMatrix& sign)
+  {
+    using std::abs;
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef typename TranspositionType::StorageIndex IndexType;
+    eigen_assert(mat.rows()==mat.cols());
+    const Index size = mat.rows();
+    if(size<32)
+      return unblocked(mat, transpositions, temp, sign);
+
+    Index blockSize = size/8;
+    blockSize = (blockSize/16)*16;
+    blockSize = (std::min)((std::max)(blockSize,Index(8)), Index(128));
+
+    Matrix<Scalar,Dynamic,Dynamic> W(size, blockSize);
+    temp = mat.diagonal();
+    bool found_zero_pivot = false;
+    bool ret = true;
+
+    for(Index k = 0; k < size; k += blockSize)
+    {
+      const Index bs = (std::min)(blockSize, size-k);
+
+      for(Index j = 0; j < bs; ++j)
+      {
+        const Index c = k+j;
+        const Index rs = size-c-1;
+
+        // Find largest diagonal element
+        Index index_of_biggest_in_corner;
+        temp.tail(size-c).cwiseAbs().maxCoeff(&index_of_biggest_in_corner);
+        index_of_biggest_in_corner += c;
+
+        transpositions.coeffRef(c) = IndexType(index_of_biggest_in_corner);
+        if(c != index_of_biggest_in_corner)
+        {
+          swap_symmetric(mat, c, index_of_biggest_in_corner);
+          W.row(c).head(j).swap(W.row(index_of_biggest_in_corner).head(j));
+          std::swap(temp.coeffRef(c), temp.coeffRef(index_of_biggest_in_corner));
+        }
+
+        // apply the updates of the previous columns of the panel to the current column
+        if(j>0)
+          mat.col(c).tail(size-c).noalias() -= mat.block(c,k,size-c,j) * W.row(c).head(j).adjoint();
+
+        RealScalar realAkk = numext::real(mat.coeffRef(c,c));
+        bool pivot_is_valid = (abs(realAkk) > RealScalar(0));
+
+        if(c==0 && !pivot_is_valid)
+        {
+          // The entire diagonal is zero, there is nothing more to do
+          // except filling the transpositions, and checking whether the matrix is zero.
+          sign = ZeroSign;
+          for(Index i = 0; i<size; ++i)
+          {
+            transpositions.coeffRef(i) = IndexType(i);
+            ret = ret && (mat.col(i).tail(size-i-1).array()==Scalar(0)).all();
+          }
+          return ret;
+        }
+
+        Block<MatrixType,Dynamic,1> A21(mat,c+1,c,rs,1);
+        if((rs>0) && pivot_is_valid)
+        {
+          W.col(j).tail(rs) = A21;
+          A21 /= realAkk;
+        }
+        else if(rs>0)
+        {
+          W.col(j).tail(rs).setZero();
+          ret = ret && (A21.array()==Scalar(0)).all();
+        }
+
+        if(found_zero_pivot && pivot_is_valid) ret = false; // factorization failed
+        else if(!pivot_is_valid) found_zero_pivot = true;
+
+        update_sign(sign, realAkk);
       }
+
+      // update the trailing matrix: A22 -= L21 D1 L21^* (bottleneck)
+      const Index rs = size-k-bs;
+      if(rs>0)
+        mat.bottomRightCorner(rs,rs).template triangularView<Lower>()
+          -= mat.block(k+bs,k,rs,bs) * W.block(k+bs,0,rs,bs).adjoint();
     }
 
     return ret;
   }
 
+  /** \internal Swaps the rows and columns \a k and \a p > \a k of the selfadjoint matrix stored in the lower
+    * triangular part of \a mat, while taking care to consider only the lower triangular part. */
+  template<typename MatrixType>
+  static void swap_symmetric(MatrixType& mat, Index k, Index p)
+  {
+    typedef typename MatrixType::Scalar Scalar;
+    Index s = mat.rows()-p-1; // trailing size after the biggest element
+    mat.row(k).head(k).swap(mat.row(p).head(k));
+    mat.col(k).tail(s).swap(mat.col(p).tail(s));
+    std::swap(mat.coeffRef(k,k),mat.coeffRef(p,p));
+    for(Index i=k+1;i<p;++i)
+    {
+      Scalar tmp = mat.coeffRef(i,k);
+      mat.coeffRef(i,k) = numext::conj(mat.coeffRef(p,i));
+      mat.coeffRef(p,i) = numext::conj(tmp);
+    }
+    if(NumTraits<Scalar>::IsComplex)
+      mat.coeffRef(p,k) = numext::conj(mat.coeff(p,k));
+  }
+
+  template<typename RealScalar>
+  static void update_sign(SignMatrix& sign, const RealScalar& realAkk)
+  {
+    if (sign == PositiveSemiDef) {
+      if (realAkk < static_cast<RealScalar>(0)) sign = Indefinite;
+    } else if (sign == NegativeSemiDef) {
+      if (realAkk > static_cast<RealScalar>(0)) sign = Indefinite;
+    } else if (sign == ZeroSign) {
+      if (realAkk > static_cast<RealScalar>(0)) sign = PositiveSemiDef;
+      else if (realAkk < static_cast<RealScalar>(0)) sign = NegativeSemiDef;
+    }
+  }
+
   // Reference for the algorithm: Davis and Hager, "Multiple Rank
   // Modifications of a Sparse Cholesky Factorization" (Algorithm 1)
   // Trivial rearrangements of their computations (Timothy E. Holy)
@@ -458,6 +566,13 @@ template<> struct ldlt_inplace<Upper>
     return ldlt_inplace<Lower>::unblocked(matt, transpositions, temp, sign);
   }
 
+  template<typename MatrixType, typename TranspositionType, typename Workspace>
+  static EIGEN_STRONG_INLINE bool blocked(MatrixType& mat, TranspositionType& transpositions, Workspace& temp, SignMatrix& sign)
+  {
+    Transpose<MatrixType> matt(mat);
+    return ldlt_inplace<Lower>::blocked(matt, transpositions, temp, sign);
+  }
+
   template<typename MatrixType, typename TranspositionType, typename Workspace, typename WType>
   static EIGEN_STRONG_INLINE bool update(MatrixType& mat, TranspositionType& transpositions, Workspace& tmp, WType& w, const typename MatrixType::RealScalar& sigma=1)
   {
@@ -515,7 +630,7 @@ LDLT<MatrixType,_UpLo>& LDLT<MatrixType,_UpLo>::compute(const EigenBase<InputTyp
   m_temporary.resize(size);
   m_sign = internal::ZeroSign;
 
-  m_info = internal::ldlt_inplace<UpLo>::unblocked(m_matrix, m_transpositions, m_temporary, m_sign) ? Success : NumericalIssue;
+  m_info = internal::ldlt_inplace<UpLo>::blocked(m_matrix, m_transpositions, m_temporary, m_sign) ? Success : NumericalIssue;
 
   m_isInitialized = true;
   return *this;
@@ -581,6 +581,247 @@ struct dense_assignment_loop<Kernel, SliceVectorizedTraversal, InnerUnrolling>
 };
 #endif
 
+#ifdef EIGEN_PARALLELIZE_ASSIGNMENT
+
+/***************************
+*** Partial traversals ***
+***************************/
+
+// dense_assignment_range_loop<Kernel>::run(kernel,start,end) performs the part [start,end) of the traversal
+// of dense_assignment_loop<Kernel>, where start and end are linear indices for the linear traversals,
+// and outer indices otherwise. The packets are aligned exactly as in the complete traversal, so that
+// the parts of any partition of the traversal can be assigned independently (see dense_assignment_parallelizer).
+// Completely unrolled traversals are not supported.
+
+template<typename Kernel,
+         int Traversal = Kernel::AssignmentTraits::Traversal,
+         int Unrolling = Kernel::AssignmentTraits::Unrolling>
+struct dense_assignment_range_loop;
+
+template<typename Kernel>
+struct dense_assignment_range_loop<Kernel, DefaultTraversal, NoUnrolling>
+{
+  static void run(Kernel &kernel, Index start, Index end)
+  {
+    const Index innerSize = kernel.innerSize();
+    for(Index outer = start; outer < end; ++outer)
+      for(Index inner = 0; inner < innerSize; ++inner)
+        kernel.assignCoeffByOuterInner(outer, inner);
+  }
+};
+
+template<typename Kernel>
+struct dense_assignment_range_loop<Kernel, DefaultTraversal, InnerUnrolling>
+{
+  static void run(Kernel &kernel, Index start, Index end)
+  {
+    typedef typename Kernel::DstEvaluatorType::XprType DstXprType;
+    for(Index outer = start; outer < end; ++outer)
+      copy_using_evaluator_DefaultTraversal_InnerUnrolling<Kernel, 0, DstXprType::InnerSizeAtCompileTime>::run(kernel, outer);
+  }
+};
+
+template<typename Kernel>
+struct dense_assignment_range_loop<Kernel, LinearVectorizedTraversal, NoUnrolling>
+{
+  static void run(Kernel &kernel, Index start, Index end)
+  {
+    const Index size = kernel.size();
+    typedef typename Kernel::Scalar Scalar;
+    typedef typename Kernel::PacketType PacketType;
+    enum {
+      requestedAlignment = Kernel::AssignmentTraits::LinearRequiredAlignment,
+      packetSize = unpacket_traits<PacketType>::size,
+      dstIsAligned = int(Kernel::AssignmentTraits::DstAlignment)>=int(requestedAlignment),
+      dstAlignment = packet_traits<Scalar>::AlignedOnScalar ? int(requestedAlignment)
+                                                            : int(Kernel::AssignmentTraits::DstAlignment),
+      srcAlignment = Kernel::AssignmentTraits::JointAlignment
+    };
+    const Index alignedStart = dstIsAligned ? 0 : internal::first_aligned<requestedAlignment>(kernel.dstDataPtr(), size);
+    const Index alignedEnd = alignedStart + ((size-alignedStart)/packetSize)*packetSize;
+
+    // packets of the complete traversal lying in [start,end)
+    Index first = start<=alignedStart ? alignedStart
+                                      : alignedStart + ((start-alignedStart+packetSize-1)/packetSize)*packetSize;
+    first = numext::mini(first, end);
+    const Index stop = numext::mini(end, alignedEnd);
+    const Index last = stop>first ? first + ((stop-first)/packetSize)*packetSize : first;
+
+    unaligned_dense_assignment_loop<>::run(kernel, start, first);
+
+    for(Index index = first; index < last; index += packetSize)
+      kernel.template assignPacket<dstAlignment, srcAlignment, PacketType>(index);
+
+    unaligned_dense_assignment_loop<>::run(kernel, last, end);
+  }
+};
+
+template<typename Kernel>
+struct dense_assignment_range_loop<Kernel, InnerVectorizedTraversal, NoUnrolling>
+{
+  static void run(Kernel &kernel, Index start, Index end)
+  {
+    typedef typename Kernel::PacketType PacketType;
+    typedef typename Kernel::AssignmentTraits Traits;
+    const Index innerSize = kernel.innerSize();
+    const Index packetSize = unpacket_traits<PacketType>::size;
+    for(Index outer = start; outer < end; ++outer)
+      for(Index inner = 0; inner < innerSize; inner+=packetSize)
+        kernel.template assignPacketByOuterInner<Traits::DstAlignment, Traits::SrcAlignment, PacketType>(outer, inner);
+  }
+};
+
+template<typename Kernel>
+struct dense_assignment_range_loop<Kernel, InnerVectorizedTraversal, InnerUnrolling>
+{
+  static void run(Kernel &kernel, Index start, Index end)
+  {
+    typedef typename Kernel::DstEvaluatorType::XprType DstXprType;
+    typedef typename Kernel::AssignmentTraits Traits;
+    for(Index outer = start; outer < end; ++outer)
+      copy_using_evaluator_innervec_InnerUnrolling<Kernel, 0, DstXprType::InnerSizeAtCompileTime,
+                                                   Traits::SrcAlignment, Traits::DstAlignment>::run(kernel, outer);
+  }
+};
+
+template<typename Kernel>
+struct dense_assignment_range_loop<Kernel, LinearTraversal, NoUnrolling>
+{
+  static void run(Kernel &kernel, Index start, Index end)
+  {
+    for(Index i = start; i < end; ++i)
+      kernel.assignCoeff(i);
+  }
+};
+
+template<typename Kernel>
+struct dense_assignment_range_loop<Kernel, SliceVectorizedTraversal, NoUnrolling>
+{
+  static void run(Kernel &kernel, Index start, Index end)
+  {
+    typedef typename Kernel::Scalar Scalar;
+    typedef typename Kernel::PacketType PacketType;
+    enum {
+      packetSize = unpacket_traits<PacketType>::size,
+      requestedAlignment = int(Kernel::AssignmentTraits::InnerRequiredAlignment),
+      alignable = packet_traits<Scalar>::AlignedOnScalar || int(Kernel::AssignmentTraits::DstAlignment)>=sizeof(Scalar),
+      dstIsAligned = int(Kernel::AssignmentTraits::DstAlignment)>=int(requestedAlignment),
+      dstAlignment = alignable ? int(requestedAlignment)
+                               : int(Kernel::AssignmentTraits::DstAlignment)
+    };
+    const Scalar *dst_ptr = kernel.dstDataPtr();
+    if((!bool(dstIsAligned)) && (UIntPtr(dst_ptr) % sizeof(Scalar))>0)
+      return dense_assignment_range_loop<Kernel,DefaultTraversal,NoUnrolling>::run(kernel, start, end);
+
+    const Index packetAlignedMask = packetSize - 1;
+    const Index innerSize = kernel.innerSize();
+    const Index alignedStep = alignable ? (packetSize - kernel.outerStride() % packetSize) & packetAlignedMask : 0;
+    Index alignedStart = ((!alignable) || bool(dstIsAligned)) ? 0 : internal::first_aligned<requestedAlignment>(dst_ptr, innerSize);
+    // alignment of the first outer index of the range
+    alignedStart = numext::mini((alignedStart + (start%packetSize)*alignedStep)%packetSize, innerSize);
+
+    for(Index outer = start; outer < end; ++outer)
+    {
+      const Index alignedEnd = alignedStart + ((innerSize-alignedStart) & ~packetAlignedMask);
+      for(Index inner = 0; inner<alignedStart ; ++inner)
+        kernel.assignCoeffByOuterInner(outer, inner);
+
+      for(Index inner = alignedStart; inner<alignedEnd; inner+=packetSize)
+        kernel.template assignPacketByOuterInner<dstAlignment, Unaligned, PacketType>(outer, inner);
+
+      for(Index inner = alignedEnd; inner<innerSize ; ++inner)
+        kernel.assignCoeffByOuterInner(outer, inner);
+
+      alignedStart = numext::mini((alignedStart+alignedStep)%packetSize, innerSize);
+    }
+  }
+};
+
+#if EIGEN_UNALIGNED_VECTORIZE
+template<typename Kernel>
+struct dense_assignment_range_loop<Kernel, SliceVectorizedTraversal, InnerUnrolling>
+{
+  static void run(Kernel &kernel, Index start, Index end)
+  {
+    typedef typename Kernel::DstEvaluatorType::XprType DstXprType;
+    typedef typename Kernel::PacketType PacketType;
+
+    enum { size = DstXprType::InnerSizeAtCompileTime,
+           packetSize =unpacket_traits<PacketType>::size,
+           vectorizableSize = (size/packetSize)*packetSize };
+
+    for(Index outer = start; outer < end; ++outer)
+    {
+      copy_using_evaluator_innervec_InnerUnrolling<Kernel, 0, vectorizableSize, 0, 0>::run(kernel, outer);
+      copy_using_evaluator_DefaultTraversal_InnerUnrolling<Kernel, vectorizableSize, size>::run(kernel, outer);
+    }
+  }
+};
+#endif
+
+// Tells whether the coefficients of an expression can be evaluated concurrently and in any order.
+// This is not the case of the random generators, which are searched through the coefficient-wise operations and
+// the views evaluated on the fly. The other expressions, like products, evaluate such nested expressions into
+// temporaries when their evaluator is created, i.e., on the calling thread.
+template<typename XprType> struct assignment_source_is_repeatable { enum { value = true }; };
+template<typename NullaryOp, typename PlainObjectType>
+struct assignment_source_is_repeatable<CwiseNullaryOp<NullaryOp,PlainObjectType> >
+{ enum { value = functor_traits<NullaryOp>::IsRepeatable }; };
+
+template<typename XprType> struct assignment_nested_is_repeatable
+  : assignment_source_is_repeatable<typename remove_all<XprType>::type> {};
+
+template<typename UnaryOp, typename XprType>
+struct assignment_source_is_repeatable<CwiseUnaryOp<UnaryOp,XprType> > : assignment_nested_is_repeatable<XprType> {};
+template<typename ViewOp, typename XprType>
+struct assignment_source_is_repeatable<CwiseUnaryView<ViewOp,XprType> > : assignment_nested_is_repeatable<XprType> {};
+template<typename BinaryOp, typename Lhs, typename Rhs>
+struct assignment_source_is_repeatable<CwiseBinaryOp<BinaryOp,Lhs,Rhs> >
+{ enum { value = assignment_nested_is_repeatable<Lhs>::value && assignment_nested_is_repeatable<Rhs>::value }; };
+template<typename TernaryOp, typename Arg1, typename Arg2, typename Arg3>
+struct assignment_source_is_repeatable<CwiseTernaryOp<TernaryOp,Arg1,Arg2,Arg3> >
+{ enum { value = assignment_nested_is_repeatable<Arg1>::value && assignment_nested_is_repeatable<Arg2>::value
+              && assignment_nested_is_repeatable<Arg3>::value }; };
+template<typename ConditionType, typename ThenType, typename ElseType>
+struct assignment_source_is_repeatable<Select<ConditionType,ThenType,ElseType> >
+{ enum { value = assignment_nested_is_repeatable<ConditionType>::value && assignment_nested_is_repeatable<ThenType>::value
+              && assignment_nested_is_repeatable<ElseType>::value }; };
+template<typename XprType, int BlockRows, int BlockCols, bool InnerPanel>
+struct assignment_source_is_repeatable<Block<XprType,BlockRows,BlockCols,InnerPanel> > : assignment_nested_is_repeatable<XprType> {};
+template<typename XprType, typename RowIndices, typename ColIndices>
+struct assignment_source_is_repeatable<IndexedView<XprType,RowIndices,ColIndices> > : assignment_nested_is_repeatable<XprType> {};
+template<typename XprType>
+struct assignment_source_is_repeatable<Transpose<XprType> > : assignment_nested_is_repeatable<XprType> {};
+template<typename XprType, int Direction>
+struct assignment_source_is_repeatable<Reverse<XprType,Direction> > : assignment_nested_is_repeatable<XprType> {};
+template<typename XprType, int RowFactor, int ColFactor>
+struct assignment_source_is_repeatable<Replicate<XprType,RowFactor,ColFactor> > : assignment_nested_is_repeatable<XprType> {};
+template<typename XprType, int DiagIndex>
+struct assignment_source_is_repeatable<Diagonal<XprType,DiagIndex> > : assignment_nested_is_repeatable<XprType> {};
+template<typename XprType>
+struct assignment_source_is_repeatable<ArrayWrapper<XprType> > : assignment_nested_is_repeatable<XprType> {};
+template<typename XprType>
+struct assignment_source_is_repeatable<MatrixWrapper<XprType> > : assignment_nested_is_repeatable<XprType> {};
+
+// Entry point of the parallel assignment, defined in Parallelizer.h.
+// Only the large enough dynamic-size assignments are dispatched to the threads.
+template<typename Kernel, typename SrcXprType,
+         bool MayParallelize = int(Kernel::DstEvaluatorType::XprType::SizeAtCompileTime)==Dynamic
+                            && int(Kernel::AssignmentTraits::Unrolling)!=int(CompleteUnrolling)
+                            && bool(assignment_source_is_repeatable<SrcXprType>::value)>
+struct dense_assignment_parallelizer;
+
+template<typename Kernel, typename SrcXprType>
+struct dense_assignment_parallelizer<Kernel, SrcXprType, false>
+{
+  EIGEN_STRONG_INLINE static void run(Kernel &kernel)
+  {
+    dense_assignment_loop<Kernel>::run(kernel);
+  }
+};
+
+#endif // EIGEN_PARALLELIZE_ASSIGNMENT
+
 
 /***************************************************************************
 * Part 4 : Generic dense assignment kernel
@@ -604,6 +845,7 @@ public:
   typedef SrcEvaluatorTypeT SrcEvaluatorType;
   typedef typename DstEvaluatorType::Scalar Scalar;
   typedef copy_using_evaluator_traits<DstEvaluatorTypeT, SrcEvaluatorTypeT, Functor> AssignmentTraits;
+  typedef Functor AssignmentFunctor;
   typedef typename AssignmentTraits::PacketType PacketType;
   
   
@@ -738,7 +980,11 @@ EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE void call_dense_assignment_loop(DstXprType
   typedef generic_dense_assignment_kernel<DstEvaluatorType,SrcEvaluatorType,Functor> Kernel;
   Kernel kernel(dstEvaluator, srcEvaluator, func, dst.const_cast_derived());
 
+#if defined(EIGEN_PARALLELIZE_ASSIGNMENT) && !defined(EIGEN_CUDA_ARCH)
+  dense_assignment_parallelizer<Kernel,SrcXprType>::run(kernel);
+#else
   dense_assignment_loop<Kernel>::run(kernel);
+#endif
 }
 
 template<typename DstXprType, typename SrcXprType>
@@ -793,6 +1039,7 @@ template<typename Dst, typename Src, typename Func>
 EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE
 void call_assignment(Dst& dst, const Src& src, const Func& func, typename enable_if< evaluator_assume_aliasing<Src>::value, void*>::type = 0)
 {
+  EIGEN_MALLOC_TRACE_TYPE(Src);
   typename plain_matrix_type<Src>::type tmp(src);
   call_assignment_no_alias(dst, tmp, func);
 }
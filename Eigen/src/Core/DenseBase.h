@@ -365,6 +365,8 @@ template<typename Derived> class DenseBase
     EIGEN_DEVICE_FUNC Derived& setZero();
     EIGEN_DEVICE_FUNC Derived& setOnes();
     EIGEN_DEVICE_FUNC Derived& setRandom();
+    Derived& setRandom(PhiloxGenerator& generator);
+    Derived& setRandomNormal(PhiloxGenerator& generator);
 
     template<typename OtherDerived> EIGEN_DEVICE_FUNC
     bool isApprox(const DenseBase<OtherDerived>& other,
@@ -523,6 +525,15 @@ template<typename Derived> class DenseBase
     static const RandomReturnType Random(Index size);
     static const RandomReturnType Random();
 
+    typedef CwiseNullaryOp<internal::scalar_uniform_random_op<Scalar>,PlainObject> UniformRandomReturnType;
+    typedef CwiseNullaryOp<internal::scalar_normal_random_op<Scalar>,PlainObject> NormalRandomReturnType;
+    static const UniformRandomReturnType Random(Index rows, Index cols, PhiloxGenerator& generator);
+    static const UniformRandomReturnType Random(Index size, PhiloxGenerator& generator);
+    static const UniformRandomReturnType Random(PhiloxGenerator& generator);
+    static const NormalRandomReturnType RandomNormal(Index rows, Index cols, PhiloxGenerator& generator);
+    static const NormalRandomReturnType RandomNormal(Index size, PhiloxGenerator& generator);
+    static const NormalRandomReturnType RandomNormal(PhiloxGenerator& generator);
+
     template<typename ThenDerived,typename ElseDerived>
     const Select<Derived,ThenDerived,ElseDerived>
     select(const DenseBase<ThenDerived>& thenMatrix,
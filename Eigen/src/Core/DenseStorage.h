@@ -565,6 +565,142 @@ template<typename T, int _Cols, int _Options> class DenseStorage<T, Dynamic, Dyn
     EIGEN_DEVICE_FUNC T *data() { return m_data; }
 };
 
+namespace internal {
+
+/** \internal
+  * Storage of the dynamic-size matrices and arrays having the #InlineStorage option: up to \a Size coefficients
+  * are kept in an inline array, and larger ones are allocated on the heap. The heap pointer is null while the
+  * coefficients are inline, so that the storage remains relocatable by a plain memory copy as the other ones.
+  */
+template<typename T, int Size, int _Rows, int _Cols, int _Options> class inline_dense_storage
+{
+    enum { Align = (_Options&DontAlign)==0 };
+    plain_array<T,Size,_Options> m_inline;
+    T *m_heap;
+    Index m_rows;
+    Index m_cols;
+
+    T* allocate(Index size)
+    {
+      if(size<=Size)
+        return 0;
+      EIGEN_INTERNAL_DENSE_STORAGE_CTOR_PLUGIN({})
+      return conditional_aligned_new_auto<T,Align>(size);
+    }
+  public:
+    EIGEN_DEVICE_FUNC inline_dense_storage()
+      : m_heap(0), m_rows(_Rows==Dynamic ? 0 : _Rows), m_cols(_Cols==Dynamic ? 0 : _Cols) {}
+    EIGEN_DEVICE_FUNC explicit inline_dense_storage(constructor_without_unaligned_array_assert)
+      : m_inline(constructor_without_unaligned_array_assert()), m_heap(0),
+        m_rows(_Rows==Dynamic ? 0 : _Rows), m_cols(_Cols==Dynamic ? 0 : _Cols) {}
+    EIGEN_DEVICE_FUNC inline_dense_storage(Index size, Index rows, Index cols)
+      : m_heap(allocate(size)), m_rows(rows), m_cols(cols)
+    {
+      eigen_internal_assert(size==rows*cols && rows>=0 && cols>=0);
+    }
+    EIGEN_DEVICE_FUNC inline_dense_storage(const inline_dense_storage& other)
+      : m_heap(allocate(other.m_rows*other.m_cols)), m_rows(other.m_rows), m_cols(other.m_cols)
+    {
+      smart_copy(other.data(), other.data()+m_rows*m_cols, data());
+    }
+    EIGEN_DEVICE_FUNC inline_dense_storage& operator=(const inline_dense_storage& other)
+    {
+      if (this != &other)
+      {
+        resize(other.m_rows*other.m_cols, other.m_rows, other.m_cols);
+        smart_copy(other.data(), other.data()+m_rows*m_cols, data());
+      }
+      return *this;
+    }
+#if EIGEN_HAS_RVALUE_REFERENCES
+    EIGEN_DEVICE_FUNC
+    inline_dense_storage(inline_dense_storage&& other) EIGEN_NOEXCEPT
+      : m_heap(other.m_heap), m_rows(other.m_rows), m_cols(other.m_cols)
+    {
+      if(m_heap)
+      {
+        other.m_heap = 0;
+        other.m_rows = _Rows==Dynamic ? 0 : _Rows;
+        other.m_cols = _Cols==Dynamic ? 0 : _Cols;
+      }
+      else
+        smart_copy(other.m_inline.array, other.m_inline.array+m_rows*m_cols, m_inline.array);
+    }
+    EIGEN_DEVICE_FUNC
+    inline_dense_storage& operator=(inline_dense_storage&& other) EIGEN_NOEXCEPT
+    {
+      swap(other);
+      return *this;
+    }
+#endif
+    EIGEN_DEVICE_FUNC ~inline_dense_storage()
+    {
+      if(m_heap)
+        conditional_aligned_delete_auto<T,Align>(m_heap, m_rows*m_cols);
+    }
+    EIGEN_DEVICE_FUNC void swap(inline_dense_storage& other)
+    {
+      if(m_heap==0 && other.m_heap==0)
+        std::swap_ranges(m_inline.array, m_inline.array+(std::max)(m_rows*m_cols, other.m_rows*other.m_cols), other.m_inline.array);
+      else if(m_heap==0)
+        smart_copy(m_inline.array, m_inline.array+m_rows*m_cols, other.m_inline.array);
+      else if(other.m_heap==0)
+        smart_copy(other.m_inline.array, other.m_inline.array+other.m_rows*other.m_cols, m_inline.array);
+      std::swap(m_heap,other.m_heap); std::swap(m_rows,other.m_rows); std::swap(m_cols,other.m_cols);
+    }
+    EIGEN_DEVICE_FUNC Index rows(void) const {return m_rows;}
+    EIGEN_DEVICE_FUNC Index cols(void) const {return m_cols;}
+    void conservativeResize(Index size, Index rows, Index cols)
+    {
+      Index oldSize = m_rows*m_cols;
+      if(m_heap && size>Size)
+        m_heap = conditional_aligned_realloc_new_auto<T,Align>(m_heap, size, oldSize);
+      else if(size>Size)
+      {
+        m_heap = allocate(size);
+        smart_copy(m_inline.array, m_inline.array+oldSize, m_heap);
+      }
+      else if(m_heap)
+      {
+        smart_copy(m_heap, m_heap+size, m_inline.array);
+        conditional_aligned_delete_auto<T,Align>(m_heap, oldSize);
+        m_heap = 0;
+      }
+      m_rows = rows;
+      m_cols = cols;
+    }
+    EIGEN_DEVICE_FUNC void resize(Index size, Index rows, Index cols)
+    {
+      if(size != m_rows*m_cols)
+      {
+        if(m_heap)
+          conditional_aligned_delete_auto<T,Align>(m_heap, m_rows*m_cols);
+        m_heap = 0;
+        m_heap = allocate(size);
+      }
+      m_rows = rows;
+      m_cols = cols;
+    }
+    EIGEN_DEVICE_FUNC const T *data() const { return m_heap ? m_heap : m_inline.array; }
+    EIGEN_DEVICE_FUNC T *data() { return m_heap ? m_heap : m_inline.array; }
+};
+
+/** \internal The storage of a plain matrix or array, see inline_dense_storage and DenseStorage */
+template<typename T, int MaxSize, int InlineSize, int _Rows, int _Cols, int _Options,
+         bool HasInlineStorage = (InlineSize!=Dynamic) && (MaxSize==Dynamic)>
+struct plain_dense_storage
+{
+  typedef DenseStorage<T, MaxSize, _Rows, _Cols, _Options> type;
+};
+
+template<typename T, int MaxSize, int InlineSize, int _Rows, int _Cols, int _Options>
+struct plain_dense_storage<T, MaxSize, InlineSize, _Rows, _Cols, _Options, true>
+{
+  typedef inline_dense_storage<T, InlineSize, _Rows, _Cols, _Options> type;
+};
+
+} // end namespace internal
+
 } // end namespace Eigen
 
 #endif // EIGEN_MATRIX_H
@@ -0,0 +1,123 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_HUGE_PAGE_ALLOCATOR_H
+#define EIGEN_HUGE_PAGE_ALLOCATOR_H
+
+#if EIGEN_OS_LINUX
+#include <sys/mman.h>
+#endif
+
+namespace Eigen {
+
+#ifndef EIGEN_HUGE_PAGE_SIZE
+// Alignment of the large buffers returned by hugePageAllocatorHook(), this should match the size of the
+// transparent huge pages of the system.
+#define EIGEN_HUGE_PAGE_SIZE (std::size_t(2)*1024*1024)
+#endif
+
+#ifndef EIGEN_HUGE_PAGE_THRESHOLD
+// Size in bytes above which hugePageAllocatorHook() places a buffer on huge pages.
+#define EIGEN_HUGE_PAGE_THRESHOLD (std::size_t(4)*1024*1024)
+#endif
+
+namespace internal {
+
+/* Writes one byte per page of a freshly allocated buffer, splitting it in contiguous chunks across the threads,
+ * so that on NUMA systems each chunk is placed on the node of the thread which will likely process it. */
+struct first_touch_task
+{
+  first_touch_task(char* data, std::size_t size) : m_data(data), m_size(size) {}
+
+  void operator()(Index i, Index n) const
+  {
+    const std::size_t page = 4096;
+    std::size_t pages = (m_size+page-1)/page;
+    std::size_t start = pages*std::size_t(i)/std::size_t(n), end = pages*std::size_t(i+1)/std::size_t(n);
+    for(std::size_t k=start; k<end; ++k)
+      m_data[k*page] = 0;
+  }
+
+  char* m_data;
+  std::size_t m_size;
+};
+
+/* Allocates size bytes such that the returned buffer shifted by offset bytes is aligned on alignment, and stores
+ * the pointer returned by std::malloc right before the returned buffer, as handmade_aligned_malloc does.
+ * The offset skips the header of the buffer (see allocator_hook_header_bytes), so that the data of a matrix is aligned. */
+inline void* huge_page_malloc(std::size_t size, std::size_t alignment, std::size_t offset)
+{
+  void *original = std::malloc(size+alignment);
+  if(original==0)
+    return 0;
+  std::size_t boundary = ((reinterpret_cast<std::size_t>(original) + offset) & ~(alignment-1)) + alignment;
+  void *aligned = reinterpret_cast<void*>(boundary - offset);
+  *(reinterpret_cast<void**>(aligned) - 1) = original;
+  return aligned;
+}
+
+template<bool ParallelFirstTouch>
+void* huge_page_allocate(std::size_t size)
+{
+  if(size<EIGEN_HUGE_PAGE_THRESHOLD)
+    return huge_page_malloc(size, (std::max)(std::size_t(EIGEN_DEFAULT_ALIGN_BYTES), sizeof(void*)), 0);
+
+  const std::size_t offset = allocator_hook_header_bytes;
+  char* result = static_cast<char*>(huge_page_malloc(size, EIGEN_HUGE_PAGE_SIZE, offset));
+  if(result==0)
+    return 0;
+#if EIGEN_OS_LINUX && defined(MADV_HUGEPAGE)
+  // only the whole huge pages of the buffer can be advised, the advice is a hint and failures are ignored
+  std::size_t advised = (size-offset) & ~(EIGEN_HUGE_PAGE_SIZE-1);
+  if(advised>0)
+    madvise(result+offset, advised, MADV_HUGEPAGE);
+#endif
+  if(ParallelFirstTouch)
+  {
+    Index threads = (std::min<Index>)(nbThreads(), Index(size/EIGEN_HUGE_PAGE_SIZE));
+    if(threads>1 && !is_in_parallel_region())
+      parallelize_tasks(threads, first_touch_task(result, size));
+  }
+  return result;
+}
+
+inline void huge_page_deallocate(void* ptr)
+{
+  if(ptr)
+    std::free(*(reinterpret_cast<void**>(ptr) - 1));
+}
+
+} // end namespace internal
+
+/** \returns an AllocatorHook placing the buffers of at least \c EIGEN_HUGE_PAGE_THRESHOLD bytes (4MB by default)
+  * on transparent huge pages: such buffers are aligned on \c EIGEN_HUGE_PAGE_SIZE (2MB by default) and advised with
+  * \c madvise(MADV_HUGEPAGE) on Linux, which reduces the TLB misses of the products and decompositions of large matrices.
+  * Smaller buffers are allocated as usual.
+  *
+  * If \a parallelFirstTouch is true, the pages of a large buffer are first touched by nbThreads() threads, each one
+  * touching a contiguous chunk, so that on NUMA systems the buffer is spread over the memory nodes of the threads
+  * which will later process it rather than being entirely placed on the node of the allocating thread.
+  *
+  * Example:
+  * \code
+  * setAllocatorHook(hugePageAllocatorHook());          // all the allocations of Eigen
+  * setAllocatorHook<double>(hugePageAllocatorHook(true)); // only the dense objects of doubles
+  * \endcode
+  *
+  * Requires \c EIGEN_ALLOCATOR_HOOK.
+  * \sa AllocatorHook, setAllocatorHook()
+  */
+inline const AllocatorHook* hugePageAllocatorHook(bool parallelFirstTouch = false)
+{
+  static const AllocatorHook hook = { internal::huge_page_allocate<false>, internal::huge_page_deallocate };
+  static const AllocatorHook parallelHook = { internal::huge_page_allocate<true>, internal::huge_page_deallocate };
+  return parallelFirstTouch ? &parallelHook : &hook;
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_HUGE_PAGE_ALLOCATOR_H
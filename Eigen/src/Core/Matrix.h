@@ -22,8 +22,11 @@ private:
   typedef typename find_best_packet<_Scalar,size>::type PacketScalar;
   enum {
       row_major_bit = _Options&RowMajor ? RowMajorBit : 0,
+      // with InlineStorage, _MaxRows x _MaxCols is the inline capacity of a dynamic-size object rather than a bound
+      has_inline_storage = (_Options&InlineStorage) && size==Dynamic && _MaxRows!=Dynamic && _MaxCols!=Dynamic,
       is_dynamic_size_storage = _MaxRows==Dynamic || _MaxCols==Dynamic,
       max_size = is_dynamic_size_storage ? Dynamic : _MaxRows*_MaxCols,
+      // the inline coefficients are aligned as the ones of a fixed-size object, and the heap ones at least as much
       default_alignment = compute_default_alignment<_Scalar,max_size>::value,
       actual_alignment = ((_Options&DontAlign)==0) ? default_alignment : 0,
       required_alignment = unpacket_traits<PacketScalar>::alignment,
@@ -38,8 +41,9 @@ public:
   enum {
     RowsAtCompileTime = _Rows,
     ColsAtCompileTime = _Cols,
-    MaxRowsAtCompileTime = _MaxRows,
-    MaxColsAtCompileTime = _MaxCols,
+    MaxRowsAtCompileTime = (has_inline_storage && _Rows==Dynamic) ? Dynamic : _MaxRows,
+    MaxColsAtCompileTime = (has_inline_storage && _Cols==Dynamic) ? Dynamic : _MaxCols,
+    InlineSizeAtCompileTime = has_inline_storage ? max_size : Dynamic,
     Flags = compute_matrix_flags<_Scalar, _Rows, _Cols, _Options, _MaxRows, _MaxCols>::ret,
     Options = _Options,
     InnerStrideAtCompileTime = 1,
@@ -69,10 +73,11 @@ public:
   * \tparam _Cols Number of columns, or \b Dynamic
   *
   * The remaining template parameters are optional -- in most cases you don't have to worry about them.
-  * \tparam _Options A combination of either \b #RowMajor or \b #ColMajor, and of either
-  *                 \b #AutoAlign or \b #DontAlign.
-  *                 The former controls \ref TopicStorageOrders "storage order", and defaults to column-major. The latter controls alignment, which is required
+  * \tparam _Options A combination of either \b #RowMajor or \b #ColMajor, of either
+  *                 \b #AutoAlign or \b #DontAlign, and optionally of \b #InlineStorage.
+  *                 The first controls \ref TopicStorageOrders "storage order", and defaults to column-major. The second controls alignment, which is required
   *                 for vectorization. It defaults to aligning matrices except for fixed sizes that aren't a multiple of the packet size.
+  *                 The last one enables a small-buffer optimization of dynamic-size matrices (\ref inlinestorage "note").
   * \tparam _MaxRows Maximum number of rows. Defaults to \a _Rows (\ref maxrows "note").
   * \tparam _MaxCols Maximum number of columns. Defaults to \a _Cols (\ref maxrows "note").
   *
@@ -134,6 +139,18 @@ public:
   * when the exact numbers of rows and columns are not known are compile-time, but it is known at compile-time that they cannot
   * exceed a certain value. This happens when taking dynamic-size blocks inside fixed-size matrices: in this case _MaxRows and _MaxCols
   * are the dimensions of the original matrix, while _Rows and _Cols are Dynamic.</dd>
+  *
+  * <dt><b>\anchor inlinestorage Inline storage:</b></dt>
+  * <dd>With the #InlineStorage option, _MaxRows and _MaxCols are no longer a bound on the size of a dynamic-size matrix, but the capacity
+  * of an inline buffer: the coefficients are stored inside the matrix object as long as they fit in _MaxRows x _MaxCols, and on the heap
+  * otherwise. This avoids the heap allocations of matrices whose size is usually small but is not bounded, e.g.:
+  * \code
+  * typedef Matrix<double,Dynamic,Dynamic,ColMajor|InlineStorage,6,6> MatrixXdInline;
+  * MatrixXdInline a(4,4);     // no heap allocation
+  * a.resize(20,20);           // the coefficients are moved to the heap
+  * \endcode
+  * Such matrices have MaxRowsAtCompileTime and MaxColsAtCompileTime equal to Dynamic for their dynamic dimensions. Their inline buffer is
+  * aligned as a fixed-size matrix of _MaxRows x _MaxCols coefficients, so that the same \ref TopicStructHavingEigenMembers "alignment rules" apply.</dd>
   * </dl>
   *
   * <i><b>ABI and storage layout</b></i>
@@ -136,10 +136,12 @@ class PlainObjectBase : public internal::dense_xpr_base<Derived>::type
     template<typename StrideType> struct StridedConstAlignedMapType { typedef Eigen::Map<const Derived, AlignedMax, StrideType> type; };
 
   protected:
-    DenseStorage<Scalar, Base::MaxSizeAtCompileTime, Base::RowsAtCompileTime, Base::ColsAtCompileTime, Options> m_storage;
+    typename internal::plain_dense_storage<Scalar, Base::MaxSizeAtCompileTime, internal::traits<Derived>::InlineSizeAtCompileTime,
+                                           Base::RowsAtCompileTime, Base::ColsAtCompileTime, Options>::type m_storage;
 
   public:
-    enum { NeedsToAlign = (SizeAtCompileTime != Dynamic) && (internal::traits<Derived>::Alignment>0) };
+    enum { NeedsToAlign = (SizeAtCompileTime != Dynamic || internal::traits<Derived>::InlineSizeAtCompileTime != Dynamic)
+                          && (internal::traits<Derived>::Alignment>0) };
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF(NeedsToAlign)
 
     EIGEN_DEVICE_FUNC
@@ -284,6 +286,7 @@ class PlainObjectBase : public internal::dense_xpr_base<Derived>::type
                    && EIGEN_IMPLIES(ColsAtCompileTime==Dynamic && MaxColsAtCompileTime!=Dynamic,cols<=MaxColsAtCompileTime)
                    && rows>=0 && cols>=0 && "Invalid sizes when resizing a matrix or array.");
       internal::check_rows_cols_for_overflow<MaxSizeAtCompileTime>::run(rows, cols);
+      EIGEN_MALLOC_TRACE_TYPE(Derived);
       #ifdef EIGEN_INITIALIZE_COEFFS
         Index size = rows*cols;
         bool size_changed = size != this->size();
@@ -310,6 +313,7 @@ class PlainObjectBase : public internal::dense_xpr_base<Derived>::type
     {
       EIGEN_STATIC_ASSERT_VECTOR_ONLY(PlainObjectBase)
       eigen_assert(((SizeAtCompileTime == Dynamic && (MaxSizeAtCompileTime==Dynamic || size<=MaxSizeAtCompileTime)) || SizeAtCompileTime == size) && size>=0);
+      EIGEN_MALLOC_TRACE_TYPE(Derived);
       #ifdef EIGEN_INITIALIZE_COEFFS
         bool size_changed = size != this->size();
       #endif
@@ -517,7 +521,16 @@ class PlainObjectBase : public internal::dense_xpr_base<Derived>::type
     /** Copy constructor */
     EIGEN_DEVICE_FUNC
     EIGEN_STRONG_INLINE PlainObjectBase(const PlainObjectBase& other)
+#ifdef EIGEN_MALLOC_TRACING
+      : Base(), m_storage()
+    {
+      // the copy is traced with the type of the matrix
+      EIGEN_MALLOC_TRACE_TYPE(Derived);
+      m_storage = other.m_storage;
+    }
+#else
       : Base(), m_storage(other.m_storage) { }
+#endif
     EIGEN_DEVICE_FUNC
     EIGEN_STRONG_INLINE PlainObjectBase(Index size, Index rows, Index cols)
       : m_storage(size, rows, cols)
@@ -908,7 +921,7 @@ class PlainObjectBase : public internal::dense_xpr_base<Derived>::type
                         && ((MaxColsAtCompileTime == Dynamic) || (MaxColsAtCompileTime >= 0))
                         && (MaxRowsAtCompileTime == RowsAtCompileTime || RowsAtCompileTime==Dynamic)
                         && (MaxColsAtCompileTime == ColsAtCompileTime || ColsAtCompileTime==Dynamic)
-                        && (Options & (DontAlign|RowMajor)) == Options),
+                        && (Options & (DontAlign|RowMajor|InlineStorage)) == Options),
         INVALID_MATRIX_TEMPLATE_PARAMETERS)
     }
 
@@ -930,12 +943,14 @@ struct conservative_resize_like_impl
          (!Derived::IsRowMajor && _this.rows() == rows) )  // column-major and we change only the number of columns
     {
       internal::check_rows_cols_for_overflow<Derived::MaxSizeAtCompileTime>::run(rows, cols);
+      EIGEN_MALLOC_TRACE_TYPE(Derived);
       _this.derived().m_storage.conservativeResize(rows*cols,rows,cols);
     }
     else
     {
       // The storage order does not allow us to use reallocation.
-      typename Derived::PlainObject tmp(rows,cols);
+      // Note that PlainObject might not have the storage options of Derived, e.g. DontAlign or InlineStorage.
+      Derived tmp(rows,cols);
       const Index common_rows = numext::mini(rows, _this.rows());
       const Index common_cols = numext::mini(cols, _this.cols());
       tmp.block(0,0,common_rows,common_cols) = _this.block(0,0,common_rows,common_cols);
@@ -960,7 +975,10 @@ struct conservative_resize_like_impl
     {
       const Index new_rows = other.rows() - _this.rows();
       const Index new_cols = other.cols() - _this.cols();
-      _this.derived().m_storage.conservativeResize(other.size(),other.rows(),other.cols());
+      {
+        EIGEN_MALLOC_TRACE_TYPE(Derived);
+        _this.derived().m_storage.conservativeResize(other.size(),other.rows(),other.cols());
+      }
       if (new_rows>0)
         _this.bottomRightCorner(new_rows, other.cols()) = other.bottomRows(new_rows);
       else if (new_cols>0)
@@ -969,7 +987,7 @@ struct conservative_resize_like_impl
     else
     {
       // The storage order does not allow us to use reallocation.
-      typename Derived::PlainObject tmp(other);
+      Derived tmp(other);
       const Index common_rows = numext::mini(tmp.rows(), _this.rows());
       const Index common_cols = numext::mini(tmp.cols(), _this.cols());
       tmp.block(0,0,common_rows,common_cols) = _this.block(0,0,common_rows,common_cols);
@@ -990,6 +1008,7 @@ struct conservative_resize_like_impl<Derived,OtherDerived,true>
   {
     const Index new_rows = Derived::RowsAtCompileTime==1 ? 1 : size;
     const Index new_cols = Derived::RowsAtCompileTime==1 ? size : 1;
+    EIGEN_MALLOC_TRACE_TYPE(Derived);
     _this.derived().m_storage.conservativeResize(size,new_rows,new_cols);
   }
 
@@ -1001,7 +1020,10 @@ struct conservative_resize_like_impl<Derived,OtherDerived,true>
 
     const Index new_rows = Derived::RowsAtCompileTime==1 ? 1 : other.rows();
     const Index new_cols = Derived::RowsAtCompileTime==1 ? other.cols() : 1;
-    _this.derived().m_storage.conservativeResize(other.size(),new_rows,new_cols);
+    {
+      EIGEN_MALLOC_TRACE_TYPE(Derived);
+      _this.derived().m_storage.conservativeResize(other.size(),new_rows,new_cols);
+    }
 
     if (num_new_elements > 0)
       _this.tail(num_new_elements) = other.tail(num_new_elements);
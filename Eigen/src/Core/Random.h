@@ -25,6 +25,302 @@ struct functor_traits<scalar_random_op<Scalar> >
 
 } // end namespace internal
 
+/** \class PhiloxGenerator
+  * \ingroup Core_Module
+  *
+  * \brief Explicitly seeded counter-based random number generator
+  *
+  * This generator is used by the DenseBase::Random(PhiloxGenerator&) and DenseBase::RandomNormal(PhiloxGenerator&)
+  * variants of Random(), and by setRandom(PhiloxGenerator&) and setRandomNormal(PhiloxGenerator&).
+  * It implements the Philox4x32-10 generator of J. K. Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC'11.
+  *
+  * Unlike Random(), which calls std::rand() for each coefficient, each coefficient of a random expression
+  * drawn from a PhiloxGenerator is a function of the seed and stream of the generator, of the number of expressions
+  * previously drawn from it, and of the linear index of the coefficient only. Hence:
+  *  - the values do not depend on a global state, and are reproducible from the seed;
+  *  - they do not depend on the order in which the coefficients are evaluated, so that the expression can be vectorized,
+  *    and large random matrices can be filled on multiple threads (see \c EIGEN_PARALLELIZE_ASSIGNMENT);
+  *  - generators constructed from the same seed with different streams produce independent sequences,
+  *    which is the way to generate random numbers from multiple threads, e.g., by using the index of the thread as stream.
+  *
+  * Each draw updates the state of the generator, so a given generator must not be used concurrently by multiple threads.
+  *
+  * Example:
+  * \code
+  * PhiloxGenerator gen(42);
+  * MatrixXd a = MatrixXd::Random(1000, 1000, gen);       // uniform in [-1,1)
+  * VectorXf x = VectorXf::RandomNormal(1000, gen);       // standard normal
+  * a.setRandom(gen);                                     // new values
+  * \endcode
+  *
+  * \sa DenseBase::Random(Index,Index,PhiloxGenerator&), DenseBase::RandomNormal(Index,Index,PhiloxGenerator&)
+  */
+class PhiloxGenerator
+{
+  public:
+    /** Constructs a generator from the given \a seed and \a stream */
+    explicit PhiloxGenerator(unsigned int seed = 0, unsigned int stream = 0) { this->seed(seed, stream); }
+
+    /** Restarts the sequence of the given \a seed and \a stream */
+    void seed(unsigned int seed, unsigned int stream = 0)
+    {
+      EIGEN_STATIC_ASSERT(sizeof(unsigned int)==4, YOU_MADE_A_PROGRAMMING_MISTAKE);
+      m_key[0] = seed;
+      m_key[1] = stream;
+      m_draw = 0;
+    }
+
+    /** \internal Gets the key of the generator and the counter of the next drawn expression */
+    void nextDraw(unsigned int key[2], unsigned int draw[2])
+    {
+      key[0] = m_key[0];
+      key[1] = m_key[1];
+      draw[0] = static_cast<unsigned int>(m_draw);
+      draw[1] = static_cast<unsigned int>(m_draw >> 32);
+      ++m_draw;
+    }
+
+  protected:
+    unsigned int m_key[2];
+    unsigned long long m_draw;
+};
+
+namespace internal {
+
+/* One round of Philox4x32 on n blocks */
+template<int MaxBlocks>
+EIGEN_STRONG_INLINE void philox4x32_round(unsigned int k0, unsigned int k1, unsigned int x[4][MaxBlocks], int n)
+{
+  typedef unsigned long long uint64;
+  for(int b = 0; b < n; ++b)
+  {
+    const uint64 p0 = uint64(0xD2511F53u) * x[0][b];
+    const uint64 p1 = uint64(0xCD9E8D57u) * x[2][b];
+    const unsigned int y0 = static_cast<unsigned int>(p1 >> 32) ^ x[1][b] ^ k0;
+    const unsigned int y2 = static_cast<unsigned int>(p0 >> 32) ^ x[3][b] ^ k1;
+    x[1][b] = static_cast<unsigned int>(p1);
+    x[3][b] = static_cast<unsigned int>(p0);
+    x[0][b] = y0;
+    x[2][b] = y2;
+  }
+}
+
+/* Philox4x32-10: transforms the 128-bit counters x[0..3][b] of n blocks into 4 random 32-bit words each.
+ * The blocks are processed together so that the 32x32->64 bits products of each round can be vectorized,
+ * or at least pipelined. */
+template<int MaxBlocks>
+EIGEN_STRONG_INLINE void philox4x32_10(const unsigned int key[2], unsigned int x[4][MaxBlocks], int n)
+{
+  const unsigned int w0 = 0x9E3779B9u, w1 = 0xBB67AE85u;
+  const unsigned int k0 = key[0], k1 = key[1];
+  philox4x32_round<MaxBlocks>(k0,        k1,        x, n);
+  philox4x32_round<MaxBlocks>(k0 +   w0, k1 +   w1, x, n);
+  philox4x32_round<MaxBlocks>(k0 + 2*w0, k1 + 2*w1, x, n);
+  philox4x32_round<MaxBlocks>(k0 + 3*w0, k1 + 3*w1, x, n);
+  philox4x32_round<MaxBlocks>(k0 + 4*w0, k1 + 4*w1, x, n);
+  philox4x32_round<MaxBlocks>(k0 + 5*w0, k1 + 5*w1, x, n);
+  philox4x32_round<MaxBlocks>(k0 + 6*w0, k1 + 6*w1, x, n);
+  philox4x32_round<MaxBlocks>(k0 + 7*w0, k1 + 7*w1, x, n);
+  philox4x32_round<MaxBlocks>(k0 + 8*w0, k1 + 8*w1, x, n);
+  philox4x32_round<MaxBlocks>(k0 + 9*w0, k1 + 9*w1, x, n);
+}
+
+/* Uniform real in [0,1) made of the 53 high bits of two words */
+template<typename RealScalar> struct philox_uniform01
+{
+  enum { Words = 2 };
+  static RealScalar run(const unsigned int* w)
+  {
+    return RealScalar((double(w[0] >> 5) * 67108864. + double(w[1] >> 6)) * (1. / 9007199254740992.));
+  }
+};
+
+template<> struct philox_uniform01<float>
+{
+  enum { Words = 1 };
+  static float run(const unsigned int* w) { return float(w[0] >> 8) * (1.f / 16777216.f); }
+};
+
+/* Conversion of Words random words to a uniform Scalar */
+template<typename Scalar, bool IsComplex = NumTraits<Scalar>::IsComplex, bool IsInteger = NumTraits<Scalar>::IsInteger>
+struct philox_scalar
+{
+  typedef philox_uniform01<Scalar> Uniform01;
+  enum { Words = Uniform01::Words };
+
+  // in [-1,1)
+  static Scalar uniform(const unsigned int* w) { return Scalar(2) * Uniform01::run(w) - Scalar(1); }
+};
+
+template<typename Scalar>
+struct philox_scalar<Scalar, true, false>
+{
+  typedef philox_scalar<typename NumTraits<Scalar>::Real> RealImpl;
+  enum { Words = 2*RealImpl::Words };
+
+  static Scalar uniform(const unsigned int* w) { return Scalar(RealImpl::uniform(w), RealImpl::uniform(w + RealImpl::Words)); }
+};
+
+// the whole definition range of the integer type
+template<typename Scalar>
+struct philox_scalar<Scalar, false, true>
+{
+  enum { Words = sizeof(Scalar)>4 ? 2 : 1 };
+
+  static Scalar uniform(const unsigned int* w)
+  {
+    unsigned long long bits = w[0];
+    if(Words==2)
+      bits |= static_cast<unsigned long long>(w[Words-1]) << 32;
+    return static_cast<Scalar>(bits);
+  }
+};
+
+template<>
+struct philox_scalar<bool, false, true>
+{
+  enum { Words = 1 };
+  static bool uniform(const unsigned int* w) { return (w[0] & 1u) != 0; }
+};
+
+/* Computes the words [firstWord, firstWord+count) of the sequence of the given key and draw, with count <= MaxWords */
+template<int MaxWords>
+EIGEN_STRONG_INLINE void philox_words(const unsigned int key[2], const unsigned int draw[2], Index firstWord, int count, unsigned int* words)
+{
+  enum { MaxBlocks = (MaxWords + 6) / 4 };
+  const Index firstBlock = firstWord / 4;
+  const int offset = int(firstWord - 4*firstBlock);
+  const int blocks = (offset + count + 3) / 4;
+  unsigned int x[4][MaxBlocks];
+  for(int b = 0; b < blocks; ++b)
+  {
+    const Index block = firstBlock + b;
+    x[0][b] = static_cast<unsigned int>(block);
+    x[1][b] = static_cast<unsigned int>((block >> 16) >> 16);
+    x[2][b] = draw[0];
+    x[3][b] = draw[1];
+  }
+  philox4x32_10<MaxBlocks>(key, x, blocks);
+  for(int k = 0; k < count; ++k)
+    words[k] = x[(offset + k) % 4][(offset + k) / 4];
+}
+
+/* Base of the nullary functors drawing a random expression from a PhiloxGenerator.
+ * The coefficient of linear index k, in the storage order of the expression, is a function of the key and draw
+ * counter only. */
+template<typename Scalar, typename Derived>
+struct philox_random_op
+{
+  philox_random_op(PhiloxGenerator& generator, Index rows, Index cols, bool rowMajor)
+    : m_rows(rows), m_cols(cols), m_rowMajor(rowMajor)
+  {
+    generator.nextDraw(m_key, m_draw);
+  }
+
+  EIGEN_STRONG_INLINE const Scalar operator() (Index i, Index j) const
+  {
+    Scalar value;
+    static_cast<const Derived*>(this)->template generate<1>(linearIndex(i, j), &value);
+    return value;
+  }
+
+  template <typename Packet>
+  EIGEN_STRONG_INLINE const Packet packetOp(Index i, Index j) const
+  {
+    enum { Size = unpacket_traits<Packet>::size };
+    EIGEN_ALIGN_MAX Scalar values[Size];
+    static_cast<const Derived*>(this)->template generate<Size>(linearIndex(i, j), values);
+    return pload<Packet>(values);
+  }
+
+  Index linearIndex(Index i, Index j) const { return m_rowMajor ? i*m_cols + j : i + j*m_rows; }
+
+  unsigned int m_key[2];
+  unsigned int m_draw[2];
+  Index m_rows, m_cols;
+  bool m_rowMajor;
+};
+
+/* The uniform coefficient of linear index k is made of the words [k*Words, (k+1)*Words) */
+template<typename Scalar> struct scalar_uniform_random_op : philox_random_op<Scalar, scalar_uniform_random_op<Scalar> >
+{
+  typedef philox_random_op<Scalar, scalar_uniform_random_op<Scalar> > Base;
+  enum { Words = philox_scalar<Scalar>::Words };
+
+  scalar_uniform_random_op(PhiloxGenerator& generator, Index rows, Index cols, bool rowMajor)
+    : Base(generator, rows, cols, rowMajor)
+  {}
+
+  // computes the N coefficients starting at the linear index start
+  template<int N>
+  EIGEN_STRONG_INLINE void generate(Index start, Scalar* values) const
+  {
+    unsigned int words[N*Words];
+    philox_words<N*Words>(this->m_key, this->m_draw, start*Words, N*Words, words);
+    for(int k = 0; k < N; ++k)
+      values[k] = philox_scalar<Scalar>::uniform(words + k*Words);
+  }
+};
+
+template<typename Scalar>
+struct functor_traits<scalar_uniform_random_op<Scalar> >
+{ enum { Cost = 10 * NumTraits<Scalar>::MulCost, PacketAccess = packet_traits<Scalar>::Vectorizable, IsRepeatable = true }; };
+
+/* The normal real numbers are generated by pairs by the Box-Muller transform, each pair consuming two uniform numbers.
+ * A complex coefficient is made of one pair, and a real coefficient of linear index k is one of the two numbers of the pair k/2. */
+template<typename Scalar> struct scalar_normal_random_op : philox_random_op<Scalar, scalar_normal_random_op<Scalar> >
+{
+  typedef philox_random_op<Scalar, scalar_normal_random_op<Scalar> > Base;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef philox_uniform01<RealScalar> Uniform01;
+  enum {
+    RealsPerValue = NumTraits<Scalar>::IsComplex ? 2 : 1,
+    Words = Uniform01::Words
+  };
+
+  scalar_normal_random_op(PhiloxGenerator& generator, Index rows, Index cols, bool rowMajor)
+    : Base(generator, rows, cols, rowMajor)
+  {
+    EIGEN_STATIC_ASSERT(!NumTraits<Scalar>::IsInteger, THIS_FUNCTION_IS_NOT_FOR_INTEGER_NUMERIC_TYPES);
+  }
+
+  template<int N>
+  EIGEN_STRONG_INLINE void generate(Index start, Scalar* values) const
+  {
+    using std::sqrt;
+    using std::log;
+    using std::cos;
+    using std::sin;
+    enum { MaxReals = N*RealsPerValue + 2 };
+    // the reals of the coefficients, extended to whole pairs
+    const Index firstReal = start * RealsPerValue;
+    const Index firstPair = firstReal / 2;
+    const int offset = int(firstReal - 2*firstPair);
+    const int pairs = (offset + N*RealsPerValue + 1) / 2;
+    unsigned int words[MaxReals*Words];
+    philox_words<MaxReals*Words>(this->m_key, this->m_draw, firstPair*2*Words, pairs*2*Words, words);
+    RealScalar reals[MaxReals];
+    for(int p = 0; p < pairs; ++p)
+    {
+      const RealScalar u1 = RealScalar(1) - Uniform01::run(words + 2*p*Words); // in (0,1]
+      const RealScalar u2 = Uniform01::run(words + (2*p+1)*Words);
+      const RealScalar r = sqrt(RealScalar(-2) * log(u1));
+      const RealScalar theta = RealScalar(2 * EIGEN_PI) * u2;
+      reals[2*p] = r * cos(theta);
+      reals[2*p+1] = r * sin(theta);
+    }
+    RealScalar* out = reinterpret_cast<RealScalar*>(values);
+    for(int k = 0; k < N*RealsPerValue; ++k)
+      out[k] = reals[offset + k];
+  }
+};
+
+template<typename Scalar>
+struct functor_traits<scalar_normal_random_op<Scalar> >
+{ enum { Cost = 30 * NumTraits<Scalar>::MulCost, PacketAccess = packet_traits<Scalar>::Vectorizable, IsRepeatable = true }; };
+
+} // end namespace internal
+
 /** \returns a random matrix expression
   *
   * Numbers are uniformly spread through their whole definition range for integer types,
@@ -177,6 +473,109 @@ PlainObjectBase<Derived>::setRandom(Index rows, Index cols)
   return setRandom();
 }
 
+/** \returns a random matrix expression whose coefficients are drawn from the given \a generator
+  *
+  * Numbers are uniformly spread through their whole definition range for integer types,
+  * and in the [-1:1) range for floating point scalar types.
+  *
+  * Contrary to Random(Index,Index), this expression is reentrant, is vectorized, and can be evaluated on multiple threads.
+  * Its coefficients only depend on the state of the generator at the time it is called, and on their index.
+  * The generator is updated so that the next expression drawn from it is independent.
+  *
+  * \sa class PhiloxGenerator, DenseBase::setRandom(PhiloxGenerator&), DenseBase::RandomNormal(Index,Index,PhiloxGenerator&)
+  */
+template<typename Derived>
+inline const typename DenseBase<Derived>::UniformRandomReturnType
+DenseBase<Derived>::Random(Index rows, Index cols, PhiloxGenerator& generator)
+{
+  return NullaryExpr(rows, cols, internal::scalar_uniform_random_op<Scalar>(generator, rows, cols, PlainObject::IsRowMajor));
+}
+
+/** \returns a random vector expression whose coefficients are drawn from the given \a generator
+  *
+  * \only_for_vectors
+  *
+  * \sa class PhiloxGenerator, DenseBase::Random(Index,Index,PhiloxGenerator&)
+  */
+template<typename Derived>
+inline const typename DenseBase<Derived>::UniformRandomReturnType
+DenseBase<Derived>::Random(Index size, PhiloxGenerator& generator)
+{
+  EIGEN_STATIC_ASSERT_VECTOR_ONLY(Derived)
+  return Random(RowsAtCompileTime==1 ? 1 : size, RowsAtCompileTime==1 ? size : 1, generator);
+}
+
+/** \returns a fixed-size random matrix or vector expression whose coefficients are drawn from the given \a generator
+  *
+  * \sa class PhiloxGenerator, DenseBase::Random(Index,Index,PhiloxGenerator&)
+  */
+template<typename Derived>
+inline const typename DenseBase<Derived>::UniformRandomReturnType
+DenseBase<Derived>::Random(PhiloxGenerator& generator)
+{
+  return Random(RowsAtCompileTime, ColsAtCompileTime, generator);
+}
+
+/** \returns a matrix expression of standard normal random numbers drawn from the given \a generator
+  *
+  * The numbers follow the normal distribution of mean 0 and variance 1, and are obtained by the Box-Muller transform.
+  * For complex scalar types, the real and imaginary parts are independent standard normal numbers.
+  * Integer scalar types are not supported.
+  *
+  * \sa class PhiloxGenerator, DenseBase::setRandomNormal(PhiloxGenerator&), DenseBase::Random(Index,Index,PhiloxGenerator&)
+  */
+template<typename Derived>
+inline const typename DenseBase<Derived>::NormalRandomReturnType
+DenseBase<Derived>::RandomNormal(Index rows, Index cols, PhiloxGenerator& generator)
+{
+  return NullaryExpr(rows, cols, internal::scalar_normal_random_op<Scalar>(generator, rows, cols, PlainObject::IsRowMajor));
+}
+
+/** \returns a vector expression of standard normal random numbers drawn from the given \a generator
+  *
+  * \only_for_vectors
+  *
+  * \sa class PhiloxGenerator, DenseBase::RandomNormal(Index,Index,PhiloxGenerator&)
+  */
+template<typename Derived>
+inline const typename DenseBase<Derived>::NormalRandomReturnType
+DenseBase<Derived>::RandomNormal(Index size, PhiloxGenerator& generator)
+{
+  EIGEN_STATIC_ASSERT_VECTOR_ONLY(Derived)
+  return RandomNormal(RowsAtCompileTime==1 ? 1 : size, RowsAtCompileTime==1 ? size : 1, generator);
+}
+
+/** \returns a fixed-size matrix or vector expression of standard normal random numbers drawn from the given \a generator
+  *
+  * \sa class PhiloxGenerator, DenseBase::RandomNormal(Index,Index,PhiloxGenerator&)
+  */
+template<typename Derived>
+inline const typename DenseBase<Derived>::NormalRandomReturnType
+DenseBase<Derived>::RandomNormal(PhiloxGenerator& generator)
+{
+  return RandomNormal(RowsAtCompileTime, ColsAtCompileTime, generator);
+}
+
+/** Sets all coefficients in this expression to uniform random values drawn from the given \a generator.
+  *
+  * \sa class PhiloxGenerator, DenseBase::Random(Index,Index,PhiloxGenerator&)
+  */
+template<typename Derived>
+inline Derived& DenseBase<Derived>::setRandom(PhiloxGenerator& generator)
+{
+  return *this = Random(rows(), cols(), generator);
+}
+
+/** Sets all coefficients in this expression to standard normal random values drawn from the given \a generator.
+  *
+  * \sa class PhiloxGenerator, DenseBase::RandomNormal(Index,Index,PhiloxGenerator&)
+  */
+template<typename Derived>
+inline Derived& DenseBase<Derived>::setRandomNormal(PhiloxGenerator& generator)
+{
+  return *this = RandomNormal(rows(), cols(), generator);
+}
+
 } // end namespace Eigen
 
 #endif // EIGEN_RANDOM_H
@@ -329,6 +329,137 @@ struct redux_impl<Func, Derived, LinearVectorizedTraversal, CompleteUnrolling>
   }
 };
 
+#ifdef EIGEN_PARALLELIZE_REDUCTION
+
+// redux_range_impl<Func,Derived>::run(mat,func,start,end) reduces the part [start,end) of a dynamic-size expression,
+// where start and end are linear indices for the linear traversal, and outer indices otherwise.
+// The packets are loaded on the same aligned boundaries as for the complete reduction, and each range has its own
+// packet accumulators. The ranges are reduced independently and their results combined by redux_parallelizer.
+template<typename Func, typename Derived, int Traversal = redux_traits<Func, Derived>::Traversal>
+struct redux_range_impl
+{
+  typedef typename Derived::Scalar Scalar;
+
+  static Scalar run(const Derived &mat, const Func& func, Index start, Index end)
+  {
+    const Index innerSize = mat.innerSize();
+    Scalar res;
+    res = mat.coeffByOuterInner(start, 0);
+    for(Index i = 1; i < innerSize; ++i)
+      res = func(res, mat.coeffByOuterInner(start, i));
+    for(Index j = start+1; j < end; ++j)
+      for(Index i = 0; i < innerSize; ++i)
+        res = func(res, mat.coeffByOuterInner(j, i));
+    return res;
+  }
+};
+
+template<typename Func, typename Derived>
+struct redux_range_impl<Func, Derived, SliceVectorizedTraversal>
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename redux_traits<Func, Derived>::PacketType PacketType;
+
+  static Scalar run(const Derived &mat, const Func& func, Index start, Index end)
+  {
+    const Index innerSize = mat.innerSize();
+    enum {
+      packetSize = redux_traits<Func, Derived>::PacketSize
+    };
+    const Index packetedInnerSize = ((innerSize)/packetSize)*packetSize;
+    if(packetedInnerSize==0)
+      return redux_range_impl<Func, Derived, DefaultTraversal>::run(mat, func, start, end);
+
+    PacketType packet_res = mat.template packetByOuterInner<Unaligned,PacketType>(start,0);
+    for(Index j=start; j<end; ++j)
+      for(Index i=(j==start?packetSize:0); i<packetedInnerSize; i+=Index(packetSize))
+        packet_res = func.packetOp(packet_res, mat.template packetByOuterInner<Unaligned,PacketType>(j,i));
+
+    Scalar res = func.predux(packet_res);
+    for(Index j=start; j<end; ++j)
+      for(Index i=packetedInnerSize; i<innerSize; ++i)
+        res = func(res, mat.coeffByOuterInner(j,i));
+    return res;
+  }
+};
+
+template<typename Func, typename Derived>
+struct redux_range_impl<Func, Derived, LinearVectorizedTraversal>
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename redux_traits<Func, Derived>::PacketType PacketScalar;
+
+  static Scalar run(const Derived &mat, const Func& func, Index start, Index end)
+  {
+    const Index size = mat.size();
+    const Index packetSize = redux_traits<Func, Derived>::PacketSize;
+    const int packetAlignment = unpacket_traits<PacketScalar>::alignment;
+    enum {
+      alignment0 = (bool(Derived::Flags & DirectAccessBit) && bool(packet_traits<Scalar>::AlignedOnScalar)) ? int(packetAlignment) : int(Unaligned),
+      alignment = EIGEN_PLAIN_ENUM_MAX(alignment0, Derived::Alignment)
+    };
+    const Index alignedStart = internal::first_default_aligned(mat.nestedExpression());
+    const Index alignedEnd = alignedStart + ((size-alignedStart)/packetSize)*packetSize;
+
+    // packets of the complete reduction lying in [start,end)
+    Index first = start<=alignedStart ? alignedStart
+                                      : alignedStart + ((start-alignedStart+packetSize-1)/packetSize)*packetSize;
+    first = numext::mini(first, end);
+    const Index stop = numext::mini(end, alignedEnd);
+    const Index last = stop>first ? first + ((stop-first)/packetSize)*packetSize : first;
+    const Index last2 = first + ((last-first)/(2*packetSize))*(2*packetSize);
+
+    Scalar res;
+    if(last>first)
+    {
+      PacketScalar packet_res0 = mat.template packet<alignment,PacketScalar>(first);
+      if(last-first>packetSize)
+      {
+        PacketScalar packet_res1 = mat.template packet<alignment,PacketScalar>(first+packetSize);
+        for(Index index = first + 2*packetSize; index < last2; index += 2*packetSize)
+        {
+          packet_res0 = func.packetOp(packet_res0, mat.template packet<alignment,PacketScalar>(index));
+          packet_res1 = func.packetOp(packet_res1, mat.template packet<alignment,PacketScalar>(index+packetSize));
+        }
+        packet_res0 = func.packetOp(packet_res0,packet_res1);
+        if(last>last2)
+          packet_res0 = func.packetOp(packet_res0, mat.template packet<alignment,PacketScalar>(last2));
+      }
+      res = func.predux(packet_res0);
+
+      for(Index index = start; index < first; ++index)
+        res = func(res,mat.coeff(index));
+
+      for(Index index = last; index < end; ++index)
+        res = func(res,mat.coeff(index));
+    }
+    else
+    {
+      res = mat.coeff(start);
+      for(Index index = start+1; index < end; ++index)
+        res = func(res,mat.coeff(index));
+    }
+    return res;
+  }
+};
+
+// Entry point of the parallel reductions, defined in Parallelizer.h.
+// Only the dynamic-size expressions are split.
+template<typename Func, typename Derived, bool MayParallelize = int(Derived::SizeAtCompileTime)==Dynamic>
+struct redux_parallelizer;
+
+template<typename Func, typename Derived>
+struct redux_parallelizer<Func, Derived, false>
+{
+  typedef typename Derived::Scalar Scalar;
+  EIGEN_STRONG_INLINE static Scalar run(const Derived &mat, const Func& func)
+  {
+    return redux_impl<Func, Derived>::run(mat, func);
+  }
+};
+
+#endif // EIGEN_PARALLELIZE_REDUCTION
+
 // evaluator adaptor
 template<typename _XprType>
 class redux_evaluator
@@ -414,8 +545,12 @@ DenseBase<Derived>::redux(const Func& func) const
 
   typedef typename internal::redux_evaluator<Derived> ThisEvaluator;
   ThisEvaluator thisEval(derived());
-  
+
+#if defined(EIGEN_PARALLELIZE_REDUCTION) && !defined(EIGEN_CUDA_ARCH)
+  return internal::redux_parallelizer<Func, ThisEvaluator>::run(thisEval, func);
+#else
   return internal::redux_impl<Func, ThisEvaluator>::run(thisEval, func);
+#endif
 }
 
 /** \returns the minimum of all coefficients of \c *this.
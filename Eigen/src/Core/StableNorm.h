@@ -50,6 +50,204 @@ inline void stable_norm_kernel(const ExpressionType& bl, Scalar& ssq, Scalar& sc
     ssq += (bl*invScale).squaredNorm();
 }
 
+// Scale and sum of squares of the coefficients of stableNorm, the norm being scale * sqrt(ssq).
+template<typename RealScalar>
+struct stable_norm_sums
+{
+  stable_norm_sums() : scale(0), invScale(1), ssq(0) {}
+  RealScalar scale;
+  RealScalar invScale;
+  RealScalar ssq;
+};
+
+// Combines the sums of two parts of a vector, the sum of squares being expressed relatively to the largest scale.
+template<typename RealScalar>
+struct stable_norm_sums_combine
+{
+  stable_norm_sums<RealScalar> operator()(const stable_norm_sums<RealScalar>& a, const stable_norm_sums<RealScalar>& b) const
+  {
+    if(a.scale!=a.scale) return a; // NaN
+    if(b.scale!=b.scale) return b;
+    stable_norm_sums<RealScalar> res = a.scale<b.scale ? b : a;
+    const stable_norm_sums<RealScalar>& other = a.scale<b.scale ? a : b;
+    if(other.scale==res.scale)
+      res.ssq += other.ssq;
+    else if(other.scale>RealScalar(0))
+      res.ssq += other.ssq * numext::abs2(other.scale/res.scale);
+    return res;
+  }
+};
+
+// Runs stable_norm_kernel on the blocks of blockSize coefficients of vec starting in [start,end),
+// the coefficient start being aligned.
+template<typename VectorType, typename SegmentWrapper>
+struct stable_norm_blocks
+{
+  template<typename RealScalar>
+  static void run(const VectorType& vec, Index start, Index end, Index blockSize, stable_norm_sums<RealScalar>& sums)
+  {
+    for(Index bi = start; bi<end; bi+=blockSize)
+      stable_norm_kernel(SegmentWrapper(vec.segment(bi,numext::mini(blockSize, vec.size() - bi))), sums.ssq, sums.scale, sums.invScale);
+  }
+};
+
+// Sums of the squares of the small, medium and large coefficients of Blue's algorithm.
+template<typename RealScalar>
+struct blue_norm_sums
+{
+  blue_norm_sums() : asml(0), amed(0), abig(0) {}
+  RealScalar asml;
+  RealScalar amed;
+  RealScalar abig;
+};
+
+template<typename RealScalar>
+struct blue_norm_sums_combine
+{
+  blue_norm_sums<RealScalar> operator()(const blue_norm_sums<RealScalar>& a, const blue_norm_sums<RealScalar>& b) const
+  {
+    blue_norm_sums<RealScalar> res;
+    res.asml = a.asml + b.asml;
+    res.amed = a.amed + b.amed;
+    res.abig = a.abig + b.abig;
+    return res;
+  }
+};
+
+// Thresholds and scaling factors of Blue's algorithm:
+// the coefficients below b1 are small, the ones above ab2 are large, and they are scaled by s1m and s2m respectively.
+template<typename RealScalar>
+struct blue_norm_params
+{
+  RealScalar b1, ab2, s1m, s2m;
+};
+
+template<typename Derived,
+         bool Vectorize = is_same<typename traits<Derived>::StorageKind,Dense>::value
+                       && Derived::IsVectorAtCompileTime
+                       && !NumTraits<typename Derived::Scalar>::IsComplex
+                       && (evaluator<Derived>::Flags & ActualPacketAccessBit)
+                       && (evaluator<Derived>::Flags & LinearAccessBit)
+                       && packet_traits<typename Derived::Scalar>::HasAbs
+                       && packet_traits<typename Derived::Scalar>::HasMax>
+struct blue_norm_accumulator
+{
+  typedef typename Derived::RealScalar RealScalar;
+  enum { Vectorized = 0 };
+
+  static void run(const Derived& vec, const blue_norm_params<RealScalar>& p, blue_norm_sums<RealScalar>& sums)
+  {
+    using std::abs;
+    for(typename Derived::InnerIterator it(vec, 0); it; ++it)
+    {
+      RealScalar ax = abs(it.value());
+      if(ax > p.ab2)     sums.abig += numext::abs2(ax*p.s2m);
+      else if(ax < p.b1) sums.asml += numext::abs2(ax*p.s1m);
+      else               sums.amed += numext::abs2(ax);
+    }
+  }
+};
+
+// Vectorized accumulation of the sums of Blue's algorithm.
+// The coefficients are classified by blocks of a few packets from the largest absolute value of the block:
+//  - if it is below b1, all the coefficients of the block are small;
+//  - if it is between b1 and ab2, all the coefficients are accumulated as medium ones. The squares of the small ones
+//    might then lose some bits of precision, but they are negligible compared to the square of the largest one;
+//  - otherwise, or if it is not a number, the coefficients of the block are classified one by one.
+template<typename Derived>
+struct blue_norm_accumulator<Derived, true>
+{
+  typedef typename Derived::RealScalar RealScalar;
+  typedef typename packet_traits<RealScalar>::type Packet;
+  enum {
+    Vectorized = 1,
+    PacketSize = unpacket_traits<Packet>::size,
+    BlockSize = 4*PacketSize
+  };
+
+  static void run(const Derived& vec, const blue_norm_params<RealScalar>& p, blue_norm_sums<RealScalar>& sums)
+  {
+    evaluator<Derived> eval(vec);
+    run(eval, 0, vec.size(), p, sums);
+  }
+
+  // accumulates the coefficients [start,end)
+  static void run(const evaluator<Derived>& eval, Index start, Index end,
+                  const blue_norm_params<RealScalar>& p, blue_norm_sums<RealScalar>& sums)
+  {
+    using std::abs;
+    const Packet s1m = pset1<Packet>(p.s1m);
+    Packet asml = pset1<Packet>(RealScalar(0));
+    Packet amed = pset1<Packet>(RealScalar(0));
+    Index i = start;
+    for(; i+BlockSize<=end; i+=BlockSize)
+    {
+      Packet a = pabs(eval.template packet<Unaligned,Packet>(i));
+      Packet amax = a;
+      Packet ssq = pmul(a, a);
+      for(Index k = PacketSize; k < BlockSize; k += PacketSize)
+      {
+        a = pabs(eval.template packet<Unaligned,Packet>(i+k));
+        amax = pmax(amax, a);
+        ssq = pmadd(a, a, ssq);
+      }
+      const RealScalar blockMax = predux_max(amax);
+      if(blockMax <= p.ab2 && blockMax >= p.b1)
+        amed = padd(amed, ssq);
+      else if(blockMax < p.b1)
+      {
+        for(Index k = 0; k < BlockSize; k += PacketSize)
+        {
+          a = pmul(pabs(eval.template packet<Unaligned,Packet>(i+k)), s1m);
+          asml = pmadd(a, a, asml);
+        }
+      }
+      else
+        accumulate(eval, i, i+BlockSize, p, sums);
+    }
+    accumulate(eval, i, end, p, sums);
+    sums.asml += predux(asml);
+    sums.amed += predux(amed);
+  }
+
+  static void accumulate(const evaluator<Derived>& eval, Index start, Index end,
+                         const blue_norm_params<RealScalar>& p, blue_norm_sums<RealScalar>& sums)
+  {
+    using std::abs;
+    for(Index i = start; i < end; ++i)
+    {
+      RealScalar ax = abs(eval.coeff(i));
+      if(ax > p.ab2)     sums.abig += numext::abs2(ax*p.s2m);
+      else if(ax < p.b1) sums.asml += numext::abs2(ax*p.s1m);
+      else               sums.amed += numext::abs2(ax);
+    }
+  }
+};
+
+#ifdef EIGEN_PARALLELIZE_REDUCTION
+// Entry points of the parallel versions of blueNorm() and stableNorm(), defined in Parallelizer.h.
+// Only the dynamic-size vectors are split.
+template<typename Derived, bool MayParallelize = blue_norm_accumulator<Derived>::Vectorized && int(Derived::SizeAtCompileTime)==Dynamic>
+struct blue_norm_parallelizer
+{
+  typedef typename Derived::RealScalar RealScalar;
+  static void run(const Derived& vec, const blue_norm_params<RealScalar>& p, blue_norm_sums<RealScalar>& sums)
+  {
+    blue_norm_accumulator<Derived>::run(vec, p, sums);
+  }
+};
+
+template<typename Derived, typename SegmentWrapper, bool MayParallelize = int(Derived::SizeAtCompileTime)==Dynamic>
+struct stable_norm_parallelizer
+{
+  template<typename RealScalar>
+  static void run(const Derived& vec, Index start, Index blockSize, stable_norm_sums<RealScalar>& sums)
+  {
+    stable_norm_blocks<Derived,SegmentWrapper>::run(vec, start, vec.size(), blockSize, sums);
+  }
+};
+#endif
+
 template<typename Derived>
 inline typename NumTraits<typename traits<Derived>::Scalar>::Real
 blueNorm_impl(const EigenBase<Derived>& _vec)
@@ -94,19 +292,24 @@ blueNorm_impl(const EigenBase<Derived>& _vec)
     initialized = true;
   }
   Index n = vec.size();
-  RealScalar ab2 = b2 / RealScalar(n);
-  RealScalar asml = RealScalar(0);
-  RealScalar amed = RealScalar(0);
-  RealScalar abig = RealScalar(0);
-  for(typename Derived::InnerIterator it(vec, 0); it; ++it)
-  {
-    RealScalar ax = abs(it.value());
-    if(ax > ab2)     abig += numext::abs2(ax*s2m);
-    else if(ax < b1) asml += numext::abs2(ax*s1m);
-    else             amed += numext::abs2(ax);
-  }
+  blue_norm_params<RealScalar> params;
+  params.b1 = b1;
+  params.ab2 = b2 / RealScalar(n);
+  params.s1m = s1m;
+  params.s2m = s2m;
+  blue_norm_sums<RealScalar> sums;
+#ifdef EIGEN_PARALLELIZE_REDUCTION
+  blue_norm_parallelizer<Derived>::run(vec, params, sums);
+#else
+  blue_norm_accumulator<Derived>::run(vec, params, sums);
+#endif
+  RealScalar asml = sums.asml;
+  RealScalar amed = sums.amed;
+  RealScalar abig = sums.abig;
   if(amed!=amed)
     return amed;  // we got a NaN
+  if(asml!=asml)
+    return asml;  // we got a NaN in a block of small coefficients
   if(abig > RealScalar(0))
   {
     abig = sqrt(abig);
@@ -159,9 +362,7 @@ MatrixBase<Derived>::stableNorm() const
   using std::sqrt;
   using std::abs;
   const Index blockSize = 4096;
-  RealScalar scale(0);
-  RealScalar invScale(1);
-  RealScalar ssq(0); // sum of square
+  internal::stable_norm_sums<RealScalar> sums;
   
   typedef typename internal::nested_eval<Derived,2>::type DerivedCopy;
   typedef typename internal::remove_all<DerivedCopy>::type DerivedCopyClean;
@@ -182,10 +383,13 @@ MatrixBase<Derived>::stableNorm() const
   
   Index bi = internal::first_default_aligned(copy);
   if (bi>0)
-    internal::stable_norm_kernel(copy.head(bi), ssq, scale, invScale);
-  for (; bi<n; bi+=blockSize)
-    internal::stable_norm_kernel(SegmentWrapper(copy.segment(bi,numext::mini(blockSize, n - bi))), ssq, scale, invScale);
-  return scale * sqrt(ssq);
+    internal::stable_norm_kernel(copy.head(bi), sums.ssq, sums.scale, sums.invScale);
+#ifdef EIGEN_PARALLELIZE_REDUCTION
+  internal::stable_norm_parallelizer<DerivedCopyClean,SegmentWrapper>::run(copy, bi, blockSize, sums);
+#else
+  internal::stable_norm_blocks<DerivedCopyClean,SegmentWrapper>::run(copy, bi, n, blockSize, sums);
+#endif
+  return sums.scale * sqrt(sums.ssq);
 }
 
 /** \returns the \em l2 norm of \c *this using the Blue's algorithm.
@@ -14,7 +14,7 @@ namespace Eigen {
 
 namespace internal {
 
-template<typename Visitor, typename Derived, int UnrollCount>
+template<typename Visitor, typename Derived, int UnrollCount, bool Vectorize = false>
 struct visitor_impl
 {
   enum {
@@ -55,6 +55,74 @@ struct visitor_impl<Visitor, Derived, Dynamic>
   }
 };
 
+// Vectorized visit, in the same order as the scalar one (column by column) for the visitors providing:
+//  - packetOp(a,b), which reduces two packets of coefficients into one, e.g., pmin for min_coeff_visitor,
+//  - packetMayUpdate(p), which tells whether the coefficients reduced into p might update the visitor.
+// The coefficients are read by blocks of a few packets, and only the blocks which might update the visitor
+// are visited coefficient by coefficient. The blocks containing non-finite values are always visited coefficient
+// by coefficient, so that the NaNs are handled exactly as in the scalar path.
+template<typename Visitor, typename Derived>
+struct visitor_impl<Visitor, Derived, Dynamic, true>
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename packet_traits<Scalar>::type Packet;
+  enum {
+    PacketSize = unpacket_traits<Packet>::size,
+    BlockSize = 8*PacketSize,
+    IsRowMajor = Derived::IsRowMajor
+  };
+
+  static inline void visitCoeff(const Derived& mat, Visitor& visitor, Index outer, Index inner)
+  {
+    const Index row = IsRowMajor ? outer : inner;
+    const Index col = IsRowMajor ? inner : outer;
+    visitor(mat.coeff(row, col), row, col);
+  }
+
+  static inline void run(const Derived& mat, Visitor& visitor)
+  {
+    const Index innerSize = IsRowMajor ? mat.cols() : mat.rows();
+    const Index outerSize = IsRowMajor ? mat.rows() : mat.cols();
+    visitor.init(mat.coeff(0,0), 0, 0);
+    for(Index j = 0; j < outerSize; ++j)
+    {
+      Index i = (j==0) ? 1 : 0;
+      for(; i+BlockSize <= innerSize; i += BlockSize)
+      {
+        Packet p = mat.template packetByOuterInner<Packet>(j, i);
+        Packet reduced = p;
+        Packet nonFinite = psub(p, p);
+        for(Index k = PacketSize; k < BlockSize; k += PacketSize)
+        {
+          p = mat.template packetByOuterInner<Packet>(j, i+k);
+          reduced = visitor.packetOp(reduced, p);
+          nonFinite = padd(nonFinite, psub(p, p));
+        }
+        if(!(predux(nonFinite)==Scalar(0)) || visitor.packetMayUpdate(reduced))
+          for(Index k = 0; k < BlockSize; ++k)
+            visitCoeff(mat, visitor, j, i+k);
+      }
+      for(; i < innerSize; ++i)
+        visitCoeff(mat, visitor, j, i);
+    }
+  }
+};
+
+template<typename Traits, bool HasPacketAccess> struct visitor_traits_packet_access { enum { value = false }; };
+template<typename Traits> struct visitor_traits_packet_access<Traits, true> { enum { value = bool(Traits::PacketAccess) }; };
+
+// Check whether a visitor processes packets. The functor_traits of the visitors of the users might only define a Cost,
+// which was the only member required before the visitors were vectorized: such visitors are not vectorized.
+template<typename Visitor>
+struct visitor_packet_access
+{
+  typedef functor_traits<Visitor> Traits;
+  template <typename C> static meta_yes testTraits(C const *, typename enable_if<(sizeof(C::PacketAccess)>0)>::type * = 0);
+  static meta_no testTraits(...);
+
+  enum { value = visitor_traits_packet_access<Traits, sizeof(testTraits(static_cast<Traits*>(0))) == sizeof(meta_yes)>::value };
+};
+
 // evaluator adaptor
 template<typename XprType>
 class visitor_evaluator
@@ -68,6 +136,8 @@ public:
   
   enum {
     RowsAtCompileTime = XprType::RowsAtCompileTime,
+    IsRowMajor = XprType::IsRowMajor,
+    PacketAccess = (internal::evaluator<XprType>::Flags & ActualPacketAccessBit) != 0,
     CoeffReadCost = internal::evaluator<XprType>::CoeffReadCost
   };
   
@@ -77,6 +147,10 @@ public:
 
   EIGEN_DEVICE_FUNC CoeffReturnType coeff(Index row, Index col) const
   { return m_evaluator.coeff(row, col); }
+
+  template<typename PacketType>
+  PacketType packetByOuterInner(Index outer, Index inner) const
+  { return m_evaluator.template packet<Unaligned,PacketType>(IsRowMajor ? outer : inner, IsRowMajor ? inner : outer); }
   
 protected:
   internal::evaluator<XprType> m_evaluator;
@@ -111,9 +185,12 @@ void DenseBase<Derived>::visit(Visitor& visitor) const
   
   enum {
     unroll =  SizeAtCompileTime != Dynamic
-           && SizeAtCompileTime * ThisEvaluator::CoeffReadCost + (SizeAtCompileTime-1) * internal::functor_traits<Visitor>::Cost <= EIGEN_UNROLLING_LIMIT
+           && SizeAtCompileTime * ThisEvaluator::CoeffReadCost + (SizeAtCompileTime-1) * internal::functor_traits<Visitor>::Cost <= EIGEN_UNROLLING_LIMIT,
+    // the vectorized visit follows the order of the scalar one, i.e., column by column
+    vectorize = (!unroll) && bool(ThisEvaluator::PacketAccess) && bool(internal::visitor_packet_access<Visitor>::value)
+             && ((!IsRowMajor) || RowsAtCompileTime==1)
   };
-  return internal::visitor_impl<Visitor, ThisEvaluator, unroll ? int(SizeAtCompileTime) : Dynamic>::run(thisEval, visitor);
+  return internal::visitor_impl<Visitor, ThisEvaluator, unroll ? int(SizeAtCompileTime) : Dynamic, vectorize>::run(thisEval, visitor);
 }
 
 namespace internal {
@@ -155,12 +232,22 @@ struct min_coeff_visitor : coeff_visitor<Derived>
       this->col = j;
     }
   }
+
+  template<typename Packet>
+  Packet packetOp(const Packet& a, const Packet& b) const
+  { return internal::pmin(a, b); }
+
+  template<typename Packet>
+  bool packetMayUpdate(const Packet& p) const
+  { return internal::predux_min(p) < this->res; }
 };
 
-template<typename Scalar>
-struct functor_traits<min_coeff_visitor<Scalar> > {
+template<typename Derived>
+struct functor_traits<min_coeff_visitor<Derived> > {
+  typedef typename Derived::Scalar Scalar;
   enum {
-    Cost = NumTraits<Scalar>::AddCost
+    Cost = NumTraits<Scalar>::AddCost,
+    PacketAccess = packet_traits<Scalar>::HasMin
   };
 };
 
@@ -183,12 +270,22 @@ struct max_coeff_visitor : coeff_visitor<Derived>
       this->col = j;
     }
   }
+
+  template<typename Packet>
+  Packet packetOp(const Packet& a, const Packet& b) const
+  { return internal::pmax(a, b); }
+
+  template<typename Packet>
+  bool packetMayUpdate(const Packet& p) const
+  { return internal::predux_max(p) > this->res; }
 };
 
-template<typename Scalar>
-struct functor_traits<max_coeff_visitor<Scalar> > {
+template<typename Derived>
+struct functor_traits<max_coeff_visitor<Derived> > {
+  typedef typename Derived::Scalar Scalar;
   enum {
-    Cost = NumTraits<Scalar>::AddCost
+    Cost = NumTraits<Scalar>::AddCost,
+    PacketAccess = packet_traits<Scalar>::HasMax
   };
 };
 
@@ -0,0 +1,152 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_GEMM_AUTOTUNER_H
+#define EIGEN_GEMM_AUTOTUNER_H
+
+#if !EIGEN_HAS_CXX11
+  #error EIGEN_GEMM_AUTOTUNING requires C++11
+#endif
+
+namespace Eigen {
+
+namespace internal {
+
+/* Returns the best wall-clock time of repetitions evaluations of the product a*b, in seconds */
+template<typename MatrixType>
+double gemm_autotune_time(const MatrixType& a, const MatrixType& b, MatrixType& c, int repetitions)
+{
+  double best = -1;
+  for(int r=0; r<repetitions; ++r)
+  {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    c.noalias() = a * b;
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if(best<0 || elapsed<best)
+      best = elapsed;
+  }
+  return best;
+}
+
+/* Rounds value*factor to a multiple of granularity within [granularity, size] */
+inline Index gemm_autotune_candidate(Index value, double factor, Index granularity, Index size)
+{
+  Index candidate = Index(double(value)*factor);
+  candidate -= candidate % granularity;
+  return numext::maxi<Index>(granularity, numext::mini<Index>(candidate, size));
+}
+
+/* Tunes the blocking sizes of the class of a rows x depth times depth x cols product by a coordinate descent
+ * starting from the heuristic, and returns true if a blocking faster than the heuristic has been found. */
+template<typename Scalar>
+bool gemm_autotune_shape(Index rows, Index depth, Index cols, int repetitions)
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  typedef gebp_traits<Scalar,Scalar> Traits;
+  enum { code = gemm_blocking_scalar<Scalar>::code };
+  const int shape = gemm_shape_class(rows, depth, cols);
+  const Index threads = nbThreads();
+  const int parallel = threads>1 ? 1 : 0;
+
+  // start from the heuristic
+  set_gemm_tuned_blocking(code, code, shape, parallel, 0, 0, 0);
+  Index best[3] = { depth, rows, cols };
+  computeProductBlockingSizes<Scalar,Scalar,1>(best[0], best[1], best[2], threads);
+
+  MatrixType a = MatrixType::Random(rows, depth), b = MatrixType::Random(depth, cols), c(rows, cols);
+  gemm_autotune_time(a, b, c, 1);
+  const double heuristic = gemm_autotune_time(a, b, c, repetitions);
+  double bestTime = heuristic;
+  bool improved = false;
+
+  const Index sizes[3] = { depth, rows, cols };
+  const Index granularities[3] = { 8, Traits::mr, Traits::nr };
+  const double factors[4] = { 0.5, 0.75, 1.5, 2 };
+  for(int p=0; p<3; ++p)
+  {
+    for(int f=0; f<4; ++f)
+    {
+      Index candidate[3] = { best[0], best[1], best[2] };
+      candidate[p] = gemm_autotune_candidate(best[p], factors[f], granularities[p], sizes[p]);
+      if(candidate[p]==best[p])
+        continue;
+      set_gemm_tuned_blocking(code, code, shape, parallel, candidate[0], candidate[1], candidate[2]);
+      double elapsed = gemm_autotune_time(a, b, c, repetitions);
+      // ignore the differences within the timing noise
+      if(elapsed < 0.98*bestTime)
+      {
+        bestTime = elapsed;
+        best[0] = candidate[0];
+        best[1] = candidate[1];
+        best[2] = candidate[2];
+        improved = true;
+      }
+    }
+  }
+
+  if(improved)
+    set_gemm_tuned_blocking(code, code, shape, parallel, best[0], best[1], best[2]);
+  else
+    set_gemm_tuned_blocking(code, code, shape, parallel, 0, 0, 0);
+  return improved;
+}
+
+} // end namespace internal
+
+/** Benchmarks candidate blocking sizes for the matrix products of \c Scalar on the current machine, and keeps for each
+  * class of products the fastest blocking found if it beats the default heuristic.
+  * \a shapes is an array of \a count products given as {rows, depth, cols}, each one standing for its whole class
+  * (see setProductBlockingSizes()), and each candidate is timed as the best of \a repetitions products.
+  * The blocking sizes are tuned for the current number of threads, see nbThreads().
+  *
+  * The tuning takes from seconds to minutes, so the result is meant to be saved once per machine, and then loaded
+  * at startup:
+  * \code
+  * if(!loadProductBlockingSizes("blocking.txt"))
+  * {
+  *   autotuneProductBlockingSizes<double>();
+  *   saveProductBlockingSizes("blocking.txt");
+  * }
+  * \endcode
+  *
+  * \returns the number of classes of products for which a faster blocking has been found
+  *
+  * This function must not be called concurrently with other matrix products. Requires EIGEN_GEMM_AUTOTUNING.
+  * \sa setProductBlockingSizes(), saveProductBlockingSizes(), loadProductBlockingSizes()
+  */
+template<typename Scalar>
+Index autotuneProductBlockingSizes(const Index shapes[][3], Index count, int repetitions = 3)
+{
+  Index tuned = 0;
+  for(Index i=0; i<count; ++i)
+    if(internal::gemm_autotune_shape<Scalar>(shapes[i][0], shapes[i][1], shapes[i][2], repetitions))
+      ++tuned;
+  return tuned;
+}
+
+/** \overload
+  * Tunes the large square products, the rank-512 and rank-128 updates, the products of tall and wide matrices, and
+  * the medium square products.
+  */
+template<typename Scalar>
+Index autotuneProductBlockingSizes(int repetitions = 3)
+{
+  static const Index shapes[][3] = {
+    { 1024, 1024, 1024 },
+    { 1024,  512, 1024 },
+    { 1024,  128, 1024 },
+    {  512, 1024,  512 },
+    { 1024, 1024,  128 },
+    {  128, 1024, 1024 },
+    {  512,  512,  512 }
+  };
+  return autotuneProductBlockingSizes<Scalar>(shapes, sizeof(shapes)/sizeof(shapes[0]), repetitions);
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_GEMM_AUTOTUNER_H
@@ -77,6 +77,27 @@ inline void manage_caching_sizes(Action action, std::ptrdiff_t* l1, std::ptrdiff
   }
 }
 
+/** \internal Gets or sets the number of logical processors sharing each L3 cache, 0 if unknown */
+inline void manage_cache_topology(Action action, std::ptrdiff_t* l3_sharing)
+{
+  static std::ptrdiff_t m_l3_sharing = (std::max)(queryL3CacheSharing(), 0);
+
+  if(action==SetAction)
+  {
+    eigen_internal_assert(l3_sharing!=0);
+    m_l3_sharing = *l3_sharing;
+  }
+  else if(action==GetAction)
+  {
+    eigen_internal_assert(l3_sharing!=0);
+    *l3_sharing = m_l3_sharing;
+  }
+  else
+  {
+    eigen_internal_assert(false);
+  }
+}
+
 /* Helper for computeProductBlockingSizes.
  *
  * Given a m x k times k x n matrix product of scalar types \c LhsScalar and \c RhsScalar,
@@ -133,8 +154,12 @@ void evaluateProductBlockingSizesHeuristic(Index& k, Index& m, Index& n, Index n
     }
 
     if (l3 > l2) {
-      // l3 is shared between all cores, so we'll give each thread its own chunk of l3.
-      const Index m_cache = (l3-l2) / (sizeof(LhsScalar) * k * num_threads);
+      // l3 is shared between the cores of a group, which might be all the cores or a CCX on AMD Zen processors,
+      // so we'll give each thread of a group its own chunk of the l3 of the group.
+      std::ptrdiff_t l3_sharing;
+      manage_cache_topology(GetAction, &l3_sharing);
+      const Index l3_threads = l3_sharing>0 ? (numext::mini<Index>)(num_threads, Index(l3_sharing)) : num_threads;
+      const Index m_cache = (l3-l2) / (sizeof(LhsScalar) * k * l3_threads);
       const Index m_per_thread = numext::div_ceil(m, num_threads);
       if(m_cache < m_per_thread && m_cache >= static_cast<Index>(mr)) {
         m = m_cache - (m_cache % mr);
@@ -277,6 +302,88 @@ inline bool useSpecificBlockingSizes(Index& k, Index& m, Index& n)
   return false;
 }
 
+#ifdef EIGEN_GEMM_AUTOTUNING
+/* Blocking sizes tuned on the current machine for a class of matrix products, see autotuneProductBlockingSizes() */
+struct gemm_tuned_blocking
+{
+  int lhs;        // gemm_blocking_scalar<LhsScalar>::code
+  int rhs;        // gemm_blocking_scalar<RhsScalar>::code
+  int shape;      // gemm_shape_class(m,k,n)
+  int parallel;   // whether the blocking has been tuned for multi-threaded products
+  Index kc;
+  Index mc;
+  Index nc;
+};
+
+template<typename Scalar> struct gemm_blocking_scalar { enum { code = 0 }; };
+template<> struct gemm_blocking_scalar<float> { enum { code = 1 }; };
+template<> struct gemm_blocking_scalar<double> { enum { code = 2 }; };
+template<> struct gemm_blocking_scalar<std::complex<float> > { enum { code = 3 }; };
+template<> struct gemm_blocking_scalar<std::complex<double> > { enum { code = 4 }; };
+
+/* Each dimension of a product is classified as small (<256), medium (<1024) or large (>=1024) */
+inline int gemm_dimension_class(Index size)
+{
+  return size<256 ? 0 : size<1024 ? 1 : 2;
+}
+
+inline int gemm_shape_class(Index m, Index k, Index n)
+{
+  return 9*gemm_dimension_class(m) + 3*gemm_dimension_class(k) + gemm_dimension_class(n);
+}
+
+inline std::vector<gemm_tuned_blocking>& gemm_tuned_blockings()
+{
+  static std::vector<gemm_tuned_blocking> table;
+  return table;
+}
+
+/* Sets the tuned blocking sizes of a class of products, or removes them if kc<=0 */
+inline void set_gemm_tuned_blocking(int lhs, int rhs, int shape, int parallel, Index kc, Index mc, Index nc)
+{
+  std::vector<gemm_tuned_blocking>& table = gemm_tuned_blockings();
+  std::size_t i = 0;
+  while(i<table.size() && (table[i].lhs!=lhs || table[i].rhs!=rhs || table[i].shape!=shape || table[i].parallel!=parallel))
+    ++i;
+  if(kc<=0)
+  {
+    if(i<table.size())
+      table.erase(table.begin()+i);
+    return;
+  }
+  gemm_tuned_blocking entry = { lhs, rhs, shape, parallel, kc, mc, nc };
+  if(i<table.size())
+    table[i] = entry;
+  else
+    table.push_back(entry);
+}
+
+/* Applies the tuned blocking sizes of the class of the product, if any. They are only used for the general
+ * matrix products (KcFactor==1), the triangular and selfadjoint ones keep the heuristic. */
+template<typename LhsScalar, typename RhsScalar, int KcFactor, typename Index>
+bool useTunedBlockingSizes(Index& k, Index& m, Index& n, Index num_threads)
+{
+  const std::vector<gemm_tuned_blocking>& table = gemm_tuned_blockings();
+  enum { lhs = gemm_blocking_scalar<LhsScalar>::code, rhs = gemm_blocking_scalar<RhsScalar>::code };
+  if(KcFactor!=1 || lhs==0 || rhs==0 || table.empty())
+    return false;
+  int shape = gemm_shape_class(m, k, n);
+  int parallel = num_threads>1 ? 1 : 0;
+  for(std::size_t i=0; i<table.size(); ++i)
+  {
+    const gemm_tuned_blocking& entry = table[i];
+    if(entry.lhs==lhs && entry.rhs==rhs && entry.shape==shape && entry.parallel==parallel)
+    {
+      k = numext::mini<Index>(k, Index(entry.kc));
+      m = numext::mini<Index>(m, Index(entry.mc));
+      n = numext::mini<Index>(n, Index(entry.nc));
+      return true;
+    }
+  }
+  return false;
+}
+#endif // EIGEN_GEMM_AUTOTUNING
+
 /** \brief Computes the blocking parameters for a m x k times k x n matrix product
   *
   * \param[in,out] k Input: the third dimension of the product. Output: the blocking size along the same dimension.
@@ -289,6 +396,8 @@ inline bool useSpecificBlockingSizes(Index& k, Index& m, Index& n)
   *
   * The blocking size parameters may be evaluated:
   *   - either by a heuristic based on cache sizes;
+  *   - or using the sizes tuned on the current machine for the class of the product, if EIGEN_GEMM_AUTOTUNING is defined
+  *     (see autotuneProductBlockingSizes());
   *   - or using fixed prescribed values (for testing purposes).
   *
   * \sa setCpuCacheSizes */
@@ -296,9 +405,13 @@ inline bool useSpecificBlockingSizes(Index& k, Index& m, Index& n)
 template<typename LhsScalar, typename RhsScalar, int KcFactor, typename Index>
 void computeProductBlockingSizes(Index& k, Index& m, Index& n, Index num_threads = 1)
 {
-  if (!useSpecificBlockingSizes(k, m, n)) {
-    evaluateProductBlockingSizesHeuristic<LhsScalar, RhsScalar, KcFactor, Index>(k, m, n, num_threads);
-  }
+  if (useSpecificBlockingSizes(k, m, n))
+    return;
+#ifdef EIGEN_GEMM_AUTOTUNING
+  if (useTunedBlockingSizes<LhsScalar, RhsScalar, KcFactor, Index>(k, m, n, num_threads))
+    return;
+#endif
+  evaluateProductBlockingSizesHeuristic<LhsScalar, RhsScalar, KcFactor, Index>(k, m, n, num_threads);
 }
 
 template<typename LhsScalar, typename RhsScalar, typename Index>
@@ -2126,7 +2239,8 @@ inline std::ptrdiff_t l2CacheSize()
 
 /** \returns the currently set level 3 cpu cache size (in bytes) used to estimate the ideal blocking size paramete\
 rs.                                                                                                                
-* \sa setCpuCacheSize */
+* On processors whose L3 is split between groups of cores, this is the size of the L3 of one group.
+* \sa setCpuCacheSize, l3CacheSharing() */
 inline std::ptrdiff_t l3CacheSize()
 {
   std::ptrdiff_t l1, l2, l3;
@@ -2144,6 +2258,110 @@ inline void setCpuCacheSizes(std::ptrdiff_t l1, std::ptrdiff_t l2, std::ptrdiff_
   internal::manage_caching_sizes(SetAction, &l1, &l2, &l3);
 }
 
+/** \returns the currently set number of logical processors sharing each L3 cache, or 0 if unknown.
+  * On AMD Zen processors, the L3 is split per CCX or CCD, which form groups of 4 to 16 cores, and the multi-threaded
+  * matrix products size their blocks for the L3 of a group and keep the threads sharing a packed block within a group.
+  * The value is read from sysfs on Linux and from cpuid otherwise.
+  * \sa setL3CacheSharing(), l3CacheGroup(), l3CacheSize() */
+inline std::ptrdiff_t l3CacheSharing()
+{
+  std::ptrdiff_t l3_sharing;
+  internal::manage_cache_topology(GetAction, &l3_sharing);
+  return l3_sharing;
+}
+
+/** Sets the number of logical processors sharing each L3 cache, 0 meaning all of them.
+  * \sa l3CacheSharing() */
+inline void setL3CacheSharing(std::ptrdiff_t l3Sharing)
+{
+  internal::manage_cache_topology(SetAction, &l3Sharing);
+}
+
+/** \returns the core group of the logical processor \a cpu, identified by the lowest index of the logical processors
+  * sharing its L3 cache, or -1 if unknown. This is only available on Linux, and can be used to pin the threads
+  * of a thread pool so that consecutive threads share an L3.
+  * \sa l3CacheSharing() */
+inline int l3CacheGroup(int cpu)
+{
+  int l3, sharing, first;
+  return internal::queryL3CacheTopology_sysfs(cpu, l3, sharing, first) ? first : -1;
+}
+
+#ifdef EIGEN_GEMM_AUTOTUNING
+/** Sets the blocking sizes \a kc, \a mc and \a nc used by the matrix products of \c LhsScalar by \c RhsScalar
+  * of the same class as a \a rows x \a depth times \a depth x \a cols product, or reverts this class to the default
+  * heuristic if \a kc is zero. Each dimension is classified as small (<256), medium (<1024) or large.
+  * The sizes can be set for single-threaded or multi-threaded products separately.
+  *
+  * This is not thread safe with respect to concurrent matrix products, as setCpuCacheSizes().
+  * Requires EIGEN_GEMM_AUTOTUNING.
+  * \sa autotuneProductBlockingSizes(), saveProductBlockingSizes(), computeProductBlockingSizes() */
+template<typename LhsScalar, typename RhsScalar>
+void setProductBlockingSizes(Index rows, Index depth, Index cols, Index kc, Index mc, Index nc, bool parallel = false)
+{
+  EIGEN_STATIC_ASSERT(internal::gemm_blocking_scalar<LhsScalar>::code!=0 && internal::gemm_blocking_scalar<RhsScalar>::code!=0,
+                      THIS_TYPE_IS_NOT_SUPPORTED)
+  internal::set_gemm_tuned_blocking(internal::gemm_blocking_scalar<LhsScalar>::code, internal::gemm_blocking_scalar<RhsScalar>::code,
+                                    internal::gemm_shape_class(rows, depth, cols), parallel ? 1 : 0, kc, mc, nc);
+}
+
+/** Reverts all the matrix products to the default heuristic for their blocking sizes. */
+inline void clearProductBlockingSizes()
+{
+  internal::gemm_tuned_blockings().clear();
+}
+
+/** Saves the tuned blocking sizes, along with the current cache sizes, to the text file \a filename.
+  * \returns false if the file cannot be written
+  * \sa loadProductBlockingSizes() */
+inline bool saveProductBlockingSizes(const char* filename)
+{
+  std::FILE* file = std::fopen(filename, "w");
+  if(!file)
+    return false;
+  const std::vector<internal::gemm_tuned_blocking>& table = internal::gemm_tuned_blockings();
+  std::fputs("# Eigen product blocking sizes: lhs rhs shape parallel kc mc nc\n", file);
+  std::fprintf(file, "caches %ld %ld %ld\n", long(l1CacheSize()), long(l2CacheSize()), long(l3CacheSize()));
+  for(std::size_t i=0; i<table.size(); ++i)
+    std::fprintf(file, "%d %d %d %d %ld %ld %ld\n", table[i].lhs, table[i].rhs, table[i].shape, table[i].parallel,
+                 long(table[i].kc), long(table[i].mc), long(table[i].nc));
+  return std::fclose(file)==0;
+}
+
+/** Replaces the tuned blocking sizes by the ones saved in \a filename by saveProductBlockingSizes().
+  * \returns false, leaving the current sizes unchanged, if the file cannot be read, or if it has been tuned for
+  * other cache sizes than the current ones, which usually means another machine.
+  * \sa autotuneProductBlockingSizes() */
+inline bool loadProductBlockingSizes(const char* filename)
+{
+  std::FILE* file = std::fopen(filename, "r");
+  if(!file)
+    return false;
+  static const char header[] = "# Eigen product blocking sizes: lhs rhs shape parallel kc mc nc\n";
+  char line[sizeof(header)];
+  std::vector<internal::gemm_tuned_blocking> table;
+  long l1 = 0, l2 = 0, l3 = 0;
+  bool ok = std::fgets(line, sizeof(line), file) && std::strcmp(line, header)==0
+         && std::fscanf(file, " caches %ld %ld %ld", &l1, &l2, &l3) == 3
+         && l1==long(l1CacheSize()) && l2==long(l2CacheSize()) && l3==long(l3CacheSize());
+  internal::gemm_tuned_blocking entry;
+  long kc, mc, nc;
+  while(ok && (std::fscanf(file, "%d %d %d %d %ld %ld %ld", &entry.lhs, &entry.rhs, &entry.shape, &entry.parallel, &kc, &mc, &nc) == 7))
+  {
+    ok = kc>0 && mc>0 && nc>0;
+    entry.kc = kc;
+    entry.mc = mc;
+    entry.nc = nc;
+    table.push_back(entry);
+  }
+  ok = ok && std::feof(file);
+  std::fclose(file);
+  if(ok)
+    internal::gemm_tuned_blockings().swap(table);
+  return ok;
+}
+#endif // EIGEN_GEMM_AUTOTUNING
+
 } // end namespace Eigen
 
 #endif // EIGEN_GENERAL_BLOCK_PANEL_H
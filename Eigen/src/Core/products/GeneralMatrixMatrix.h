@@ -16,6 +16,10 @@ namespace internal {
 
 template<typename _LhsScalar, typename _RhsScalar> class level3_blocking;
 
+/* Tells whether a general_matrix_matrix_product is forwarded to an external BLAS library (see GeneralMatrixMatrix_BLAS.h).
+ * In that case, multi-threading is left to the BLAS library. */
+template<typename Gemm> struct gemm_forwards_to_blas : false_type {};
+
 /* Specialization for a row-major destination matrix => simple transposition of the product */
 template<
   typename Index,
@@ -79,15 +83,17 @@ static void run(Index rows, Index cols, Index depth,
   gemm_pack_rhs<RhsScalar, Index, RhsMapper, Traits::nr, RhsStorageOrder> pack_rhs;
   gebp_kernel<LhsScalar, RhsScalar, Index, ResMapper, Traits::mr, Traits::nr, ConjugateLhs, ConjugateRhs> gebp;
 
-#ifdef EIGEN_HAS_OPENMP
+#if defined(EIGEN_HAS_OPENMP) || defined(EIGEN_GEMM_THREADPOOL)
   if(info)
   {
     // this is the parallel version!
-    int tid = omp_get_thread_num();
-    int threads = omp_get_num_threads();
+    Index tid = info->logical_thread_id;
+    Index threads = info->num_threads;
+    GemmParallelTaskInfo<Index>* task_info = info->task_info;
 
-    LhsScalar* blockA = blocking.blockA();
-    eigen_internal_assert(blockA!=0);
+    // each group of threads has its own slice of A'
+    LhsScalar* blockA = blocking.blockA() + info->lhs_offset*kc;
+    eigen_internal_assert(blocking.blockA()!=0);
 
     std::size_t sizeB = kc*nc;
     ei_declare_aligned_stack_constructed_variable(RhsScalar, blockB, sizeB, 0);
@@ -107,28 +113,28 @@ static void run(Index rows, Index cols, Index depth,
       // However, before copying to A'_i, we have to make sure that no other thread is still using it,
       // i.e., we test that info[tid].users equals 0.
       // Then, we set info[tid].users to the number of threads to mark that all other threads are going to use it.
-      while(info[tid].users!=0) {}
-      info[tid].users += threads;
+      while(task_info[tid].users!=0) {}
+      task_info[tid].users += int(threads);
 
-      pack_lhs(blockA+info[tid].lhs_start*actual_kc, lhs.getSubMapper(info[tid].lhs_start,k), actual_kc, info[tid].lhs_length);
+      pack_lhs(blockA+task_info[tid].lhs_start*actual_kc, lhs.getSubMapper(task_info[tid].lhs_start,k), actual_kc, task_info[tid].lhs_length);
 
       // Notify the other threads that the part A'_i is ready to go.
-      info[tid].sync = k;
+      task_info[tid].sync = k;
 
       // Computes C_i += A' * B' per A'_i
-      for(int shift=0; shift<threads; ++shift)
+      for(Index shift=0; shift<threads; ++shift)
       {
-        int i = (tid+shift)%threads;
+        Index i = (tid+shift)%threads;
 
         // At this point we have to make sure that A'_i has been updated by the thread i,
         // we use testAndSetOrdered to mimic a volatile access.
         // However, no need to wait for the B' part which has been updated by the current thread!
         if (shift>0) {
-          while(info[i].sync!=k) {
+          while(task_info[i].sync!=k) {
           }
         }
 
-        gebp(res.getSubMapper(info[i].lhs_start, 0), blockA+info[i].lhs_start*actual_kc, blockB, info[i].lhs_length, actual_kc, nc, alpha);
+        gebp(res.getSubMapper(task_info[i].lhs_start, 0), blockA+task_info[i].lhs_start*actual_kc, blockB, task_info[i].lhs_length, actual_kc, nc, alpha);
       }
 
       // Then keep going as usual with the remaining B'
@@ -146,12 +152,18 @@ static void run(Index rows, Index cols, Index depth,
       // Release all the sub blocks A'_i of A' for the current thread,
       // i.e., we simply decrement the number of users by 1
       for(Index i=0; i<threads; ++i)
+      {
+#ifdef EIGEN_GEMM_THREADPOOL
+        task_info[i].users -= 1;
+#else
         #pragma omp atomic
-        info[i].users -= 1;
+        task_info[i].users -= 1;
+#endif
+      }
     }
   }
   else
-#endif // EIGEN_HAS_OPENMP
+#endif // EIGEN_HAS_OPENMP || EIGEN_GEMM_THREADPOOL
   {
     EIGEN_UNUSED_VARIABLE(info);
 
@@ -230,6 +242,36 @@ struct gemm_functor
               m_actualAlpha, m_blocking, info);
   }
 
+  typedef Matrix<Scalar,Dynamic,Dynamic,(Dest::Flags&RowMajorBit) ? RowMajor : ColMajor> PartialResult;
+
+  Index depthAlignment() const { return 1; }
+
+  // Computes the product restricted to the slice [depthStart,depthStart+depthLength) of the depth,
+  // either into the destination or into *partial. Each call has its own blocking space such that
+  // several slices can be computed concurrently.
+  void runDepthSlice(Index depthStart, Index depthLength, PartialResult* partial) const
+  {
+    Scalar* res = (Scalar*)&(m_dest.coeffRef(0,0));
+    Index resStride = m_dest.outerStride();
+    if(partial)
+    {
+      partial->setZero(m_dest.rows(), m_dest.cols());
+      res = partial->data();
+      resStride = partial->outerStride();
+    }
+    BlockingType blocking(m_dest.rows(), m_dest.cols(), depthLength, 1, true);
+    Gemm::run(m_dest.rows(), m_dest.cols(), depthLength,
+              &m_lhs.coeffRef(0,depthStart), m_lhs.outerStride(),
+              &m_rhs.coeffRef(depthStart,0), m_rhs.outerStride(),
+              res, resStride,
+              m_actualAlpha, blocking);
+  }
+
+  void addPartial(const PartialResult& partial) const
+  {
+    m_dest += partial;
+  }
+
   typedef typename Gemm::Traits Traits;
 
   protected:
@@ -376,13 +418,13 @@ class gemm_blocking_space<StorageOrder,_LhsScalar,_RhsScalar,MaxRows, MaxCols, M
     void allocateA()
     {
       if(this->m_blockA==0)
-        this->m_blockA = aligned_new<LhsScalar>(m_sizeA);
+        this->m_blockA = scratch_new<LhsScalar>(m_sizeA);
     }
 
     void allocateB()
     {
       if(this->m_blockB==0)
-        this->m_blockB = aligned_new<RhsScalar>(m_sizeB);
+        this->m_blockB = scratch_new<RhsScalar>(m_sizeB);
     }
 
     void allocateAll()
@@ -393,8 +435,8 @@ class gemm_blocking_space<StorageOrder,_LhsScalar,_RhsScalar,MaxRows, MaxCols, M
 
     ~gemm_blocking_space()
     {
-      aligned_delete(this->m_blockA, m_sizeA);
-      aligned_delete(this->m_blockB, m_sizeB);
+      scratch_delete(this->m_blockA, m_sizeA);
+      scratch_delete(this->m_blockB, m_sizeB);
     }
 };
 
@@ -476,17 +518,16 @@ struct generic_product_impl<Lhs,Rhs,DenseShape,DenseShape,GemmProduct>
     typedef internal::gemm_blocking_space<(Dest::Flags&RowMajorBit) ? RowMajor : ColMajor,LhsScalar,RhsScalar,
             Dest::MaxRowsAtCompileTime,Dest::MaxColsAtCompileTime,MaxDepthAtCompileTime> BlockingType;
 
-    typedef internal::gemm_functor<
-      Scalar, Index,
-      internal::general_matrix_matrix_product<
-        Index,
-        LhsScalar, (ActualLhsTypeCleaned::Flags&RowMajorBit) ? RowMajor : ColMajor, bool(LhsBlasTraits::NeedToConjugate),
-        RhsScalar, (ActualRhsTypeCleaned::Flags&RowMajorBit) ? RowMajor : ColMajor, bool(RhsBlasTraits::NeedToConjugate),
-        (Dest::Flags&RowMajorBit) ? RowMajor : ColMajor>,
-      ActualLhsTypeCleaned, ActualRhsTypeCleaned, Dest, BlockingType> GemmFunctor;
+    typedef internal::general_matrix_matrix_product<
+      Index,
+      LhsScalar, (ActualLhsTypeCleaned::Flags&RowMajorBit) ? RowMajor : ColMajor, bool(LhsBlasTraits::NeedToConjugate),
+      RhsScalar, (ActualRhsTypeCleaned::Flags&RowMajorBit) ? RowMajor : ColMajor, bool(RhsBlasTraits::NeedToConjugate),
+      (Dest::Flags&RowMajorBit) ? RowMajor : ColMajor> Gemm;
+
+    typedef internal::gemm_functor<Scalar, Index, Gemm, ActualLhsTypeCleaned, ActualRhsTypeCleaned, Dest, BlockingType> GemmFunctor;
 
     BlockingType blocking(dst.rows(), dst.cols(), lhs.cols(), 1, true);
-    internal::parallelize_gemm<(Dest::MaxRowsAtCompileTime>32 || Dest::MaxRowsAtCompileTime==Dynamic)>
+    internal::parallelize_gemm<(Dest::MaxRowsAtCompileTime>32 || Dest::MaxRowsAtCompileTime==Dynamic) && !internal::gemm_forwards_to_blas<Gemm>::value>
         (GemmFunctor(lhs, rhs, dst, actualAlpha, blocking), a_lhs.rows(), a_rhs.cols(), a_lhs.cols(), Dest::Flags&RowMajorBit);
   }
 };
@@ -0,0 +1,342 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_GENERAL_MATRIX_MATRIX_PACKED_H
+#define EIGEN_GENERAL_MATRIX_MATRIX_PACKED_H
+
+namespace Eigen {
+
+template<typename _Scalar> class PackedGemmLhs;
+
+namespace internal {
+
+/* Computes res += alpha * A * rhs for a column-major destination, where A has already been
+ * packed by PackedGemmLhs. This is the sequential blocking algorithm of general_matrix_matrix_product
+ * without the packing of the lhs: the k-th vertical panel of A (kc x rows) starts at packedA+k*panelStride,
+ * and since mc is a multiple of mr, the sub-panel of the rows [i2,i2+mc) starts i2*kc coefficients further.
+ * The product can be restricted to the rows starting at row, which must be a multiple of mr.
+ */
+template<typename Index, typename Scalar, int RhsStorageOrder>
+struct general_matrix_matrix_product_packed_lhs
+{
+  typedef gebp_traits<Scalar,Scalar> Traits;
+
+  static void run(Index row, Index rows, Index cols, Index depth,
+    const Scalar* packedA, Index panelStride, Index kc, Index mc, Index nc,
+    const Scalar* _rhs, Index rhsStride,
+    Scalar* _res, Index resStride,
+    Scalar alpha)
+  {
+    typedef const_blas_data_mapper<Scalar, Index, RhsStorageOrder> RhsMapper;
+    typedef blas_data_mapper<Scalar, Index, ColMajor> ResMapper;
+    RhsMapper rhs(_rhs,rhsStride);
+    ResMapper res(_res, resStride);
+
+    nc = (std::min)(cols,nc);
+
+    gemm_pack_rhs<Scalar, Index, RhsMapper, Traits::nr, RhsStorageOrder> pack_rhs;
+    gebp_kernel<Scalar, Scalar, Index, ResMapper, Traits::mr, Traits::nr, false, false> gebp;
+
+    std::size_t sizeB = kc*nc;
+    ei_declare_aligned_stack_constructed_variable(Scalar, blockB, sizeB, 0);
+
+    const bool pack_rhs_once = mc<rows && kc==depth && nc==cols;
+
+    for(Index i2=0; i2<rows; i2+=mc)
+    {
+      const Index actual_mc = (std::min)(i2+mc,rows)-i2;
+
+      for(Index k2=0; k2<depth; k2+=kc)
+      {
+        const Index actual_kc = (std::min)(k2+kc,depth)-k2;
+        const Scalar* blockA = packedA + (k2/kc)*panelStride + (row+i2)*actual_kc;
+
+        for(Index j2=0; j2<cols; j2+=nc)
+        {
+          const Index actual_nc = (std::min)(j2+nc,cols)-j2;
+
+          if((!pack_rhs_once) || i2==0)
+            pack_rhs(blockB, rhs.getSubMapper(k2,j2), actual_kc, actual_nc);
+
+          gebp(res.getSubMapper(i2, j2), blockA, blockB, actual_mc, actual_kc, actual_nc, alpha);
+        }
+      }
+    }
+  }
+};
+
+/* Since the lhs is already packed, the threads do not have to share any packed block:
+ * each thread simply processes its own block of the destination. */
+template<typename Scalar, typename Index, typename Gemm, typename Rhs, typename Dest>
+struct packed_gemm_functor
+{
+  packed_gemm_functor(const PackedGemmLhs<Scalar>& lhs, const Rhs& rhs, Dest& dest, const Scalar& actualAlpha)
+    : m_lhs(lhs), m_rhs(rhs), m_dest(dest), m_actualAlpha(actualAlpha)
+  {}
+
+  void initParallelSession(Index /*num_threads*/) const {}
+
+  void operator() (Index row, Index rows, Index col=0, Index cols=-1, GemmParallelInfo<Index>* /*info*/=0) const
+  {
+    // the row blocks of the parallelizer are multiples of mr
+    eigen_internal_assert(row%Traits::mr==0);
+    if(cols==-1)
+      cols = m_rhs.cols();
+
+    Gemm::run(row, rows, cols, m_lhs.cols(),
+              m_lhs.data(), m_lhs.panelStride(), m_lhs.kc(), m_lhs.mc(), m_lhs.nc(),
+              &m_rhs.coeffRef(0,col), m_rhs.outerStride(),
+              &m_dest.coeffRef(row,col), m_dest.outerStride(),
+              m_actualAlpha);
+  }
+
+  typedef Matrix<Scalar,Dynamic,Dynamic,ColMajor> PartialResult;
+
+  // the depth can only be split between two packed panels
+  Index depthAlignment() const { return m_lhs.kc(); }
+
+  void runDepthSlice(Index depthStart, Index depthLength, PartialResult* partial) const
+  {
+    Scalar* res = &m_dest.coeffRef(0,0);
+    Index resStride = m_dest.outerStride();
+    if(partial)
+    {
+      partial->setZero(m_dest.rows(), m_dest.cols());
+      res = partial->data();
+      resStride = partial->outerStride();
+    }
+    Gemm::run(0, m_lhs.rows(), m_rhs.cols(), depthLength,
+              m_lhs.data() + (depthStart/m_lhs.kc())*m_lhs.panelStride(), m_lhs.panelStride(), m_lhs.kc(), m_lhs.mc(), m_lhs.nc(),
+              &m_rhs.coeffRef(depthStart,0), m_rhs.outerStride(),
+              res, resStride,
+              m_actualAlpha);
+  }
+
+  void addPartial(const PartialResult& partial) const
+  {
+    m_dest += partial;
+  }
+
+  typedef typename Gemm::Traits Traits;
+
+  protected:
+    const PackedGemmLhs<Scalar>& m_lhs;
+    const Rhs& m_rhs;
+    Dest& m_dest;
+    Scalar m_actualAlpha;
+};
+
+template<typename Scalar, typename Dest,
+         bool DirectColMajor = bool(traits<Dest>::Flags&DirectAccessBit) && !bool(traits<Dest>::Flags&RowMajorBit)
+                            && bool(is_same<typename traits<Dest>::Scalar,Scalar>::value)>
+struct packed_gemm_lhs_impl
+{
+  // the gebp kernel can only write into a column-major destination with direct access,
+  // so let's go through a temporary.
+  template<typename Rhs>
+  static void run(const PackedGemmLhs<Scalar>& lhs, Dest& dst, const Rhs& rhs, const Scalar& alpha)
+  {
+    Matrix<Scalar,Dynamic,Dynamic,ColMajor> tmp(dst.rows(), dst.cols());
+    tmp.setZero();
+    packed_gemm_lhs_impl<Scalar,Matrix<Scalar,Dynamic,Dynamic,ColMajor> >::run(lhs, tmp, rhs, alpha);
+    dst += tmp;
+  }
+};
+
+template<typename Scalar, typename Dest>
+struct packed_gemm_lhs_impl<Scalar,Dest,true>
+{
+  template<typename Rhs>
+  static void run(const PackedGemmLhs<Scalar>& lhs, Dest& dst, const Rhs& a_rhs, const Scalar& alpha)
+  {
+    enum { RhsOrder = (traits<Rhs>::Flags&RowMajorBit) && Rhs::ColsAtCompileTime!=1 ? RowMajor : ColMajor };
+    typedef Ref<const Matrix<Scalar,Dynamic,Dynamic,RhsOrder>, 0, OuterStride<> > RhsRef;
+    typedef Ref<Matrix<Scalar,Dynamic,Dynamic,ColMajor>, 0, OuterStride<> > DestRef;
+    RhsRef rhs(a_rhs);
+    DestRef res(dst);
+
+    typedef packed_gemm_functor<Scalar, Index,
+              general_matrix_matrix_product_packed_lhs<Index,Scalar,RhsOrder>,
+              RhsRef, DestRef> GemmFunctor;
+
+    parallelize_gemm<true>(GemmFunctor(lhs, rhs, res, alpha), lhs.rows(), rhs.cols(), lhs.cols(), false);
+  }
+};
+
+template<typename Scalar, typename Rhs> struct packed_gemm_lhs_product;
+
+template<typename Scalar, typename Rhs>
+struct traits<packed_gemm_lhs_product<Scalar,Rhs> >
+{
+  typedef typename make_proper_matrix_type<Scalar, Dynamic, Rhs::ColsAtCompileTime,
+                                           ColMajor, Dynamic, Rhs::MaxColsAtCompileTime>::type ReturnType;
+};
+
+template<typename Scalar, typename Rhs>
+struct packed_gemm_lhs_product
+  : public ReturnByValue<packed_gemm_lhs_product<Scalar,Rhs> >
+{
+  packed_gemm_lhs_product(const PackedGemmLhs<Scalar>& lhs, const Rhs& rhs)
+    : m_lhs(lhs), m_rhs(rhs)
+  {}
+
+  inline Index rows() const { return m_lhs.rows(); }
+  inline Index cols() const { return m_rhs.cols(); }
+
+  template<typename Dest> void evalTo(Dest& dst) const
+  {
+    dst.setZero();
+    m_lhs.scaleAndAddTo(dst, m_rhs, Scalar(1));
+  }
+
+  const PackedGemmLhs<Scalar>& m_lhs;
+  typename Rhs::Nested m_rhs;
+};
+
+} // end namespace internal
+
+/** \class PackedGemmLhs
+  * \ingroup Core_Module
+  *
+  * \brief Left hand side of a matrix product packed once and for all
+  *
+  * \tparam _Scalar the type of the coefficients
+  *
+  * A large matrix product \c A*B first copies the coefficients of \c A into the panel layout expected
+  * by the product kernel. When the same matrix \c A is multiplied many times by different right hand sides,
+  * e.g., the weights of a layer or the operator of a time-stepping scheme, this class allows to perform this
+  * packing only once:
+  * \code
+  * MatrixXf W = ...;
+  * PackedGemmLhs<float> packedW(W, 64);   // the products will involve about 64 columns
+  * for(...)
+  *   Y = packedW * X;                      // same as Y = W * X, without the packing of W
+  * \endcode
+  *
+  * The packed layout depends on the blocking sizes, which are computed once from the sizes of \c A and
+  * from the expected number of columns of the right hand sides. The product can be dispatched to multiple
+  * threads like any other matrix product, see nbThreads().
+  *
+  * Note that the packed matrix is a copy: later changes of \c A are not reflected until compute() is called again.
+  */
+template<typename _Scalar> class PackedGemmLhs
+{
+  public:
+    typedef _Scalar Scalar;
+    typedef internal::gebp_traits<Scalar,Scalar> Traits;
+
+    /** Default constructor, compute() must be called before any product. */
+    PackedGemmLhs()
+      : m_rows(0), m_cols(0), m_kc(0), m_mc(0), m_nc(0), m_panelStride(0)
+    {}
+
+    /** Packs \a matrix, see compute(). */
+    template<typename InputType>
+    explicit PackedGemmLhs(const MatrixBase<InputType>& matrix, Index expectedRhsCols = 0)
+      : m_rows(0), m_cols(0), m_kc(0), m_mc(0), m_nc(0), m_panelStride(0)
+    {
+      compute(matrix, expectedRhsCols);
+    }
+
+    /** Packs \a matrix using the blocking sizes of a product with a right hand side of \a expectedRhsCols columns.
+      * If \a expectedRhsCols is not positive, then the number of rows of \a matrix is used instead.
+      */
+    template<typename InputType>
+    PackedGemmLhs& compute(const MatrixBase<InputType>& matrix, Index expectedRhsCols = 0);
+
+    inline Index rows() const { return m_rows; }
+    inline Index cols() const { return m_cols; }
+
+    /** \returns the blocking size along the depth of the product used to pack the matrix */
+    inline Index kc() const { return m_kc; }
+    /** \returns the blocking size along the rows used by the products */
+    inline Index mc() const { return m_mc; }
+    /** \returns the maximal blocking size along the columns used by the products */
+    inline Index nc() const { return m_nc; }
+
+    /** \returns a pointer to the packed coefficients */
+    inline const Scalar* data() const { return m_packed.data(); }
+    /** \returns the distance between two consecutive packed vertical panels */
+    inline Index panelStride() const { return m_panelStride; }
+
+    /** \returns an expression of the product of the packed matrix by \a rhs */
+    template<typename Rhs>
+    inline const internal::packed_gemm_lhs_product<Scalar,Rhs> operator*(const MatrixBase<Rhs>& rhs) const
+    {
+      eigen_assert(rhs.rows()==m_cols && "invalid matrix product");
+      return internal::packed_gemm_lhs_product<Scalar,Rhs>(*this, rhs.derived());
+    }
+
+    /** Performs \a dst += \a alpha * A * \a rhs where A is the packed matrix */
+    template<typename Dest, typename Rhs>
+    void scaleAndAddTo(Dest& dst, const Rhs& rhs, const Scalar& alpha) const
+    {
+      eigen_assert(dst.rows()==m_rows && dst.cols()==rhs.cols() && rhs.rows()==m_cols);
+      if(m_rows==0 || m_cols==0 || rhs.cols()==0)
+        return;
+      internal::packed_gemm_lhs_impl<Scalar,Dest>::run(*this, dst, rhs, alpha);
+    }
+
+  protected:
+    Matrix<Scalar,Dynamic,1> m_packed;
+    Index m_rows;
+    Index m_cols;
+    Index m_kc;
+    Index m_mc;
+    Index m_nc;
+    Index m_panelStride;
+};
+
+template<typename Scalar>
+template<typename InputType>
+PackedGemmLhs<Scalar>& PackedGemmLhs<Scalar>::compute(const MatrixBase<InputType>& matrix, Index expectedRhsCols)
+{
+  EIGEN_STATIC_ASSERT((internal::is_same<typename InputType::Scalar,Scalar>::value),
+    YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+
+  enum { Order = (InputType::Flags&RowMajorBit) && InputType::ColsAtCompileTime!=1 ? RowMajor : ColMajor };
+  typedef Ref<const Matrix<Scalar,Dynamic,Dynamic,Order>, 0, OuterStride<> > LhsRef;
+  LhsRef lhs(matrix.derived());
+
+  m_rows = lhs.rows();
+  m_cols = lhs.cols();
+  m_kc = m_cols;
+  m_mc = m_rows;
+  m_nc = expectedRhsCols>0 ? expectedRhsCols : m_rows;
+  if(m_rows==0 || m_cols==0)
+  {
+    m_packed.resize(0);
+    m_panelStride = 0;
+    return *this;
+  }
+
+  internal::computeProductBlockingSizes<Scalar,Scalar>(m_kc, m_mc, m_nc);
+  // The rows are processed per blocks of mc rows that have to start at the beginning of a packed micro panel.
+  if(m_mc<m_rows)
+    m_mc = (numext::maxi<Index>)(Traits::mr, m_mc - (m_mc % Traits::mr));
+
+  // Each vertical panel must start on an aligned address
+  const Index packetSize = internal::packet_traits<Scalar>::size;
+  const Index panels = (m_cols + m_kc - 1) / m_kc;
+  m_panelStride = ((m_kc*m_rows + packetSize - 1) / packetSize) * packetSize;
+  m_packed.resize(panels*m_panelStride);
+
+  typedef internal::const_blas_data_mapper<Scalar, Index, Order> LhsMapper;
+  LhsMapper lhsMapper(lhs.data(), lhs.outerStride());
+  internal::gemm_pack_lhs<Scalar, Index, LhsMapper, Traits::mr, Traits::LhsProgress, Order> pack_lhs;
+
+  for(Index k2=0; k2<m_cols; k2+=m_kc)
+  {
+    const Index actual_kc = (std::min)(k2+m_kc,m_cols)-k2;
+    pack_lhs(m_packed.data() + (k2/m_kc)*m_panelStride, lhsMapper.getSubMapper(0,k2), actual_kc, m_rows);
+  }
+  return *this;
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_GENERAL_MATRIX_MATRIX_PACKED_H
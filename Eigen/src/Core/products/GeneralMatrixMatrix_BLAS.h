@@ -101,7 +101,15 @@ static void run(Index rows, Index cols, Index depth, \
   } else b = _rhs; \
 \
   BLASFUNC(&transa, &transb, &m, &n, &k, (const BLASTYPE*)&numext::real_ref(alpha), (const BLASTYPE*)a, &lda, (const BLASTYPE*)b, &ldb, (const BLASTYPE*)&numext::real_ref(beta), (BLASTYPE*)res, &ldc); \
-}};
+}}; \
+\
+template< \
+  typename Index, \
+  int LhsStorageOrder, bool ConjugateLhs, \
+  int RhsStorageOrder, bool ConjugateRhs, \
+  int ResStorageOrder> \
+struct gemm_forwards_to_blas<general_matrix_matrix_product<Index,EIGTYPE,LhsStorageOrder,ConjugateLhs,EIGTYPE,RhsStorageOrder,ConjugateRhs,ResStorageOrder> > \
+  : true_type {};
 
 #ifdef EIGEN_USE_MKL
 GEMM_SPECIALIZATION(double,   d,  double, dgemm)
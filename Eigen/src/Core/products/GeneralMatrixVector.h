@@ -398,6 +398,108 @@ EIGEN_DONT_INLINE void general_matrix_vector_product<Index,LhsScalar,LhsMapper,R
   }
 }
 
+/* Tells whether a general_matrix_vector_product is forwarded to an external BLAS library (see GeneralMatrixVector_BLAS.h).
+ * In that case, multi-threading is left to the BLAS library. */
+template<typename Gemv> struct gemv_forwards_to_blas : false_type {};
+
+#ifndef EIGEN_GEMV_MIN_TASK_SIZE
+// Minimal number of coefficients of the matrix processed by each thread of a parallel matrix-vector product.
+#define EIGEN_GEMV_MIN_TASK_SIZE 65536
+#endif
+
+/* Splits a large matrix-vector product across the threads. A matrix-vector product is memory bound,
+ * so the goal is to stream disjoint parts of the matrix on as many cores (and memory channels) as possible:
+ *  - if there are enough rows, each thread computes its own block of rows of the result. For a row-major
+ *    matrix, this is a partition of the dot products, and for a col-major one each thread streams a row block
+ *    of every column;
+ *  - otherwise, the columns are split and each thread accumulates its part of the dot products into a private
+ *    result, these partial results being eventually added to the result.
+ */
+template<typename Gemv, typename Index, typename LhsMapper, typename RhsMapper, typename ResScalar, typename AlphaType>
+struct gemv_parallel_task
+{
+  gemv_parallel_task(Index rows, Index cols, const LhsMapper& lhs, const RhsMapper& rhs,
+                     ResScalar* res, Index resIncr, AlphaType alpha, ResScalar* partials)
+    : m_rows(rows), m_cols(cols), m_lhs(lhs), m_rhs(rhs), m_res(res), m_resIncr(resIncr), m_alpha(alpha), m_partials(partials)
+  {}
+
+  void operator()(Index i, Index actual_threads) const
+  {
+    if(m_partials==0)
+    {
+      // block of rows, aligned on a cache line for a double
+      Index blockRows = ((m_rows/actual_threads)/8)*8;
+      Index r0 = i*blockRows;
+      Index actualBlockRows = (i+1==actual_threads) ? m_rows-r0 : blockRows;
+      if(actualBlockRows>0)
+        Gemv::run(actualBlockRows, m_cols, m_lhs.getSubMapper(r0,0), m_rhs, m_res+r0*m_resIncr, m_resIncr, m_alpha);
+    }
+    else
+    {
+      Index blockCols = ((m_cols/actual_threads)/8)*8;
+      Index c0 = i*blockCols;
+      Index actualBlockCols = (i+1==actual_threads) ? m_cols-c0 : blockCols;
+      if(actualBlockCols>0)
+      {
+        if(i==0) Gemv::run(m_rows, actualBlockCols, m_lhs, m_rhs, m_res, m_resIncr, m_alpha);
+        else     Gemv::run(m_rows, actualBlockCols, m_lhs.getSubMapper(0,c0), m_rhs.getSubMapper(c0,0), m_partials+(i-1)*m_rows, 1, m_alpha);
+      }
+    }
+  }
+
+  Index m_rows;
+  Index m_cols;
+  const LhsMapper& m_lhs;
+  const RhsMapper& m_rhs;
+  ResScalar* m_res;
+  Index m_resIncr;
+  AlphaType m_alpha;
+  ResScalar* m_partials;
+};
+
+/* Entry point of the dense matrix-vector products: computes res += alpha * lhs * rhs,
+ * on multiple threads if the product is large enough. */
+template<typename Index, typename LhsScalar, typename LhsMapper, int LhsStorageOrder, bool ConjugateLhs, typename RhsScalar, typename RhsMapper, bool ConjugateRhs, int Version>
+struct gemv_parallelizer<general_matrix_vector_product<Index,LhsScalar,LhsMapper,LhsStorageOrder,ConjugateLhs,RhsScalar,RhsMapper,ConjugateRhs,Version> >
+{
+  typedef general_matrix_vector_product<Index,LhsScalar,LhsMapper,LhsStorageOrder,ConjugateLhs,RhsScalar,RhsMapper,ConjugateRhs,Version> Gemv;
+  typedef typename ScalarBinaryOpTraits<LhsScalar, RhsScalar>::ReturnType ResScalar;
+
+  template<typename AlphaType>
+  static void run(Index rows, Index cols, const LhsMapper& lhs, const RhsMapper& rhs, ResScalar* res, Index resIncr, AlphaType alpha)
+  {
+#if defined(EIGEN_HAS_OPENMP) || defined(EIGEN_GEMM_THREADPOOL)
+    // the size threshold is checked first, so that the small products do not query the number of threads
+    double work = static_cast<double>(rows) * static_cast<double>(cols);
+    Index threads = gemv_forwards_to_blas<Gemv>::value ? 1 : static_cast<Index>(work / EIGEN_GEMV_MIN_TASK_SIZE);
+    if(threads>1)
+      threads = std::min<Index>(nbThreads(), threads);
+    if(threads>1 && !is_in_parallel_region())
+    {
+      Eigen::initParallel();
+      // split the rows unless it would leave less than a few cache lines per thread
+      bool splitRows = rows >= 64*threads;
+      if(!splitRows)
+        threads = std::max<Index>(1, std::min<Index>(threads, cols/64));
+      if(splitRows || threads>1)
+      {
+        Index partialSize = splitRows ? 0 : rows*(threads-1);
+        ei_declare_aligned_stack_constructed_variable(ResScalar, partials, partialSize, 0);
+        if(!splitRows)
+          Map<Matrix<ResScalar,Dynamic,1> >(partials, partialSize).setZero();
+        parallelize_tasks(threads, gemv_parallel_task<Gemv,Index,LhsMapper,RhsMapper,ResScalar,AlphaType>
+                                     (rows, cols, lhs, rhs, res, resIncr, alpha, splitRows ? 0 : partials));
+        for(Index i=0; i<partialSize; i+=rows)
+          for(Index k=0; k<rows; ++k)
+            res[k*resIncr] += partials[i+k];
+        return;
+      }
+    }
+#endif
+    Gemv::run(rows, cols, lhs, rhs, res, resIncr, alpha);
+  }
+};
+
 } // end namespace internal
 
 } // end namespace Eigen
@@ -79,6 +79,9 @@ static void run( \
       rows, cols, lhs.data(), lhs.stride(), rhs.data(), rhs.stride(), res, resIncr, alpha); \
 } \
 }; \
+template<typename Index, typename LhsMapper, int LhsStorageOrder, bool ConjugateLhs, typename RhsMapper, bool ConjugateRhs> \
+struct gemv_forwards_to_blas<general_matrix_vector_product<Index,Scalar,LhsMapper,LhsStorageOrder,ConjugateLhs,Scalar,RhsMapper,ConjugateRhs,Specialized> > \
+  : true_type {}; \
 
 EIGEN_BLAS_GEMV_SPECIALIZE(double)
 EIGEN_BLAS_GEMV_SPECIALIZE(float)
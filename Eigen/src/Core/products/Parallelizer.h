@@ -14,6 +14,19 @@ namespace Eigen {
 
 namespace internal {
 
+#ifdef EIGEN_GEMM_THREADPOOL
+/** \internal */
+inline ThreadPoolInterface* manage_gemm_thread_pool(Action action, ThreadPoolInterface* pool)
+{
+  static std::atomic<ThreadPoolInterface*> m_pool(nullptr);
+
+  if(action==SetAction)
+    return m_pool.exchange(pool);
+  eigen_internal_assert(action==GetAction);
+  return m_pool.load();
+}
+#endif
+
 /** \internal */
 inline void manage_multi_threading(Action action, int* v)
 {
@@ -27,6 +40,15 @@ inline void manage_multi_threading(Action action, int* v)
   else if(action==GetAction)
   {
     eigen_internal_assert(v!=0);
+    #ifdef EIGEN_GEMM_THREADPOOL
+    if(ThreadPoolInterface* pool = manage_gemm_thread_pool(GetAction, nullptr))
+    {
+      // The calling thread takes part in the computation, so at most NumThreads()-1 tasks are
+      // sent to the pool. This guarantees that all the tasks of a product can run concurrently.
+      *v = m_maxThreads>0 ? (std::min)(m_maxThreads, pool->NumThreads()) : pool->NumThreads();
+      return;
+    }
+    #endif
     #ifdef EIGEN_HAS_OPENMP
     if(m_maxThreads>0)
       *v = m_maxThreads;
@@ -51,6 +73,7 @@ inline void initParallel()
   internal::manage_multi_threading(GetAction, &nbt);
   std::ptrdiff_t l1, l2, l3;
   internal::manage_caching_sizes(GetAction, &l1, &l2, &l3);
+  internal::manage_cache_topology(GetAction, &l3);
 }
 
 /** \returns the max number of threads reserved for Eigen
@@ -69,25 +92,383 @@ inline void setNbThreads(int v)
   internal::manage_multi_threading(SetAction, &v);
 }
 
+#ifdef EIGEN_GEMM_THREADPOOL
+/** Sets the thread pool used by the multi-threaded algorithms of Eigen, and returns the previous one.
+  *
+  * This function is only available when \c EIGEN_GEMM_THREADPOOL is defined. Once a thread pool is set,
+  * it takes precedence over OpenMP, and nbThreads() is bounded by the number of threads of the pool.
+  * Passing a null pointer restores the default behavior.
+  *
+  * The calling thread takes part in the computations, the other tasks are scheduled on \a pool.
+  * Calls made from one of the threads of \a pool itself are run sequentially, and the parallel computations issued
+  * at the same time by several other threads take turns on \a pool.
+  *
+  * \sa getGemmThreadPool(), nbThreads() */
+inline ThreadPoolInterface* setGemmThreadPool(ThreadPoolInterface* pool)
+{
+  return internal::manage_gemm_thread_pool(SetAction, pool);
+}
+
+/** \returns the thread pool used by the multi-threaded algorithms of Eigen, or a null pointer if none has been set.
+  * \sa setGemmThreadPool() */
+inline ThreadPoolInterface* getGemmThreadPool()
+{
+  return internal::manage_gemm_thread_pool(GetAction, nullptr);
+}
+#endif
+
 namespace internal {
 
-template<typename Index> struct GemmParallelInfo
+template<typename Index> struct GemmParallelTaskInfo
 {
-  GemmParallelInfo() : sync(-1), users(0), lhs_start(0), lhs_length(0) {}
+  GemmParallelTaskInfo() : sync(-1), users(0), lhs_start(0), lhs_length(0) {}
 
+#ifdef EIGEN_GEMM_THREADPOOL
+  std::atomic<Index> sync;
+  std::atomic<int> users;
+#else
   Index volatile sync;
   int volatile users;
+#endif
 
   Index lhs_start;
   Index lhs_length;
 };
 
+template<typename Index> struct GemmParallelInfo
+{
+  GemmParallelInfo(Index id, Index threads, GemmParallelTaskInfo<Index>* info, Index offset = 0)
+    : logical_thread_id(id), num_threads(threads), task_info(info), lhs_offset(offset)
+  {}
+
+  // id of the calling thread within its group, and size of the group
+  Index logical_thread_id;
+  Index num_threads;
+  GemmParallelTaskInfo<Index>* task_info;
+  // first row of the slice of the shared packed lhs which is reserved to the group
+  Index lhs_offset;
+};
+
+#ifdef EIGEN_GEMM_THREADPOOL
+/** \internal \returns the flag telling whether the calling thread, which is not a thread of the pool, is running
+  * the first task of a parallel session */
+inline bool& gemm_caller_in_parallel_region()
+{
+  static thread_local bool in_region = false;
+  return in_region;
+}
+
+/** \internal \returns the mutex serializing the parallel sessions run on the thread pool */
+inline std::mutex& gemm_thread_pool_mutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+/** \internal Marks the calling thread as running a task of a parallel session during its lifetime */
+class gemm_caller_region_guard
+{
+  public:
+    gemm_caller_region_guard() : m_previous(gemm_caller_in_parallel_region()) { gemm_caller_in_parallel_region() = true; }
+    ~gemm_caller_region_guard() { gemm_caller_in_parallel_region() = m_previous; }
+
+  private:
+    bool m_previous;
+};
+#endif
+
+/** \internal \returns whether the calling thread is already running a parallel task of Eigen
+  * (or of the user's OpenMP code), in which case nested parallelism is disabled. */
+inline bool is_in_parallel_region()
+{
+#ifdef EIGEN_GEMM_THREADPOOL
+  if(gemm_caller_in_parallel_region())
+    return true;
+  ThreadPoolInterface* pool = getGemmThreadPool();
+  if(pool)
+    return pool->CurrentThreadId()!=-1;
+#endif
+#ifdef EIGEN_HAS_OPENMP
+  // FIXME omp_get_num_threads()>1 only works for openmp, what if the user does not use openmp?
+  return omp_get_num_threads()>1;
+#else
+  return false;
+#endif
+}
+
+#ifdef EIGEN_GEMM_THREADPOOL
+/** \internal Counts down the tasks of a parallel session */
+class parallel_barrier
+{
+  public:
+    explicit parallel_barrier(Index count) : m_count(count) {}
+
+    void notify()
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      if(--m_count==0)
+        m_cond.notify_all();
+    }
+
+    void wait()
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      while(m_count>0)
+        m_cond.wait(lock);
+    }
+
+  private:
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    Index m_count;
+};
+#endif
+
+#if defined(EIGEN_HAS_OPENMP) || defined(EIGEN_GEMM_THREADPOOL)
+/** \internal Hands out the consecutive indices of work items to the tasks of a parallel session */
+class parallel_work_counter
+{
+  public:
+    parallel_work_counter() : m_next(0) {}
+
+    Index next()
+    {
+#ifdef EIGEN_GEMM_THREADPOOL
+      return m_next++;
+#else
+      Index res;
+      #pragma omp atomic capture
+      res = m_next++;
+      return res;
+#endif
+    }
+
+  private:
+#ifdef EIGEN_GEMM_THREADPOOL
+    std::atomic<Index> m_next;
+#else
+    Index m_next;
+#endif
+};
+#endif
+
+/** \internal Runs \c task(i,n) for all i in [0,n) concurrently, and returns once all of them are done.
+  *
+  * The number of tasks \c n is at most \a threads, it might be lower with OpenMP.
+  * The tasks might wait on each other, so they are guaranteed to run on distinct threads.
+  * The caller is responsible for checking that multi-threading is enabled and worth it,
+  * see nbThreads() and is_in_parallel_region().
+  */
+template<typename Task>
+void parallelize_tasks(Index threads, const Task& task)
+{
+#if defined(EIGEN_GEMM_THREADPOOL)
+  if(ThreadPoolInterface* pool = getGemmThreadPool())
+  {
+    // All the tasks of a session must run at the same time. Concurrent sessions, issued by distinct threads which
+    // do not belong to the pool, could each hold some of the workers with tasks waiting on their queued siblings,
+    // so they take turns on the pool.
+    eigen_internal_assert(!gemm_caller_in_parallel_region() && "nested parallel sessions would deadlock");
+    std::lock_guard<std::mutex> lock(gemm_thread_pool_mutex());
+    parallel_barrier barrier(threads-1);
+    for(Index i=1; i<threads; ++i)
+      pool->Schedule([&task, &barrier, i, threads]() { task(i, threads); barrier.notify(); });
+    {
+      // the nested calls of the task run on the calling thread are sequential, as those of the tasks run by the pool
+      gemm_caller_region_guard guard;
+      task(0, threads);
+    }
+    barrier.wait();
+    return;
+  }
+#endif
+#if defined(EIGEN_HAS_OPENMP)
+  #pragma omp parallel num_threads(threads)
+  task(omp_get_thread_num(), omp_get_num_threads());
+#else
+  EIGEN_UNUSED_VARIABLE(threads);
+  task(0, 1);
+#endif
+}
+
+template<typename Func>
+struct parallel_for_task
+{
+  parallel_for_task(const Func& func, Index size) : m_func(func), m_size(size) {}
+
+  void operator()(Index i, Index n) const
+  {
+    for(Index j = i*m_size/n; j < (i+1)*m_size/n; ++j)
+      m_func(j);
+  }
+
+  const Func& m_func;
+  Index m_size;
+};
+
+/** \internal Calls \c func(j) for each j in [0,size), the indices being split in contiguous ranges among the threads
+  * if multi-threading is enabled and the caller is not already in a parallel region. */
+template<typename Func>
+void parallel_for(const Func& func, Index size)
+{
+#if defined(EIGEN_HAS_OPENMP) || defined(EIGEN_GEMM_THREADPOOL)
+  Index threads = size>1 ? (std::min)(Index(nbThreads()), size) : 1;
+  if(threads>1 && !is_in_parallel_region())
+  {
+    Eigen::initParallel();
+    parallelize_tasks(threads, parallel_for_task<Func>(func, size));
+    return;
+  }
+#endif
+  for(Index j = 0; j < size; ++j)
+    func(j);
+}
+
+#ifndef EIGEN_GEMM_MAX_GROUP_THREADS
+// Maximal number of threads sharing the same packed block of the lhs in a parallel matrix product,
+// this should not exceed the number of cores sharing a last level cache (e.g., a CCX on AMD Zen).
+#define EIGEN_GEMM_MAX_GROUP_THREADS 8
+#endif
+
+/* Shape of the grid of threads of a parallel matrix product:
+ * the rows of the destination are split into row_groups blocks, and the columns of each
+ * row block are split across the group_threads threads of the respective group. */
+template<typename Index> struct gemm_partition
+{
+  Index row_groups;
+  Index group_threads;
+};
+
+/* Chooses the 2D partitioning of a rows x cols product across the given number of threads.
+ * For each k-panel, a thread reads the packed lhs of its group and packs its own slice of the rhs,
+ * so we minimize rows/row_groups + cols/group_threads while keeping at least mr rows per group
+ * and nr columns per thread. When no grid fits, we fall back to a 1D split of the columns.
+ * When the threads span several L3 caches of l3_threads threads each, the groups are made of consecutive threads
+ * dividing l3_threads, so that with the threads pinned in order a packed lhs is only read from within one L3. */
+template<typename Index>
+gemm_partition<Index> compute_gemm_partition(Index rows, Index cols, Index threads, Index mr, Index nr, Index l3_threads = 0)
+{
+  const bool split_l3 = l3_threads>0 && threads>l3_threads;
+  gemm_partition<Index> res;
+  res.row_groups = 1;
+  res.group_threads = threads;
+  double best_cost = -1;
+  for(Index row_groups=1; row_groups<=threads; ++row_groups)
+  {
+    if(threads%row_groups!=0)
+      continue;
+    Index group_threads = threads/row_groups;
+    if(group_threads>EIGEN_GEMM_MAX_GROUP_THREADS || cols/group_threads<nr || (row_groups>1 && rows/row_groups<mr))
+      continue;
+    if(split_l3 && l3_threads%group_threads!=0)
+      continue;
+    double cost = double(rows)/double(row_groups) + double(cols)/double(group_threads);
+    if(best_cost<0 || cost<best_cost)
+    {
+      best_cost = cost;
+      res.row_groups = row_groups;
+      res.group_threads = group_threads;
+    }
+  }
+  return res;
+}
+
+/* \returns the number of slices the depth of a product should be split into, or 1 if the
+ * 2D partitioning keeps enough threads busy. Splitting the depth is only worth it when the
+ * destination is too small to be partitioned, and the depth large enough to amortize the
+ * reduction of the partial results. */
+template<typename Index>
+Index compute_gemm_depth_splits(Index rows, Index cols, Index depth, Index threads, Index mr, Index nr)
+{
+  Index max_2d_tasks = (std::max)(Index(1),rows/(4*mr)) * (std::max)(Index(1),cols/(4*nr));
+  if(max_2d_tasks>=threads)
+    return 1;
+  return (std::max)(Index(1), (std::min)(threads, depth / (std::max)(Index(256), 4*(std::max)(rows,cols))));
+}
+
+/* Splits the destination of a matrix product across the threads following a gemm_partition.
+ * Within a group, each thread packs its own slice of the lhs rows of the group into the shared
+ * block A', and then multiplies the whole group's A' by its own slice of the rhs.
+ * The groups share nothing but the allocation of A', in which each group has its own slice, so that
+ * the packed data of a group is first touched, and thus placed on the NUMA node, of its own threads. */
+template<typename Functor, typename Index>
+struct gemm_parallel_task
+{
+  gemm_parallel_task(const Functor& func, Index rows, Index cols, bool transpose, GemmParallelTaskInfo<Index>* info)
+    : m_func(func), m_rows(rows), m_cols(cols), m_transpose(transpose), m_info(info)
+  {}
+
+  void operator()(Index i, Index actual_threads) const
+  {
+    const Index mr = Functor::Traits::mr;
+    // all the tasks compute the same partition, which only depends on the actual number of threads
+    gemm_partition<Index> partition = compute_gemm_partition<Index>(m_rows, m_cols, actual_threads, mr, Functor::Traits::nr, Index(l3CacheSharing()));
+    Index group = i / partition.group_threads;
+    Index group_threads = partition.group_threads;
+    Index tid = i % group_threads;
+
+    Index groupRows = ((m_rows / partition.row_groups)/mr)*mr;
+    Index g0 = group*groupRows;
+    Index actualGroupRows = (group+1==partition.row_groups) ? m_rows-g0 : groupRows;
+
+    Index blockCols = (m_cols / group_threads) & ~Index(0x3);
+    Index blockRows = (actualGroupRows / group_threads);
+    blockRows = (blockRows/mr)*mr;
+
+    Index r0 = tid*blockRows;
+    Index actualBlockRows = (tid+1==group_threads) ? actualGroupRows-r0 : blockRows;
+
+    Index c0 = tid*blockCols;
+    Index actualBlockCols = (tid+1==group_threads) ? m_cols-c0 : blockCols;
+
+    GemmParallelTaskInfo<Index>* group_info = m_info + group*group_threads;
+    group_info[tid].lhs_start = r0;
+    group_info[tid].lhs_length = actualBlockRows;
+
+    GemmParallelInfo<Index> info(tid, group_threads, group_info, g0);
+    if(m_transpose) m_func(c0, actualBlockCols, g0, actualGroupRows, &info);
+    else            m_func(g0, actualGroupRows, c0, actualBlockCols, &info);
+  }
+
+  const Functor& m_func;
+  Index m_rows;
+  Index m_cols;
+  bool m_transpose;
+  GemmParallelTaskInfo<Index>* m_info;
+};
+
+/* Splits the depth of a matrix product across the threads. The first slice is accumulated
+ * into the destination while the other ones are computed into private partial results,
+ * which are added to the destination once all the tasks are done.
+ * The slices are aligned on Functor::depthAlignment(). */
+template<typename Functor, typename Index>
+struct gemm_depth_split_task
+{
+  typedef typename Functor::PartialResult PartialResult;
+
+  gemm_depth_split_task(const Functor& func, Index depth, PartialResult* partials)
+    : m_func(func), m_depth(depth), m_partials(partials)
+  {}
+
+  void operator()(Index i, Index actual_threads) const
+  {
+    Index align = m_func.depthAlignment();
+    Index step = ((m_depth/actual_threads + align-1)/align)*align;
+    Index k0 = (std::min)(i*step, m_depth);
+    Index k1 = (i+1==actual_threads) ? m_depth : (std::min)(k0+step, m_depth);
+    if(k1>k0)
+      m_func.runDepthSlice(k0, k1-k0, i==0 ? 0 : &m_partials[i]);
+  }
+
+  const Functor& m_func;
+  Index m_depth;
+  PartialResult* m_partials;
+};
+
 template<bool Condition, typename Functor, typename Index>
 void parallelize_gemm(const Functor& func, Index rows, Index cols, Index depth, bool transpose)
 {
-  // TODO when EIGEN_USE_BLAS is defined,
-  // we should still enable OMP for other scalar types
-#if !(defined (EIGEN_HAS_OPENMP)) || defined (EIGEN_USE_BLAS)
+#if !(defined(EIGEN_HAS_OPENMP) || defined(EIGEN_GEMM_THREADPOOL))
   // FIXME the transpose variable is only needed to properly split
   // the matrix product when multithreading is enabled. This is a temporary
   // fix to support row-major destination matrices. This whole
@@ -97,65 +478,358 @@ void parallelize_gemm(const Functor& func, Index rows, Index cols, Index depth,
   func(0,rows, 0,cols);
 #else
 
-  // Dynamically check whether we should enable or disable OpenMP.
+  // Dynamically check whether we should enable or disable multi-threading.
   // The conditions are:
   // - the max number of threads we can create is greater than 1
   // - we are not already in a parallel code
   // - the sizes are large enough
 
-  // compute the maximal number of threads from the size of the product:
-  // This first heuristic takes into account that the product kernel is fully optimized when working with nr columns at once.
-  Index size = transpose ? rows : cols;
-  Index pb_max_threads = std::max<Index>(1,size / Functor::Traits::nr);
+  // the splitting is performed on the column-major product, i.e., on the transposed product for a row-major destination
+  Index actualRows = transpose ? cols : rows;
+  Index actualCols = transpose ? rows : cols;
+  const Index mr = Functor::Traits::mr;
+  const Index nr = Functor::Traits::nr;
 
   // compute the maximal number of threads from the total amount of work:
   double work = static_cast<double>(rows) * static_cast<double>(cols) *
       static_cast<double>(depth);
   double kMinTaskSize = 50000;  // FIXME improve this heuristic.
-  pb_max_threads = std::max<Index>(1, std::min<Index>(pb_max_threads, work / kMinTaskSize));
-
-  // compute the number of threads we are going to use
-  Index threads = std::min<Index>(nbThreads(), pb_max_threads);
+  Index threads = std::max<Index>(1, std::min<Index>(nbThreads(), static_cast<Index>(work / kMinTaskSize)));
 
   // if multi-threading is explicitely disabled, not useful, or if we already are in a parallel session,
   // then abort multi-threading
-  // FIXME omp_get_num_threads()>1 only works for openmp, what if the user does not use openmp?
-  if((!Condition) || (threads==1) || (omp_get_num_threads()>1))
+  if((!Condition) || (threads==1) || is_in_parallel_region())
+    return func(0,rows, 0,cols);
+
+  // products with a small destination but a large depth are split along the depth
+  Index depth_splits = compute_gemm_depth_splits(actualRows, actualCols, depth, threads, mr, nr);
+  if(depth_splits>1)
+  {
+    Eigen::initParallel();
+    typedef typename Functor::PartialResult PartialResult;
+    PartialResult* partials = aligned_new<PartialResult>(depth_splits);
+    parallelize_tasks(depth_splits, gemm_depth_split_task<Functor,Index>(func, depth, partials));
+    for(Index i=1; i<depth_splits; ++i)
+      if(partials[i].size()>0)
+        func.addPartial(partials[i]);
+    aligned_delete(partials, depth_splits);
+    return;
+  }
+
+  // compute the maximal number of threads from the size of the product:
+  // This heuristic takes into account that the product kernel is fully optimized when working with nr columns
+  // and a few mr rows at once.
+  Index pb_max_threads = std::max<Index>(1,actualCols / nr) * std::max<Index>(1,actualRows / (4*mr));
+  threads = std::min<Index>(threads, pb_max_threads);
+  if(threads==1)
     return func(0,rows, 0,cols);
 
   Eigen::initParallel();
   func.initParallelSession(threads);
 
-  if(transpose)
-    std::swap(rows,cols);
+  ei_declare_aligned_stack_constructed_variable(GemmParallelTaskInfo<Index>,info,threads,0);
 
-  ei_declare_aligned_stack_constructed_variable(GemmParallelInfo<Index>,info,threads,0);
+  parallelize_tasks(threads, gemm_parallel_task<Functor,Index>(func, actualRows, actualCols, transpose, info));
+#endif
+}
 
-  #pragma omp parallel num_threads(threads)
-  {
-    Index i = omp_get_thread_num();
-    // Note that the actual number of threads might be lower than the number of request ones.
-    Index actual_threads = omp_get_num_threads();
+#ifdef EIGEN_PARALLELIZE_ASSIGNMENT
 
-    Index blockCols = (cols / actual_threads) & ~Index(0x3);
-    Index blockRows = (rows / actual_threads);
-    blockRows = (blockRows/Functor::Traits::mr)*Functor::Traits::mr;
+#ifndef EIGEN_ASSIGNMENT_MIN_TASK_COST
+// Minimal cost, in the units of functor_traits<>::Cost, of the coefficients assigned by each thread of a parallel assignment.
+#define EIGEN_ASSIGNMENT_MIN_TASK_COST 262144
+#endif
 
-    Index r0 = i*blockRows;
-    Index actualBlockRows = (i+1==actual_threads) ? rows-r0 : blockRows;
+/* Assigns a contiguous range of the traversal of the kernel: the linear indices are split for the linear traversals,
+ * and the outer indices otherwise. The ranges are multiples of the granularity to keep the threads on distinct cache lines. */
+template<typename Kernel>
+struct dense_assignment_parallel_task
+{
+  dense_assignment_parallel_task(Kernel& kernel, Index size, Index granularity)
+    : m_kernel(kernel), m_size(size), m_granularity(granularity)
+  {}
 
-    Index c0 = i*blockCols;
-    Index actualBlockCols = (i+1==actual_threads) ? cols-c0 : blockCols;
+  void operator()(Index i, Index actual_threads) const
+  {
+    Index blockSize = (m_size + actual_threads - 1) / actual_threads;
+    blockSize = ((blockSize + m_granularity - 1) / m_granularity) * m_granularity;
+    Index start = (std::min)(i*blockSize, m_size);
+    Index end = (std::min)(start+blockSize, m_size);
+    if(end>start)
+      dense_assignment_range_loop<Kernel>::run(m_kernel, start, end);
+  }
 
-    info[i].lhs_start = r0;
-    info[i].lhs_length = actualBlockRows;
+  Kernel& m_kernel;
+  Index m_size;
+  Index m_granularity;
+};
 
-    if(transpose) func(c0, actualBlockCols, 0, rows, info);
-    else          func(0, rows, c0, actualBlockCols, info);
+/* Splits a dynamic-size coefficient-wise assignment across the threads when the estimated cost of the evaluation
+ * of the source expression is large enough. This cost is obtained from the functor_traits<>::Cost of the functors
+ * of the expression, so that cheap expressions like copies are split into fewer but larger chunks than expensive
+ * ones. The source evaluator, including its temporaries, is shared by all the threads. */
+template<typename Kernel, typename SrcXprType>
+struct dense_assignment_parallelizer<Kernel, SrcXprType, true>
+{
+  typedef typename Kernel::AssignmentTraits Traits;
+  typedef typename Kernel::DstEvaluatorType::XprType DstXprType;
+  enum {
+    IsLinear = int(Traits::Traversal)==int(LinearTraversal) || int(Traits::Traversal)==int(LinearVectorizedTraversal),
+    CoeffCost = int(Kernel::SrcEvaluatorType::CoeffReadCost) + int(functor_traits<typename Kernel::AssignmentFunctor>::Cost)
+  };
+
+  static void run(Kernel &kernel)
+  {
+#if defined(EIGEN_HAS_OPENMP) || defined(EIGEN_GEMM_THREADPOOL)
+    // the size threshold is checked first, so that the small assignments do not query the number of threads
+    double work = static_cast<double>(kernel.size()) * static_cast<double>(CoeffCost);
+    Index threads = static_cast<Index>(work / EIGEN_ASSIGNMENT_MIN_TASK_COST);
+    if(threads>1)
+      threads = std::min<Index>(nbThreads(), threads);
+    if(threads>1 && !is_in_parallel_region())
+    {
+      // split the linear indices on (at least) 64 coefficients boundaries, or the outer indices
+      Index size = IsLinear ? kernel.size() : kernel.outerSize();
+      Index granularity = IsLinear ? 64 : 1;
+      threads = std::min<Index>(threads, (size+granularity-1)/granularity);
+      if(threads>1)
+      {
+        Eigen::initParallel();
+        parallelize_tasks(threads, dense_assignment_parallel_task<Kernel>(kernel, size, granularity));
+        return;
+      }
+    }
+#endif
+    dense_assignment_loop<Kernel>::run(kernel);
   }
+};
+
+#endif // EIGEN_PARALLELIZE_ASSIGNMENT
+
+#ifdef EIGEN_PARALLELIZE_REDUCTION
+
+#ifndef EIGEN_REDUCTION_MIN_TASK_COST
+// Minimal cost, in the units of functor_traits<>::Cost, of the coefficients reduced by each thread of a parallel reduction.
+#define EIGEN_REDUCTION_MIN_TASK_COST 262144
+#endif
+
+#ifndef EIGEN_DETERMINISTIC_REDUCTION_CHUNK_SIZE
+// Number of coefficients of the chunks of a deterministic reduction.
+#define EIGEN_DETERMINISTIC_REDUCTION_CHUNK_SIZE 16384
+#endif
+
+/* Splitting of a reduction over size indices, each index covering innerSize coefficients whose estimated cost is coeffCost.
+ * The chunks are multiple of granularity indices.
+ *
+ * By default the indices are split into one chunk per thread, so that the result depends on the number of threads.
+ * If EIGEN_DETERMINISTIC_REDUCTION is defined, the chunks have a fixed size, such that the chunks and the tree
+ * combining their results (see combine_redux_chunks) only depend on the size of the reduction.
+ * Hence the results are bitwise identical whatever the number of threads, including when running on a single thread. */
+struct redux_chunking
+{
+  redux_chunking(Index n, Index innerSize, double coeffCost, Index granularity)
+    : size(n), threads(1)
+  {
+#if defined(EIGEN_HAS_OPENMP) || defined(EIGEN_GEMM_THREADPOOL)
+    // the size threshold is checked first, so that the small reductions do not query the number of threads
+    double work = static_cast<double>(size) * static_cast<double>(innerSize) * coeffCost;
+    threads = std::max<Index>(1, static_cast<Index>(work / EIGEN_REDUCTION_MIN_TASK_COST));
+    if(threads>1)
+      threads = std::min<Index>(nbThreads(), threads);
+    if(threads>1 && is_in_parallel_region())
+      threads = 1;
+#endif
+#ifdef EIGEN_DETERMINISTIC_REDUCTION
+    chunkSize = std::max<Index>(1, EIGEN_DETERMINISTIC_REDUCTION_CHUNK_SIZE / innerSize);
+#else
+    chunkSize = (size + threads - 1) / threads;
 #endif
+    chunkSize = ((chunkSize + granularity - 1) / granularity) * granularity;
+    chunks = (size + chunkSize - 1) / chunkSize;
+    threads = std::min<Index>(threads, chunks);
+  }
+
+  Index size;
+  Index threads;
+  Index chunkSize;
+  Index chunks;
+};
+
+/* Calls reducer(k, start, end) for the consecutive chunks [i*chunks/n, (i+1)*chunks/n) of a reduction. */
+template<typename ChunkReducer>
+struct redux_chunks_task
+{
+  redux_chunks_task(const redux_chunking& chunking, const ChunkReducer& reducer)
+    : m_chunking(chunking), m_reducer(reducer)
+  {}
+
+  void operator()(Index i, Index actual_threads) const
+  {
+    const Index chunks = m_chunking.chunks, chunkSize = m_chunking.chunkSize;
+    for(Index k = i*chunks/actual_threads; k < (i+1)*chunks/actual_threads; ++k)
+      m_reducer(k, k*chunkSize, (std::min)((k+1)*chunkSize, m_chunking.size));
+  }
+
+  const redux_chunking& m_chunking;
+  const ChunkReducer& m_reducer;
+};
+
+/* Reduces all the chunks, on multiple threads if it is worth it. */
+template<typename ChunkReducer>
+void reduce_chunks(const redux_chunking& chunking, const ChunkReducer& reducer)
+{
+  redux_chunks_task<ChunkReducer> task(chunking, reducer);
+  if(chunking.threads>1)
+  {
+    Eigen::initParallel();
+    parallelize_tasks(chunking.threads, task);
+  }
+  else
+    task(0, 1);
 }
 
+/* Combines the results of the chunks by a pairwise tree, and returns the result in partials[0]. */
+template<typename T, typename Combine>
+const T& combine_redux_chunks(T* partials, Index chunks, const Combine& combine)
+{
+  for(Index step = 1; step < chunks; step *= 2)
+    for(Index k = 0; k + step < chunks; k += 2*step)
+      partials[k] = combine(partials[k], partials[k+step]);
+  return partials[0];
+}
+
+/* Reduces a chunk of the expression with its own packet accumulators. */
+template<typename Func, typename Derived>
+struct redux_chunk_reducer
+{
+  typedef typename Derived::Scalar Scalar;
+
+  redux_chunk_reducer(const Derived& mat, const Func& func, Scalar* partials)
+    : m_mat(mat), m_func(func), m_partials(partials)
+  {}
+
+  void operator()(Index k, Index start, Index end) const
+  {
+    m_partials[k] = redux_range_impl<Func, Derived>::run(m_mat, m_func, start, end);
+  }
+
+  const Derived& m_mat;
+  const Func& m_func;
+  Scalar* m_partials;
+};
+
+/* Splits a large dynamic-size reduction across the threads when its estimated cost, obtained from the
+ * functor_traits<>::Cost of the expression and of the reduction functor, is large enough (see redux_chunking).
+ * The linear indices are split for the linear traversal, and the outer indices otherwise. */
+template<typename Func, typename Derived>
+struct redux_parallelizer<Func, Derived, true>
+{
+  typedef typename Derived::Scalar Scalar;
+  enum {
+    IsLinear = int(redux_traits<Func, Derived>::Traversal)==int(LinearVectorizedTraversal),
+    CoeffCost = int(Derived::CoeffReadCost) + int(functor_traits<Func>::Cost)
+  };
+
+  static Scalar run(const Derived &mat, const Func& func)
+  {
+    eigen_assert(mat.rows()>0 && mat.cols()>0 && "you are using an empty matrix");
+    // chunks of (at least) 64 coefficients, or of outer indices
+    redux_chunking chunking(IsLinear ? mat.size() : mat.outerSize(), IsLinear ? 1 : mat.innerSize(), CoeffCost, IsLinear ? 64 : 1);
+    if(chunking.chunks==1)
+      return redux_impl<Func, Derived>::run(mat, func);
+
+    ei_declare_aligned_stack_constructed_variable(Scalar, partials, chunking.chunks, 0);
+    reduce_chunks(chunking, redux_chunk_reducer<Func, Derived>(mat, func, partials));
+    return combine_redux_chunks(partials, chunking.chunks, func);
+  }
+};
+
+/* Accumulates a chunk of the vector of blueNorm() into its own sums. */
+template<typename Derived>
+struct blue_norm_chunk_reducer
+{
+  typedef typename Derived::RealScalar RealScalar;
+
+  blue_norm_chunk_reducer(const evaluator<Derived>& eval, const blue_norm_params<RealScalar>& params, blue_norm_sums<RealScalar>* partials)
+    : m_eval(eval), m_params(params), m_partials(partials)
+  {}
+
+  void operator()(Index k, Index start, Index end) const
+  {
+    blue_norm_accumulator<Derived>::run(m_eval, start, end, m_params, m_partials[k]);
+  }
+
+  const evaluator<Derived>& m_eval;
+  const blue_norm_params<RealScalar>& m_params;
+  blue_norm_sums<RealScalar>* m_partials;
+};
+
+/* Splits the accumulation of the sums of blueNorm() over a long vector across the threads. */
+template<typename Derived>
+struct blue_norm_parallelizer<Derived, true>
+{
+  typedef typename Derived::RealScalar RealScalar;
+  typedef blue_norm_accumulator<Derived> Accumulator;
+
+  static void run(const Derived& vec, const blue_norm_params<RealScalar>& params, blue_norm_sums<RealScalar>& sums)
+  {
+    // chunks made of whole blocks of the accumulator
+    redux_chunking chunking(vec.size(), 1, evaluator<Derived>::CoeffReadCost + 3*NumTraits<RealScalar>::MulCost, Accumulator::BlockSize);
+    if(chunking.chunks==1)
+    {
+      Accumulator::run(vec, params, sums);
+      return;
+    }
+
+    evaluator<Derived> eval(vec);
+    ei_declare_aligned_stack_constructed_variable(blue_norm_sums<RealScalar>, partials, chunking.chunks, 0);
+    reduce_chunks(chunking, blue_norm_chunk_reducer<Derived>(eval, params, partials));
+    sums = combine_redux_chunks(partials, chunking.chunks, blue_norm_sums_combine<RealScalar>());
+  }
+};
+
+/* Runs stable_norm_kernel on the blocks of a chunk of the vector of stableNorm() with its own scale. */
+template<typename Derived, typename SegmentWrapper, typename RealScalar>
+struct stable_norm_chunk_reducer
+{
+  stable_norm_chunk_reducer(const Derived& vec, Index offset, Index blockSize, stable_norm_sums<RealScalar>* partials)
+    : m_vec(vec), m_offset(offset), m_blockSize(blockSize), m_partials(partials)
+  {}
+
+  void operator()(Index k, Index start, Index end) const
+  {
+    stable_norm_blocks<Derived,SegmentWrapper>::run(m_vec, m_offset+start, m_offset+end, m_blockSize, m_partials[k]);
+  }
+
+  const Derived& m_vec;
+  Index m_offset;
+  Index m_blockSize;
+  stable_norm_sums<RealScalar>* m_partials;
+};
+
+/* Splits the aligned blocks of stableNorm() across the threads, each chunk being made of whole blocks.
+ * The sums of squares of the chunks are rescaled to the largest scale when they are combined. */
+template<typename Derived, typename SegmentWrapper>
+struct stable_norm_parallelizer<Derived, SegmentWrapper, true>
+{
+  template<typename RealScalar>
+  static void run(const Derived& vec, Index start, Index blockSize, stable_norm_sums<RealScalar>& sums)
+  {
+    redux_chunking chunking(vec.size()-start, 1, evaluator<Derived>::CoeffReadCost + 4*NumTraits<RealScalar>::MulCost, blockSize);
+    if(chunking.chunks<=1)
+    {
+      stable_norm_blocks<Derived,SegmentWrapper>::run(vec, start, vec.size(), blockSize, sums);
+      return;
+    }
+
+    ei_declare_aligned_stack_constructed_variable(stable_norm_sums<RealScalar>, partials, chunking.chunks, 0);
+    reduce_chunks(chunking, stable_norm_chunk_reducer<Derived,SegmentWrapper,RealScalar>(vec, start, blockSize, partials));
+    sums = stable_norm_sums_combine<RealScalar>()(sums, combine_redux_chunks(partials, chunking.chunks, stable_norm_sums_combine<RealScalar>()));
+  }
+};
+
+#endif // EIGEN_PARALLELIZE_REDUCTION
+
 } // end namespace internal
 
 } // end namespace Eigen
@@ -0,0 +1,367 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_QUANTIZED_MATRIX_MATRIX_H
+#define EIGEN_QUANTIZED_MATRIX_MATRIX_H
+
+namespace Eigen {
+
+namespace internal {
+
+/* The kernels of the quantized products compute C += A * B for a micro-panel A of mr rows of the lhs and a
+ * micro-panel B of nr columns of the rhs, with int32 accumulation wrapping around on overflow.
+ * The lhs coefficients are signed 8-bit, the rhs ones unsigned 8-bit, and the kq consecutive depths of a row of A,
+ * respectively of a column of B, are packed next to each other, see quantized_pack_lhs and quantized_pack_rhs. */
+struct quantized_gemm_kernel_generic
+{
+  typedef signed char LhsPacked;
+  typedef unsigned char RhsPacked;
+  enum { mr = 4, nr = 4, kq = 1 };
+
+  static void run(const LhsPacked* A, const RhsPacked* B, Index kc, int* C, Index ldc)
+  {
+    unsigned int acc[mr*nr];
+    for(int i=0; i<mr*nr; ++i)
+      acc[i] = 0;
+    for(Index k=0; k<kc; ++k, A+=mr, B+=nr)
+      for(int j=0; j<nr; ++j)
+        for(int i=0; i<mr; ++i)
+          acc[i+j*mr] += static_cast<unsigned int>(int(A[i])*int(B[j]));
+    for(int j=0; j<nr; ++j)
+      for(int i=0; i<mr; ++i)
+        C[i+j*ldc] = static_cast<int>(static_cast<unsigned int>(C[i+j*ldc]) + acc[i+j*mr]);
+  }
+};
+
+#ifdef EIGEN_VECTORIZE_AVX2
+/* The coefficients are widened to 16 bits at packing time, and pairs of depths are multiplied and summed into 32 bits
+ * with vpmaddwd. Unlike vpmaddubsw, which saturates the sums of two unsigned by signed 8-bit products to 16 bits,
+ * this is exact for the whole range of the coefficients. */
+struct quantized_gemm_kernel_avx2
+{
+  typedef short LhsPacked;
+  typedef short RhsPacked;
+  enum { mr = 16, nr = 4, kq = 2 };
+
+  static void run(const LhsPacked* A, const RhsPacked* B, Index kc, int* C, Index ldc)
+  {
+    __m256i c[2][nr];
+    for(int j=0; j<nr; ++j)
+      c[0][j] = c[1][j] = _mm256_setzero_si256();
+    for(Index k=0; k<kc; k+=kq, A+=kq*mr, B+=kq*nr)
+    {
+      __m256i a0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(A));
+      __m256i a1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(A+16));
+      int b[nr];
+      std::memcpy(b, B, sizeof(b));
+      for(int j=0; j<nr; ++j)
+      {
+        __m256i bj = _mm256_set1_epi32(b[j]);
+        c[0][j] = _mm256_add_epi32(c[0][j], _mm256_madd_epi16(a0, bj));
+        c[1][j] = _mm256_add_epi32(c[1][j], _mm256_madd_epi16(a1, bj));
+      }
+    }
+    for(int j=0; j<nr; ++j)
+    {
+      __m256i* dst = reinterpret_cast<__m256i*>(C+j*ldc);
+      _mm256_storeu_si256(dst, _mm256_add_epi32(_mm256_loadu_si256(dst), c[0][j]));
+      _mm256_storeu_si256(dst+1, _mm256_add_epi32(_mm256_loadu_si256(dst+1), c[1][j]));
+    }
+  }
+};
+#endif
+
+#ifdef EIGEN_VECTORIZE_AVX512VNNI
+/* vpdpbusd multiplies four unsigned 8-bit coefficients of the rhs by four signed 8-bit coefficients of the lhs and
+ * adds the sum to each 32-bit lane without saturation. */
+struct quantized_gemm_kernel_avx512vnni
+{
+  typedef signed char LhsPacked;
+  typedef unsigned char RhsPacked;
+  enum { mr = 32, nr = 8, kq = 4 };
+
+  static void run(const LhsPacked* A, const RhsPacked* B, Index kc, int* C, Index ldc)
+  {
+    __m512i c[2][nr];
+    for(int j=0; j<nr; ++j)
+      c[0][j] = c[1][j] = _mm512_setzero_si512();
+    for(Index k=0; k<kc; k+=kq, A+=kq*mr, B+=kq*nr)
+    {
+      __m512i a0 = _mm512_loadu_si512(A);
+      __m512i a1 = _mm512_loadu_si512(A+64);
+      int b[nr];
+      std::memcpy(b, B, sizeof(b));
+      for(int j=0; j<nr; ++j)
+      {
+        __m512i bj = _mm512_set1_epi32(b[j]);
+        c[0][j] = _mm512_dpbusd_epi32(c[0][j], bj, a0);
+        c[1][j] = _mm512_dpbusd_epi32(c[1][j], bj, a1);
+      }
+    }
+    for(int j=0; j<nr; ++j)
+    {
+      int* dst = C+j*ldc;
+      _mm512_storeu_si512(dst, _mm512_add_epi32(_mm512_loadu_si512(dst), c[0][j]));
+      _mm512_storeu_si512(dst+16, _mm512_add_epi32(_mm512_loadu_si512(dst+16), c[1][j]));
+    }
+  }
+};
+#endif
+
+#if defined(EIGEN_VECTORIZE_AVX512VNNI)
+typedef quantized_gemm_kernel_avx512vnni quantized_gemm_default_kernel;
+#elif defined(EIGEN_VECTORIZE_AVX2)
+typedef quantized_gemm_kernel_avx2 quantized_gemm_default_kernel;
+#else
+typedef quantized_gemm_kernel_generic quantized_gemm_default_kernel;
+#endif
+
+/* Packs the rows [i0,i0+mc) and the depths [k0,k0+kc) of the lhs into micro-panels of Kernel::mr rows.
+ * mc is a multiple of mr and kc of kq, the coefficients out of the lhs are packed as zeros. */
+template<typename Kernel, typename LhsEvaluator>
+void quantized_pack_lhs(typename Kernel::LhsPacked* blockA, const LhsEvaluator& lhs, Index rows, Index depth,
+                        Index i0, Index mc, Index k0, Index kc)
+{
+  typedef typename Kernel::LhsPacked Packed;
+  for(Index i=i0; i<i0+mc; i+=Kernel::mr)
+    for(Index k=k0; k<k0+kc; k+=Kernel::kq)
+      for(Index r=i; r<i+Kernel::mr; ++r)
+        for(Index q=k; q<k+Kernel::kq; ++q)
+          *blockA++ = (r<rows && q<depth) ? Packed(lhs.coeff(r,q)) : Packed(0);
+}
+
+/* Packs the columns [j0,j0+nc) and the depths [k0,k0+kc) of the rhs into micro-panels of Kernel::nr columns,
+ * shifted by shift to make them unsigned. */
+template<typename Kernel, typename RhsEvaluator>
+void quantized_pack_rhs(typename Kernel::RhsPacked* blockB, const RhsEvaluator& rhs, Index depth, Index cols,
+                        Index j0, Index nc, Index k0, Index kc, int shift)
+{
+  typedef typename Kernel::RhsPacked Packed;
+  for(Index j=j0; j<j0+nc; j+=Kernel::nr)
+    for(Index k=k0; k<k0+kc; k+=Kernel::kq)
+      for(Index c=j; c<j+Kernel::nr; ++c)
+        for(Index q=k; q<k+Kernel::kq; ++q)
+          *blockB++ = (c<cols && q<depth) ? Packed(int(rhs.coeff(q,c))+shift) : Packed(0);
+}
+
+/* Accumulates the product of the lhs by the shifted rhs into the columns [j_begin,j_end) of acc, whose dimensions are
+ * padded to multiples of mr and nr. The columns of each thread are blocked by nc, the depth by kc and the rows by mc,
+ * such that the micro-panels of A stay in the L1 cache and the blocks of A and B in the L2 cache. */
+template<typename Kernel, typename LhsEvaluator, typename RhsEvaluator>
+struct quantized_gemm_task
+{
+  quantized_gemm_task(const LhsEvaluator& lhs, const RhsEvaluator& rhs, Index rows, Index depth, Index cols,
+                      int shift, int* acc, Index ldacc)
+    : m_lhs(lhs), m_rhs(rhs), m_rows(rows), m_depth(depth), m_cols(cols), m_shift(shift), m_acc(acc), m_ldacc(ldacc)
+  {}
+
+  void operator()(Index i, Index n) const
+  {
+    const Index mr = Kernel::mr, nr = Kernel::nr, kq = Kernel::kq;
+    const Index rows = numext::div_ceil(m_rows, mr)*mr;
+    const Index depth = numext::div_ceil(m_depth, kq)*kq;
+    const Index panels = numext::div_ceil(m_cols, nr);
+    const Index j_begin = (panels*i/n)*nr, j_end = (panels*(i+1)/n)*nr;
+    if(j_end<=j_begin || depth==0)
+      return;
+
+    std::ptrdiff_t l1, l2, l3;
+    manage_caching_sizes(GetAction, &l1, &l2, &l3);
+    const Index lhs_bytes = sizeof(typename Kernel::LhsPacked), rhs_bytes = sizeof(typename Kernel::RhsPacked);
+    Index kc = numext::maxi<Index>(Index(l1) / (2*(mr*lhs_bytes + nr*rhs_bytes)) / kq * kq, 16*kq);
+    kc = numext::mini<Index>(kc, depth);
+    Index mc = numext::mini<Index>(numext::maxi<Index>(Index(l2) / (2*kc*lhs_bytes) / mr * mr, mr), rows);
+    Index nc = numext::mini<Index>(numext::maxi<Index>(Index(l2) / (2*kc*rhs_bytes) / nr * nr, nr), j_end-j_begin);
+
+    typename Kernel::LhsPacked* blockA = scratch_new<typename Kernel::LhsPacked>(mc*kc);
+    typename Kernel::RhsPacked* blockB = scratch_new<typename Kernel::RhsPacked>(nc*kc);
+    for(Index k0=0; k0<depth; k0+=kc)
+    {
+      const Index actual_kc = numext::mini<Index>(kc, depth-k0);
+      for(Index j0=j_begin; j0<j_end; j0+=nc)
+      {
+        const Index actual_nc = numext::mini<Index>(nc, j_end-j0);
+        quantized_pack_rhs<Kernel>(blockB, m_rhs, m_depth, m_cols, j0, actual_nc, k0, actual_kc, m_shift);
+        for(Index i0=0; i0<rows; i0+=mc)
+        {
+          const Index actual_mc = numext::mini<Index>(mc, rows-i0);
+          quantized_pack_lhs<Kernel>(blockA, m_lhs, m_rows, m_depth, i0, actual_mc, k0, actual_kc);
+          for(Index i=0; i<actual_mc; i+=mr)
+            for(Index j=0; j<actual_nc; j+=nr)
+              Kernel::run(blockA+i*actual_kc, blockB+j*actual_kc, actual_kc, m_acc+(i0+i)+(j0+j)*m_ldacc, m_ldacc);
+        }
+      }
+    }
+    scratch_delete(blockA, mc*kc);
+    scratch_delete(blockB, nc*kc);
+  }
+
+  const LhsEvaluator& m_lhs;
+  const RhsEvaluator& m_rhs;
+  Index m_rows, m_depth, m_cols;
+  int m_shift;
+  int* m_acc;
+  Index m_ldacc;
+};
+
+/* Computes acc = lhs * (rhs + shift) with Kernel, where acc is resized to the dimensions of the product padded
+ * to multiples of mr and nr. The columns are split across the threads. */
+template<typename Kernel, typename Lhs, typename Rhs>
+void quantized_gemm(const Lhs& lhs, const Rhs& rhs, int shift, Matrix<int,Dynamic,Dynamic>& acc)
+{
+  typedef evaluator<Lhs> LhsEvaluator;
+  typedef evaluator<Rhs> RhsEvaluator;
+  const Index rows = lhs.rows(), depth = lhs.cols(), cols = rhs.cols();
+  acc.setZero(numext::div_ceil(rows, Index(Kernel::mr))*Kernel::mr, numext::div_ceil(cols, Index(Kernel::nr))*Kernel::nr);
+  LhsEvaluator lhsEval(lhs);
+  RhsEvaluator rhsEval(rhs);
+  quantized_gemm_task<Kernel,LhsEvaluator,RhsEvaluator> task(lhsEval, rhsEval, rows, depth, cols, shift, acc.data(), acc.rows());
+
+  double work = double(rows) * double(cols) * double(depth);
+  Index threads = numext::mini<Index>(nbThreads(), numext::mini<Index>(acc.cols()/Kernel::nr, Index(work/200000)));
+  if(threads>1 && !is_in_parallel_region())
+    parallelize_tasks(threads, task);
+  else
+    task(0, 1);
+}
+
+/* Computes (lhs - lhsZeroPoints) * (rhs - rhsZeroPoints) with modular int32 arithmetic and passes each coefficient
+ * to func(i,j,value). The signed rhs are shifted by 128 to be multiplied as unsigned by the kernels, which is
+ * compensated by their zero points, and the zero points are applied afterwards through the sums of the rows of
+ * the lhs and of the columns of the rhs:
+ *   sum_k (a_ik - za_i) (b_kj - zb_j) = sum_k a_ik b_kj - zb_j sum_k a_ik - za_i sum_k b_kj + depth za_i zb_j */
+template<typename Kernel, typename Lhs, typename Rhs, typename LhsZeroPoints, typename RhsZeroPoints, typename Func>
+void quantized_product_impl(const Lhs& lhs, const Rhs& rhs, const LhsZeroPoints* lhsZeroPoints,
+                            const RhsZeroPoints* rhsZeroPoints, const Func& func)
+{
+  typedef typename Lhs::Scalar LhsScalar;
+  typedef typename Rhs::Scalar RhsScalar;
+  EIGEN_STATIC_ASSERT((is_same<LhsScalar,signed char>::value), YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  EIGEN_STATIC_ASSERT((is_same<RhsScalar,signed char>::value || is_same<RhsScalar,unsigned char>::value), YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  eigen_assert(lhs.cols()==rhs.rows() && "invalid matrix product");
+  eigen_assert((lhsZeroPoints==0 || lhsZeroPoints->size()==lhs.rows()) && (rhsZeroPoints==0 || rhsZeroPoints->size()==rhs.cols()));
+
+  const int shift = is_same<RhsScalar,signed char>::value ? 128 : 0;
+  const Index rows = lhs.rows(), depth = lhs.cols(), cols = rhs.cols();
+  Matrix<int,Dynamic,Dynamic> acc;
+  quantized_gemm<Kernel>(lhs, rhs, shift, acc);
+
+  Matrix<unsigned int,Dynamic,1> lhsSums, rhsSums;
+  if(shift!=0 || rhsZeroPoints)
+    lhsSums = lhs.template cast<int>().rowwise().sum().template cast<unsigned int>();
+  if(lhsZeroPoints)
+    rhsSums = (rhs.template cast<int>().colwise().sum().array() + shift*int(depth)).template cast<unsigned int>().transpose();
+
+  for(Index j=0; j<cols; ++j)
+  {
+    const unsigned int zb = static_cast<unsigned int>((rhsZeroPoints ? int(rhsZeroPoints->coeff(j)) : 0) + shift);
+    for(Index i=0; i<rows; ++i)
+    {
+      unsigned int value = static_cast<unsigned int>(acc(i,j));
+      if(zb!=0)
+        value -= zb*lhsSums.coeff(i);
+      if(lhsZeroPoints)
+      {
+        const unsigned int za = static_cast<unsigned int>(int(lhsZeroPoints->coeff(i)));
+        value += za*(static_cast<unsigned int>(depth)*zb - rhsSums.coeff(j));
+      }
+      func(i, j, static_cast<int>(value));
+    }
+  }
+}
+
+template<typename Dest> struct quantized_store
+{
+  explicit quantized_store(Dest& dst) : m_dst(dst) {}
+  void operator()(Index i, Index j, int value) const { m_dst.coeffRef(i,j) = value; }
+  Dest& m_dst;
+};
+
+template<typename Dest, typename LhsScales, typename RhsScales> struct quantized_scaled_store
+{
+  quantized_scaled_store(Dest& dst, const LhsScales& lhsScales, const RhsScales& rhsScales)
+    : m_dst(dst), m_lhsScales(lhsScales), m_rhsScales(rhsScales)
+  {}
+  void operator()(Index i, Index j, int value) const
+  {
+    typedef typename Dest::Scalar Scalar;
+    m_dst.coeffRef(i,j) = Scalar(m_lhsScales.coeff(i)) * Scalar(m_rhsScales.coeff(j)) * Scalar(value);
+  }
+  Dest& m_dst;
+  const LhsScales& m_lhsScales;
+  const RhsScales& m_rhsScales;
+};
+
+} // end namespace internal
+
+/** \returns in \a dst the product of the signed 8-bit matrix \a lhs by the signed or unsigned 8-bit matrix \a rhs,
+  * accumulated in 32-bit integers.
+  *
+  * The accumulation wraps around on overflow, so that the result is exact whenever it fits in an \c int, which is
+  * always the case for depths up to 65536.
+  * The product is computed by a vpdpbusd kernel when \c EIGEN_VECTORIZE_AVX512VNNI is defined (AVX512 with the
+  * VNNI and BW extensions), by a vpmaddwd kernel when AVX2 is enabled, and by a plain C++ kernel otherwise.
+  * The columns are split across nbThreads() threads.
+  *
+  * Example:
+  * \code
+  * Matrix<signed char,Dynamic,Dynamic> weights = ...;
+  * Matrix<unsigned char,Dynamic,Dynamic> activations = ...;
+  * MatrixXi result;
+  * quantizedProduct(weights, activations, result);
+  * \endcode
+  *
+  * \sa quantizedProduct(const MatrixBase<Lhs>&, const MatrixBase<Rhs>&, const MatrixBase<LhsZeroPoints>&, const MatrixBase<RhsZeroPoints>&, const MatrixBase<Dest>&)
+  */
+template<typename Lhs, typename Rhs, typename Dest>
+void quantizedProduct(const MatrixBase<Lhs>& lhs, const MatrixBase<Rhs>& rhs, const MatrixBase<Dest>& dst)
+{
+  EIGEN_STATIC_ASSERT((internal::is_same<typename Dest::Scalar,int>::value), YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  Dest& res = dst.const_cast_derived();
+  res.resize(lhs.rows(), rhs.cols());
+  internal::quantized_product_impl<internal::quantized_gemm_default_kernel>(lhs.derived(), rhs.derived(),
+    static_cast<const Matrix<int,Dynamic,1>*>(0), static_cast<const Matrix<int,Dynamic,1>*>(0), internal::quantized_store<Dest>(res));
+}
+
+/** \returns in \a dst the product of \a lhs minus the zero point of each of its rows by \a rhs minus the zero point
+  * of each of its columns, accumulated in 32-bit integers:
+  * \f$ dst_{ij} = \sum_k (lhs_{ik} - lhsZeroPoints_i)(rhs_{kj} - rhsZeroPoints_j) \f$.
+  * The zero points are vectors of integers, they are applied after the product and thus cost no more than
+  * a pass on the result.
+  */
+template<typename Lhs, typename Rhs, typename LhsZeroPoints, typename RhsZeroPoints, typename Dest>
+void quantizedProduct(const MatrixBase<Lhs>& lhs, const MatrixBase<Rhs>& rhs,
+                      const MatrixBase<LhsZeroPoints>& lhsZeroPoints, const MatrixBase<RhsZeroPoints>& rhsZeroPoints,
+                      const MatrixBase<Dest>& dst)
+{
+  EIGEN_STATIC_ASSERT((internal::is_same<typename Dest::Scalar,int>::value), YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  Dest& res = dst.const_cast_derived();
+  res.resize(lhs.rows(), rhs.cols());
+  internal::quantized_product_impl<internal::quantized_gemm_default_kernel>(lhs.derived(), rhs.derived(),
+    &lhsZeroPoints.derived(), &rhsZeroPoints.derived(), internal::quantized_store<Dest>(res));
+}
+
+/** \returns in the floating point matrix \a dst the dequantized product
+  * \f$ dst_{ij} = lhsScales_i \, rhsScales_j \sum_k (lhs_{ik} - lhsZeroPoints_i)(rhs_{kj} - rhsZeroPoints_j) \f$.
+  */
+template<typename Lhs, typename Rhs, typename LhsZeroPoints, typename RhsZeroPoints, typename LhsScales, typename RhsScales, typename Dest>
+void quantizedProduct(const MatrixBase<Lhs>& lhs, const MatrixBase<Rhs>& rhs,
+                      const MatrixBase<LhsZeroPoints>& lhsZeroPoints, const MatrixBase<RhsZeroPoints>& rhsZeroPoints,
+                      const MatrixBase<LhsScales>& lhsScales, const MatrixBase<RhsScales>& rhsScales,
+                      const MatrixBase<Dest>& dst)
+{
+  eigen_assert(lhsScales.size()==lhs.rows() && rhsScales.size()==rhs.cols());
+  Dest& res = dst.const_cast_derived();
+  res.resize(lhs.rows(), rhs.cols());
+  internal::quantized_product_impl<internal::quantized_gemm_default_kernel>(lhs.derived(), rhs.derived(),
+    &lhsZeroPoints.derived(), &rhsZeroPoints.derived(),
+    internal::quantized_scaled_store<Dest,LhsScales,RhsScales>(res, lhsScales.derived(), rhsScales.derived()));
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_QUANTIZED_MATRIX_MATRIX_H
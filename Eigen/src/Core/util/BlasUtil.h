@@ -39,6 +39,8 @@ template<typename Index,
          typename RhsScalar, typename RhsMapper, bool ConjugateRhs, int Version=Specialized>
 struct general_matrix_vector_product;
 
+template<typename Gemv> struct gemv_parallelizer;
+
 
 template<bool Conjugate> struct conj_if;
 
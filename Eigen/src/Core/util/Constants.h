@@ -327,7 +327,10 @@ enum StorageOptions {
   /** Align the matrix itself if it is vectorizable fixed-size */
   AutoAlign = 0,
   /** Don't require alignment for the matrix itself (the array of coefficients, if dynamically allocated, may still be requested to be aligned) */ // FIXME --- clarify the situation
-  DontAlign = 0x2
+  DontAlign = 0x2,
+  /** Store the coefficients of a dynamic-size matrix inside the matrix object as long as they fit in \a _MaxRows x \a _MaxCols,
+    * and allocate them on the heap only above (see \ref inlinestorage "Matrix"). */
+  InlineStorage = 0x4
 };
 
 /** \ingroup enums
@@ -132,6 +132,7 @@ template<typename ExpressionType> class ArrayWrapper;
 template<typename ExpressionType> class MatrixWrapper;
 template<typename Derived> class SolverBase;
 template<typename XprType> class InnerIterator;
+class PhiloxGenerator;
 
 namespace internal {
 template<typename DecompositionType> struct kernel_retval_base;
@@ -201,6 +202,8 @@ template<typename Scalar> struct scalar_square_op;
 template<typename Scalar> struct scalar_cube_op;
 template<typename Scalar, typename NewType> struct scalar_cast_op;
 template<typename Scalar> struct scalar_random_op;
+template<typename Scalar> struct scalar_uniform_random_op;
+template<typename Scalar> struct scalar_normal_random_op;
 template<typename Scalar> struct scalar_constant_op;
 template<typename Scalar> struct scalar_identity_op;
 template<typename Scalar,bool iscpx> struct scalar_sign_op;
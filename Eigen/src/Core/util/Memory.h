@@ -147,13 +147,134 @@ EIGEN_DEVICE_FUNC inline void check_that_malloc_is_allowed()
 {}
 #endif
 
-/** \internal Allocates \a size bytes. The returned pointer is guaranteed to have 16 or 32 bytes alignment depending on the requirements.
-  * On allocation error, the returned pointer is null, and std::bad_alloc is thrown.
+#ifdef EIGEN_MALLOC_TRACING
+
+#if !EIGEN_HAS_CXX11
+  #error EIGEN_MALLOC_TRACING requires C++11
+#endif
+
+} // end namespace internal
+
+/** \class MallocTraceRecord
+  * \ingroup Core_Module
+  * \brief Heap allocations of %Eigen recorded for a given site when \c EIGEN_MALLOC_TRACING is defined
+  *
+  * A site is made of the label of the innermost MallocTraceScope of the allocating thread, and of the name of the
+  * type responsible for the allocation when %Eigen knows it: the type of the matrix or array whose storage is allocated
+  * or resized, or the type of the expression whose evaluation allocates a temporary, such as a Product evaluated into
+  * a temporary matrix or the blocking buffers of its kernel. The outermost of these types is kept, and the type of the
+  * scalars is recorded for the other allocations, e.g., the temporary buffers of the decompositions. Both are null when
+  * unknown. The records of equal label and type strings are merged.
+  *
+  * \sa mallocTraceRecords(), printMallocTrace()
   */
-EIGEN_DEVICE_FUNC inline void* aligned_malloc(std::size_t size)
+struct MallocTraceRecord
 {
-  check_that_malloc_is_allowed();
+  const char* label;
+  const char* type;
+  Index count;
+  std::size_t bytes;
+  std::size_t maxBytes;
+};
+
+/** Function called by %Eigen on each heap allocation when \c EIGEN_MALLOC_TRACING is defined, see setMallocTraceHook(). */
+typedef void (*MallocTraceHook)(std::size_t size, const char* label, const char* type);
+
+namespace internal {
+
+struct malloc_trace_state
+{
+  std::mutex mutex;
+  std::vector<MallocTraceRecord> records;
+  MallocTraceHook hook;
+
+  malloc_trace_state() : hook(0) {}
+
+  static malloc_trace_state& instance()
+  {
+    static malloc_trace_state state;
+    return state;
+  }
+};
 
+/* label and type name of the allocations of the calling thread */
+inline const char*& malloc_trace_label()
+{
+  static thread_local const char* label = 0;
+  return label;
+}
+
+inline const char*& malloc_trace_type()
+{
+  static thread_local const char* type = 0;
+  return type;
+}
+
+/* the label and type strings of different sites may be equal, e.g., for the type names of different shared libraries */
+inline bool malloc_trace_same_name(const char* a, const char* b)
+{
+  return a==b || (a && b && std::strcmp(a, b)==0);
+}
+
+inline void trace_malloc(std::size_t size)
+{
+  const char* label = malloc_trace_label();
+  const char* type = malloc_trace_type();
+  malloc_trace_state& state = malloc_trace_state::instance();
+  MallocTraceHook hook;
+  {
+    std::lock_guard<std::mutex> lock(state.mutex);
+    std::size_t i = 0;
+    while(i<state.records.size() && !(malloc_trace_same_name(state.records[i].label, label)
+                                      && malloc_trace_same_name(state.records[i].type, type)))
+      ++i;
+    if(i==state.records.size())
+    {
+      MallocTraceRecord record = { label, type, 0, 0, 0 };
+      state.records.push_back(record);
+    }
+    MallocTraceRecord& record = state.records[i];
+    record.count++;
+    record.bytes += size;
+    record.maxBytes = (std::max)(record.maxBytes, size);
+    hook = state.hook;
+  }
+  if(hook)
+    hook(size, label, type);
+}
+
+/* Sets the type name of the allocations of the calling thread for the lifetime of the object, unless an enclosing
+ * scope already set it: the outermost type is the one of the object or expression which requires the allocation */
+template<typename T> class malloc_trace_type_scope : noncopyable
+{
+  public:
+    malloc_trace_type_scope() : m_previous(malloc_trace_type())
+    {
+#if defined(__GXX_RTTI) || defined(_CPPRTTI) || defined(__cpp_rtti)
+      if(!m_previous)
+        malloc_trace_type() = typeid(T).name();
+#endif
+    }
+    ~malloc_trace_type_scope() { malloc_trace_type() = m_previous; }
+  private:
+    const char* m_previous;
+};
+
+#define EIGEN_MALLOC_TRACE_TYPE(T) Eigen::internal::malloc_trace_type_scope<T> eigen_malloc_trace_type_scope
+
+#else
+
+EIGEN_DEVICE_FUNC inline void trace_malloc(std::size_t)
+{}
+
+#define EIGEN_MALLOC_TRACE_TYPE(T)
+
+#endif // EIGEN_MALLOC_TRACING
+
+/** \internal Allocates \a size bytes aligned on EIGEN_DEFAULT_ALIGN_BYTES with the default allocator.
+  * \returns a null pointer on allocation error */
+EIGEN_DEVICE_FUNC inline void* default_aligned_malloc(std::size_t size)
+{
   void *result;
   #if (EIGEN_DEFAULT_ALIGN_BYTES==0) || EIGEN_MALLOC_ALREADY_ALIGNED
     result = std::malloc(size);
@@ -163,21 +284,204 @@ EIGEN_DEVICE_FUNC inline void* aligned_malloc(std::size_t size)
   #else
     result = handmade_aligned_malloc(size);
   #endif
+  return result;
+}
+
+/** \internal Frees memory allocated with default_aligned_malloc */
+EIGEN_DEVICE_FUNC inline void default_aligned_free(void *ptr)
+{
+  #if (EIGEN_DEFAULT_ALIGN_BYTES==0) || EIGEN_MALLOC_ALREADY_ALIGNED
+    std::free(ptr);
+  #else
+    handmade_aligned_free(ptr);
+  #endif
+}
+
+/** \internal Reallocates memory allocated with default_aligned_malloc.
+  * \returns a null pointer on allocation error */
+inline void* default_aligned_realloc(void *ptr, std::size_t new_size, std::size_t old_size)
+{
+  EIGEN_UNUSED_VARIABLE(old_size);
+#if (EIGEN_DEFAULT_ALIGN_BYTES==0) || EIGEN_MALLOC_ALREADY_ALIGNED
+  return std::realloc(ptr,new_size);
+#else
+  return handmade_aligned_realloc(ptr,new_size,old_size);
+#endif
+}
+
+#ifdef EIGEN_ALLOCATOR_HOOK
+
+} // end namespace internal
+
+/** \class AllocatorHook
+  * \ingroup Core_Module
+  * \brief Pair of functions replacing the aligned heap allocations of %Eigen
+  *
+  * When \c EIGEN_ALLOCATOR_HOOK is defined, the hook installed by setAllocatorHook() is used for all the aligned heap
+  * allocations of %Eigen, and the hook installed by setAllocatorHook<Scalar>() is used for the storage of the
+  * dynamic-size matrices and arrays of the given scalar type.
+  * \c allocate must return a buffer of at least \a size bytes aligned on EIGEN_DEFAULT_ALIGN_BYTES, or a null pointer
+  * on failure, and \c deallocate frees a buffer returned by \c allocate.
+  *
+  * Each buffer records the hook which allocated it, and is freed by this hook whatever the hooks installed in the
+  * meantime. Hooks can thus be changed at any time, but a hook must remain valid while buffers it allocated are alive.
+  *
+  * \sa setAllocatorHook(), hugePageAllocatorHook()
+  */
+struct AllocatorHook
+{
+  void* (*allocate)(std::size_t size);
+  void (*deallocate)(void* ptr);
+};
+
+namespace internal {
+
+#if EIGEN_HAS_CXX11
+typedef std::atomic<const AllocatorHook*> allocator_hook_slot;
+#else
+typedef const AllocatorHook* allocator_hook_slot;
+#endif
+
+inline allocator_hook_slot& global_allocator_hook()
+{
+  static allocator_hook_slot hook(0);
+  return hook;
+}
+
+template<typename Scalar> allocator_hook_slot& scalar_allocator_hook()
+{
+  static allocator_hook_slot hook(0);
+  return hook;
+}
+
+inline const AllocatorHook* exchange_allocator_hook(allocator_hook_slot& slot, const AllocatorHook* hook)
+{
+#if EIGEN_HAS_CXX11
+  return slot.exchange(hook);
+#else
+  const AllocatorHook* previous = slot;
+  slot = hook;
+  return previous;
+#endif
+}
+
+/* Every aligned buffer is preceded by a header recording the hook which allocated it, or a null pointer for the
+ * default allocator, such that it is freed by the same allocator whatever the hooks installed in the meantime.
+ * The size of the header preserves the alignment of the buffers. */
+enum { allocator_hook_header_bytes = EIGEN_DEFAULT_ALIGN_BYTES > int(2*sizeof(void*)) ? EIGEN_DEFAULT_ALIGN_BYTES
+                                                                                       : int(2*sizeof(void*)) };
+
+inline const AllocatorHook*& allocator_hook_owner(void* ptr)
+{
+  return *reinterpret_cast<const AllocatorHook**>(static_cast<char*>(ptr) - allocator_hook_header_bytes);
+}
+
+inline void* hooked_malloc(const AllocatorHook* hook, std::size_t size)
+{
+  check_that_malloc_is_allowed();
+  trace_malloc(size);
+  const std::size_t bytes = size + allocator_hook_header_bytes;
+  char *raw = static_cast<char*>(hook ? hook->allocate(bytes) : default_aligned_malloc(bytes));
+  if(!raw)
+    throw_std_bad_alloc();
+  void *result = raw + allocator_hook_header_bytes;
+  allocator_hook_owner(result) = hook;
+  return result;
+}
+
+inline void hooked_free(void* ptr)
+{
+  if(!ptr)
+    return;
+  void *raw = static_cast<char*>(ptr) - allocator_hook_header_bytes;
+  if(const AllocatorHook* owner = allocator_hook_owner(ptr))
+    owner->deallocate(raw);
+  else
+    default_aligned_free(raw);
+}
+
+inline void* hooked_realloc(const AllocatorHook* hook, void* ptr, std::size_t new_size, std::size_t old_size)
+{
+  if(!ptr)
+    return hooked_malloc(hook, new_size);
+  if(hook==0 && allocator_hook_owner(ptr)==0)
+  {
+    // the default allocator can grow the buffer in place
+    trace_malloc(new_size);
+    char *raw = static_cast<char*>(default_aligned_realloc(static_cast<char*>(ptr) - allocator_hook_header_bytes,
+                                                           new_size + allocator_hook_header_bytes,
+                                                           old_size + allocator_hook_header_bytes));
+    if(!raw)
+      throw_std_bad_alloc();
+    return raw + allocator_hook_header_bytes;
+  }
+  void *result = hooked_malloc(hook, new_size);
+  std::memcpy(result, ptr, (std::min)(new_size, old_size));
+  hooked_free(ptr);
+  return result;
+}
+
+/** \internal \returns the hook of the storage of the dynamic-size objects of type \a Scalar */
+template<typename Scalar> const AllocatorHook* scalar_or_global_allocator_hook()
+{
+  const AllocatorHook* hook = scalar_allocator_hook<Scalar>();
+  return hook ? hook : static_cast<const AllocatorHook*>(global_allocator_hook());
+}
+
+} // end namespace internal
+
+/** Installs the \a hook used for all the aligned heap allocations of %Eigen, or restores the default allocator if
+  * \a hook is null. Requires \c EIGEN_ALLOCATOR_HOOK.
+  * \returns the previous hook
+  * \sa AllocatorHook
+  */
+inline const AllocatorHook* setAllocatorHook(const AllocatorHook* hook)
+{
+  return internal::exchange_allocator_hook(internal::global_allocator_hook(), hook);
+}
+
+/** Installs the \a hook used for the storage of the dynamic-size matrices and arrays of type \a Scalar,
+  * taking precedence over the global hook, or removes it if \a hook is null. Requires \c EIGEN_ALLOCATOR_HOOK.
+  * \returns the previous hook of \a Scalar
+  * \sa AllocatorHook
+  */
+template<typename Scalar> const AllocatorHook* setAllocatorHook(const AllocatorHook* hook)
+{
+  return internal::exchange_allocator_hook(internal::scalar_allocator_hook<Scalar>(), hook);
+}
+
+namespace internal {
+
+#endif // EIGEN_ALLOCATOR_HOOK
+
+/** \internal Allocates \a size bytes. The returned pointer is guaranteed to have 16 or 32 bytes alignment depending on the requirements.
+  * On allocation error, the returned pointer is null, and std::bad_alloc is thrown.
+  */
+EIGEN_DEVICE_FUNC inline void* aligned_malloc(std::size_t size)
+{
+#ifdef EIGEN_ALLOCATOR_HOOK
+  return hooked_malloc(global_allocator_hook(), size);
+#else
+  check_that_malloc_is_allowed();
+  trace_malloc(size);
+
+  void *result = default_aligned_malloc(size);
 
   if(!result && size)
     throw_std_bad_alloc();
 
   return result;
+#endif
 }
 
 /** \internal Frees memory allocated with aligned_malloc. */
 EIGEN_DEVICE_FUNC inline void aligned_free(void *ptr)
 {
-  #if (EIGEN_DEFAULT_ALIGN_BYTES==0) || EIGEN_MALLOC_ALREADY_ALIGNED
-    std::free(ptr);
-  #else
-    handmade_aligned_free(ptr);
-  #endif
+#ifdef EIGEN_ALLOCATOR_HOOK
+  hooked_free(ptr);
+#else
+  default_aligned_free(ptr);
+#endif
 }
 
 /**
@@ -187,19 +491,18 @@ EIGEN_DEVICE_FUNC inline void aligned_free(void *ptr)
   */
 inline void* aligned_realloc(void *ptr, std::size_t new_size, std::size_t old_size)
 {
-  EIGEN_UNUSED_VARIABLE(old_size);
-
-  void *result;
-#if (EIGEN_DEFAULT_ALIGN_BYTES==0) || EIGEN_MALLOC_ALREADY_ALIGNED
-  result = std::realloc(ptr,new_size);
+#ifdef EIGEN_ALLOCATOR_HOOK
+  return hooked_realloc(global_allocator_hook(), ptr, new_size, old_size);
 #else
-  result = handmade_aligned_realloc(ptr,new_size,old_size);
-#endif
+  trace_malloc(new_size);
+
+  void *result = default_aligned_realloc(ptr, new_size, old_size);
 
   if (!result && new_size)
     throw_std_bad_alloc();
 
   return result;
+#endif
 }
 
 /*****************************************************************************
@@ -217,6 +520,7 @@ template<bool Align> EIGEN_DEVICE_FUNC inline void* conditional_aligned_malloc(s
 template<> EIGEN_DEVICE_FUNC inline void* conditional_aligned_malloc<false>(std::size_t size)
 {
   check_that_malloc_is_allowed();
+  trace_malloc(size);
 
   void *result = std::malloc(size);
   if(!result && size)
@@ -242,6 +546,7 @@ template<bool Align> inline void* conditional_aligned_realloc(void* ptr, std::si
 
 template<> inline void* conditional_aligned_realloc<false>(void* ptr, std::size_t new_size, std::size_t)
 {
+  trace_malloc(new_size);
   return std::realloc(ptr, new_size);
 }
 
@@ -365,13 +670,40 @@ template<typename T, bool Align> EIGEN_DEVICE_FUNC inline T* conditional_aligned
   return result;
 }
 
+/** \internal Allocates the storage of \a size bytes of a dynamic-size object of type \a T, through the allocator hook
+  * of \a T if any (see setAllocatorHook<Scalar>()). */
+template<typename T, bool Align> EIGEN_DEVICE_FUNC inline void* scalar_aligned_malloc(std::size_t size)
+{
+  EIGEN_MALLOC_TRACE_TYPE(T);
+#ifdef EIGEN_ALLOCATOR_HOOK
+  if(Align)
+    return hooked_malloc(scalar_or_global_allocator_hook<T>(), size);
+#endif
+  return conditional_aligned_malloc<Align>(size);
+}
+
+template<typename T, bool Align> inline void* scalar_aligned_realloc(void* ptr, std::size_t new_size, std::size_t old_size)
+{
+  EIGEN_MALLOC_TRACE_TYPE(T);
+#ifdef EIGEN_ALLOCATOR_HOOK
+  if(Align)
+    return hooked_realloc(scalar_or_global_allocator_hook<T>(), ptr, new_size, old_size);
+#endif
+  return conditional_aligned_realloc<Align>(ptr, new_size, old_size);
+}
+
+// the aligned buffers are freed by the hook which allocated them, see hooked_free()
+template<typename T, bool Align> EIGEN_DEVICE_FUNC inline void scalar_aligned_free(void* ptr)
+{
+  conditional_aligned_free<Align>(ptr);
+}
 
 template<typename T, bool Align> EIGEN_DEVICE_FUNC inline T* conditional_aligned_new_auto(std::size_t size)
 {
   if(size==0)
     return 0; // short-cut. Also fixes Bug 884
   check_size_for_overflow<T>(size);
-  T *result = reinterpret_cast<T*>(conditional_aligned_malloc<Align>(sizeof(T)*size));
+  T *result = reinterpret_cast<T*>(scalar_aligned_malloc<T,Align>(sizeof(T)*size));
   if(NumTraits<T>::RequireInitialization)
   {
     EIGEN_TRY
@@ -380,7 +712,7 @@ template<typename T, bool Align> EIGEN_DEVICE_FUNC inline T* conditional_aligned
     }
     EIGEN_CATCH(...)
     {
-      conditional_aligned_free<Align>(result);
+      scalar_aligned_free<T,Align>(result);
       EIGEN_THROW;
     }
   }
@@ -393,7 +725,7 @@ template<typename T, bool Align> inline T* conditional_aligned_realloc_new_auto(
   check_size_for_overflow<T>(old_size);
   if(NumTraits<T>::RequireInitialization && (new_size < old_size))
     destruct_elements_of_array(pts+new_size, old_size-new_size);
-  T *result = reinterpret_cast<T*>(conditional_aligned_realloc<Align>(reinterpret_cast<void*>(pts), sizeof(T)*new_size, sizeof(T)*old_size));
+  T *result = reinterpret_cast<T*>(scalar_aligned_realloc<T,Align>(reinterpret_cast<void*>(pts), sizeof(T)*new_size, sizeof(T)*old_size));
   if(NumTraits<T>::RequireInitialization && (new_size > old_size))
   {
     EIGEN_TRY
@@ -402,7 +734,7 @@ template<typename T, bool Align> inline T* conditional_aligned_realloc_new_auto(
     }
     EIGEN_CATCH(...)
     {
-      conditional_aligned_free<Align>(result);
+      scalar_aligned_free<T,Align>(result);
       EIGEN_THROW;
     }
   }
@@ -413,7 +745,7 @@ template<typename T, bool Align> EIGEN_DEVICE_FUNC inline void conditional_align
 {
   if(NumTraits<T>::RequireInitialization)
     destruct_elements_of_array<T>(ptr, size);
-  conditional_aligned_free<Align>(ptr);
+  scalar_aligned_free<T,Align>(ptr);
 }
 
 /****************************************************************************/
@@ -536,6 +868,173 @@ template<typename T> struct smart_memmove_helper<T,false> {
 };
 
 
+/*****************************************************************************
+*** Implementation of the scratch arena of the temporary buffers           ***
+*****************************************************************************/
+
+#ifdef EIGEN_SCRATCH_ARENA
+
+#if !EIGEN_HAS_CXX11
+  #error EIGEN_SCRATCH_ARENA requires C++11
+#endif
+
+#ifndef EIGEN_SCRATCH_ARENA_MAX_BYTES
+// Maximal number of bytes of the released buffers kept by the scratch arena of each thread.
+#define EIGEN_SCRATCH_ARENA_MAX_BYTES (std::size_t(256)*1024*1024)
+#endif
+
+#ifndef EIGEN_SCRATCH_ARENA_BLOCKS_PER_CLASS
+// Maximal number of released buffers of each size class kept by the scratch arena of each thread.
+#define EIGEN_SCRATCH_ARENA_BLOCKS_PER_CLASS 4
+#endif
+
+/** \internal
+  * Per-thread cache of the temporary buffers of the products and decompositions.
+  * The sizes of the buffers are rounded up to powers of two, and the released buffers of each size class
+  * are kept for later reuse by the same thread, up to EIGEN_SCRATCH_ARENA_BLOCKS_PER_CLASS buffers per class and
+  * EIGEN_SCRATCH_ARENA_MAX_BYTES bytes per thread. The cached buffers are freed when the thread exits,
+  * or by Eigen::releaseScratchArena(). The arena must not be used once destroyed, by the destructors of the
+  * thread_local or static objects run after it, which then allocate their temporary buffers directly (see destroyed()).
+  */
+class scratch_arena : noncopyable
+{
+  public:
+    enum { Classes = 8*sizeof(std::size_t), BlocksPerClass = EIGEN_SCRATCH_ARENA_BLOCKS_PER_CLASS };
+
+    scratch_arena() : m_cachedBytes(0)
+    {
+      for(int c = 0; c < Classes; ++c)
+        m_counts[c] = 0;
+    }
+
+    ~scratch_arena()
+    {
+      release();
+      destroyed() = true;
+    }
+
+    /** \internal \returns the arena of the calling thread, which must not be destroyed */
+    static scratch_arena& instance()
+    {
+      eigen_internal_assert(!destroyed());
+      static thread_local scratch_arena arena;
+      return arena;
+    }
+
+    /** \internal \returns whether the arena of the calling thread has been destroyed. The flag has no destructor,
+      * so that it can still be read during the destruction of the thread_local and static objects. */
+    static bool& destroyed()
+    {
+      static thread_local bool flag = false;
+      return flag;
+    }
+
+    void* allocate(std::size_t size)
+    {
+      const int c = sizeClass(size);
+      if(m_counts[c]>0)
+      {
+        m_cachedBytes -= std::size_t(1) << c;
+        return m_blocks[c][--m_counts[c]];
+      }
+      return aligned_malloc(std::size_t(1) << c);
+    }
+
+    void deallocate(void* ptr, std::size_t size)
+    {
+      if(ptr==0)
+        return;
+      const int c = sizeClass(size);
+      const std::size_t bytes = std::size_t(1) << c;
+      if(m_counts[c]<BlocksPerClass && m_cachedBytes+bytes<=std::size_t(EIGEN_SCRATCH_ARENA_MAX_BYTES))
+      {
+        m_blocks[c][m_counts[c]++] = ptr;
+        m_cachedBytes += bytes;
+      }
+      else
+        aligned_free(ptr);
+    }
+
+    void release()
+    {
+      for(int c = 0; c < Classes; ++c)
+      {
+        while(m_counts[c]>0)
+          aligned_free(m_blocks[c][--m_counts[c]]);
+      }
+      m_cachedBytes = 0;
+    }
+
+    std::size_t cachedBytes() const { return m_cachedBytes; }
+
+  protected:
+    static int sizeClass(std::size_t size)
+    {
+      int c = 0;
+      while((std::size_t(1) << c) < size)
+        ++c;
+      return c;
+    }
+
+    void* m_blocks[Classes][BlocksPerClass];
+    int m_counts[Classes];
+    std::size_t m_cachedBytes;
+};
+
+#endif // EIGEN_SCRATCH_ARENA
+
+/** \internal Allocates a temporary buffer of \a size bytes, to be freed by scratch_free() with the same size.
+  * If EIGEN_SCRATCH_ARENA is defined, the buffer is taken from the scratch arena of the calling thread,
+  * and otherwise allocated by aligned_malloc().
+  */
+inline void* scratch_malloc(std::size_t size)
+{
+#ifdef EIGEN_SCRATCH_ARENA
+  if(!scratch_arena::destroyed())
+    return scratch_arena::instance().allocate(size);
+#endif
+  return aligned_malloc(size);
+}
+
+/** \internal Frees a buffer allocated by scratch_malloc(size) */
+inline void scratch_free(void* ptr, std::size_t size)
+{
+#ifdef EIGEN_SCRATCH_ARENA
+  if(!scratch_arena::destroyed())
+  {
+    scratch_arena::instance().deallocate(ptr, size);
+    return;
+  }
+#endif
+  EIGEN_UNUSED_VARIABLE(size);
+  aligned_free(ptr);
+}
+
+/** \internal Like aligned_new, for temporary buffers allocated by scratch_malloc() */
+template<typename T> inline T* scratch_new(std::size_t size)
+{
+  check_size_for_overflow<T>(size);
+  EIGEN_MALLOC_TRACE_TYPE(T);
+  T *result = reinterpret_cast<T*>(scratch_malloc(sizeof(T)*size));
+  EIGEN_TRY
+  {
+    return construct_elements_of_array(result, size);
+  }
+  EIGEN_CATCH(...)
+  {
+    scratch_free(result, sizeof(T)*size);
+    EIGEN_THROW;
+  }
+  return result;
+}
+
+/** \internal Deletes objects constructed with scratch_new */
+template<typename T> inline void scratch_delete(T *ptr, std::size_t size)
+{
+  destruct_elements_of_array<T>(ptr, size);
+  scratch_free(ptr, sizeof(T)*size);
+}
+
 /*****************************************************************************
 *** Implementation of runtime stack allocation (falling back to malloc)    ***
 *****************************************************************************/
@@ -572,7 +1071,7 @@ template<typename T> class aligned_stack_memory_handler : noncopyable
       if(NumTraits<T>::RequireInitialization && m_ptr)
         Eigen::internal::destruct_elements_of_array<T>(m_ptr, m_size);
       if(m_deallocate)
-        Eigen::internal::aligned_free(m_ptr);
+        Eigen::internal::scratch_free(m_ptr, sizeof(T)*m_size);
     }
   protected:
     T* m_ptr;
@@ -606,6 +1105,135 @@ template<typename T> void swap(scoped_array<T> &a,scoped_array<T> &b)
 
 } // end namespace internal
 
+#ifdef EIGEN_SCRATCH_ARENA
+/** Frees the temporary buffers cached by the scratch arena of the calling thread.
+  *
+  * \sa ScratchArenaScope, scratchArenaCachedBytes(), \ref TopicPreprocessorDirectives "EIGEN_SCRATCH_ARENA"
+  */
+inline void releaseScratchArena()
+{
+  if(!internal::scratch_arena::destroyed())
+    internal::scratch_arena::instance().release();
+}
+
+/** \returns the number of bytes of the temporary buffers cached by the scratch arena of the calling thread */
+inline std::size_t scratchArenaCachedBytes()
+{
+  return internal::scratch_arena::destroyed() ? 0 : internal::scratch_arena::instance().cachedBytes();
+}
+
+/** \class ScratchArenaScope
+  * \ingroup Core_Module
+  * \brief Frees the temporary buffers cached by the scratch arena of the calling thread at the end of a scope
+  *
+  * This is useful to bound the memory kept by a thread after a burst of large products or decompositions:
+  * \code
+  * {
+  *   ScratchArenaScope scope;
+  *   for(int i=0; i<n; ++i)
+  *     c[i].noalias() = a[i] * b[i];   // the blocking buffers are reused across the iterations
+  * }                                   // and freed here
+  * \endcode
+  */
+class ScratchArenaScope : internal::noncopyable
+{
+  public:
+    ScratchArenaScope() {}
+    ~ScratchArenaScope() { releaseScratchArena(); }
+};
+#endif // EIGEN_SCRATCH_ARENA
+
+#ifdef EIGEN_MALLOC_TRACING
+/** \returns the heap allocations recorded since the start of the program or the last call to resetMallocTrace(),
+  * one record per allocation site.
+  *
+  * \sa MallocTraceScope, printMallocTrace(), \ref TopicPreprocessorDirectives "EIGEN_MALLOC_TRACING"
+  */
+inline std::vector<MallocTraceRecord> mallocTraceRecords()
+{
+  internal::malloc_trace_state& state = internal::malloc_trace_state::instance();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  return state.records;
+}
+
+/** \returns the total of the heap allocations recorded since the start of the program or the last call to
+  * resetMallocTrace(), with a null label and type. */
+inline MallocTraceRecord mallocTraceSummary()
+{
+  std::vector<MallocTraceRecord> records = mallocTraceRecords();
+  MallocTraceRecord total = { 0, 0, 0, 0, 0 };
+  for(std::size_t i=0; i<records.size(); ++i)
+  {
+    total.count += records[i].count;
+    total.bytes += records[i].bytes;
+    total.maxBytes = (std::max)(total.maxBytes, records[i].maxBytes);
+  }
+  return total;
+}
+
+/** Clears the recorded heap allocations. */
+inline void resetMallocTrace()
+{
+  internal::malloc_trace_state& state = internal::malloc_trace_state::instance();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  state.records.clear();
+}
+
+/** Prints the recorded heap allocations to \a os, one line per site with the number of allocations, the total and
+  * maximal number of bytes, the label and the type name. */
+inline void printMallocTrace(std::ostream& os)
+{
+  std::vector<MallocTraceRecord> records = mallocTraceRecords();
+  os << "count\tbytes\tmax bytes\tlabel\ttype\n";
+  for(std::size_t i=0; i<records.size(); ++i)
+    os << records[i].count << '\t' << records[i].bytes << '\t' << records[i].maxBytes << '\t'
+       << (records[i].label ? records[i].label : "-") << '\t' << (records[i].type ? records[i].type : "-") << '\n';
+}
+
+/** Installs a function called on each heap allocation of %Eigen, after it has been recorded, or removes it if
+  * \a hook is null. It can be used to break into a debugger or to capture a stack trace on unexpected allocations.
+  * The hook is called from the allocating thread and must not allocate through %Eigen.
+  * \returns the previous hook
+  */
+inline MallocTraceHook setMallocTraceHook(MallocTraceHook hook)
+{
+  internal::malloc_trace_state& state = internal::malloc_trace_state::instance();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  MallocTraceHook previous = state.hook;
+  state.hook = hook;
+  return previous;
+}
+
+/** \class MallocTraceScope
+  * \ingroup Core_Module
+  * \brief Labels the heap allocations of the calling thread within a scope
+  *
+  * \code
+  * resetMallocTrace();
+  * for(int i=0; i<n; ++i)
+  * {
+  *   MallocTraceScope scope("update");
+  *   x = A.transpose() * (A * x - b);   // the temporary of A * x - b is recorded with the label "update"
+  * }
+  * printMallocTrace(std::cerr);
+  * \endcode
+  *
+  * \a label must outlive the recorded allocations, and allocations of equal label strings are recorded together.
+  * Scopes can be nested, the innermost one wins.
+  */
+class MallocTraceScope : internal::noncopyable
+{
+  public:
+    explicit MallocTraceScope(const char* label) : m_previous(internal::malloc_trace_label())
+    {
+      internal::malloc_trace_label() = label;
+    }
+    ~MallocTraceScope() { internal::malloc_trace_label() = m_previous; }
+  private:
+    const char* m_previous;
+};
+#endif // EIGEN_MALLOC_TRACING
+
 /** \internal
   * Declares, allocates and construct an aligned buffer named NAME of SIZE elements of type TYPE on the stack
   * if SIZE is smaller than EIGEN_STACK_ALLOCATION_LIMIT, and if stack allocation is supported by the platform
@@ -636,14 +1264,14 @@ template<typename T> void swap(scoped_array<T> &a,scoped_array<T> &b)
     TYPE* NAME = (BUFFER)!=0 ? (BUFFER) \
                : reinterpret_cast<TYPE*>( \
                       (sizeof(TYPE)*SIZE<=EIGEN_STACK_ALLOCATION_LIMIT) ? EIGEN_ALIGNED_ALLOCA(sizeof(TYPE)*SIZE) \
-                    : Eigen::internal::aligned_malloc(sizeof(TYPE)*SIZE) );  \
+                    : Eigen::internal::scratch_malloc(sizeof(TYPE)*SIZE) );  \
     Eigen::internal::aligned_stack_memory_handler<TYPE> EIGEN_CAT(NAME,_stack_memory_destructor)((BUFFER)==0 ? NAME : 0,SIZE,sizeof(TYPE)*SIZE>EIGEN_STACK_ALLOCATION_LIMIT)
 
 #else
 
   #define ei_declare_aligned_stack_constructed_variable(TYPE,NAME,SIZE,BUFFER) \
     Eigen::internal::check_size_for_overflow<TYPE>(SIZE); \
-    TYPE* NAME = (BUFFER)!=0 ? BUFFER : reinterpret_cast<TYPE*>(Eigen::internal::aligned_malloc(sizeof(TYPE)*SIZE));    \
+    TYPE* NAME = (BUFFER)!=0 ? BUFFER : reinterpret_cast<TYPE*>(Eigen::internal::scratch_malloc(sizeof(TYPE)*SIZE));    \
     Eigen::internal::aligned_stack_memory_handler<TYPE> EIGEN_CAT(NAME,_stack_memory_destructor)((BUFFER)==0 ? NAME : 0,SIZE,true)
 
 #endif
@@ -910,6 +1538,46 @@ inline void queryCacheSizes_intel(int& l1, int& l2, int& l3, int max_std_funcs)
     queryCacheSizes_intel_codes(l1,l2,l3);
 }
 
+/* Reads the size of the cache of the given level and the number of logical processors sharing it from the
+ * deterministic cache parameters leaf, which is leaf 0x4 on Intel and leaf 0x8000001D on AMD with the same layout.
+ * On Intel the sharing is the maximal number of addressable logical processors, which may be rounded up. */
+inline bool queryCacheTopology_leaf(int leaf, int level, int& size, int& sharing)
+{
+  int abcd[4];
+  for(int cache_id=0; cache_id<16; ++cache_id)
+  {
+    abcd[0] = abcd[1] = abcd[2] = abcd[3] = 0;
+    EIGEN_CPUID(abcd,leaf,cache_id);
+    int cache_type = abcd[0] & 0x1F;                  // A[4:0]
+    if(cache_type==0)
+      break;
+    if((cache_type==1 || cache_type==3) && ((abcd[0] & 0xE0) >> 5)==level)
+    {
+      int ways        = (abcd[1] & 0xFFC00000) >> 22; // B[31:22]
+      int partitions  = (abcd[1] & 0x003FF000) >> 12; // B[21:12]
+      int line_size   = (abcd[1] & 0x00000FFF) >>  0; // B[11:0]
+      int sets        = (abcd[2]);                    // C[31:0]
+      size = (ways+1) * (partitions+1) * (line_size+1) * (sets+1);
+      sharing = ((abcd[0] >> 14) & 0xFFF) + 1;        // A[25:14]
+      return true;
+    }
+  }
+  return false;
+}
+
+inline bool queryL3CacheTopology_amd(int& l3, int& sharing)
+{
+  int abcd[4];
+  abcd[0] = abcd[1] = abcd[2] = abcd[3] = 0;
+  EIGEN_CPUID(abcd,0x80000000,0);
+  if(static_cast<unsigned int>(abcd[0]) < 0x8000001Du)
+    return false;
+  abcd[0] = abcd[1] = abcd[2] = abcd[3] = 0;
+  EIGEN_CPUID(abcd,0x80000001,0);
+  if((abcd[2] & (1<<22))==0) // C[22] = TopologyExtensions
+    return false;
+  return queryCacheTopology_leaf(0x8000001D, 3, l3, sharing);
+}
 inline void queryCacheSizes_amd(int& l1, int& l2, int& l3)
 {
   int abcd[4];
@@ -920,9 +1588,80 @@ inline void queryCacheSizes_amd(int& l1, int& l2, int& l3)
   EIGEN_CPUID(abcd,0x80000006,0);
   l2 = (abcd[2] >> 16) * 1024; // C[31;16] = l2 cache size in KB
   l3 = ((abcd[3] & 0xFFFC000) >> 18) * 512 * 1024; // D[31;18] = l3 cache size in 512KB
+  // prefer the size of a single L3 instance, i.e., the L3 of a CCX on Zen, when the processor describes it
+  int l3_instance, sharing;
+  if(queryL3CacheTopology_amd(l3_instance, sharing))
+    l3 = l3_instance;
 }
+
 #endif
 
+/* Reads the L3 cache of the logical processor cpu from the sysfs cache description of Linux: the size of the L3
+ * instance, the number of logical processors sharing it, and the lowest of them, which identifies the core group. */
+inline bool queryL3CacheTopology_sysfs(int cpu, int& l3, int& sharing, int& first)
+{
+#if EIGEN_OS_LINUX
+  char path[96];
+  for(int index=0; index<16; ++index)
+  {
+    std::sprintf(path, "/sys/devices/system/cpu/cpu%d/cache/index%d/level", cpu, index);
+    std::FILE* file = std::fopen(path, "r");
+    if(!file)
+      return false;
+    int level = 0;
+    bool ok = std::fscanf(file, "%d", &level)==1;
+    std::fclose(file);
+    if(!ok || level!=3)
+      continue;
+
+    std::sprintf(path, "/sys/devices/system/cpu/cpu%d/cache/index%d/size", cpu, index);
+    file = std::fopen(path, "r");
+    if(!file)
+      return false;
+    int size = 0;
+    char unit = 0;
+    ok = std::fscanf(file, "%d%c", &size, &unit)>=1;
+    std::fclose(file);
+    if(!ok)
+      return false;
+    l3 = unit=='K' ? size*1024 : unit=='M' ? size*1024*1024 : size;
+
+    // a list of ranges, e.g., "0-7,64-71"
+    std::sprintf(path, "/sys/devices/system/cpu/cpu%d/cache/index%d/shared_cpu_list", cpu, index);
+    file = std::fopen(path, "r");
+    if(!file)
+      return false;
+    sharing = 0;
+    first = -1;
+    int a, b;
+    while(std::fscanf(file, "%d", &a)==1)
+    {
+      b = a;
+      int c = std::fgetc(file);
+      if(c=='-')
+      {
+        if(std::fscanf(file, "%d", &b)!=1)
+          break;
+        c = std::fgetc(file);
+      }
+      sharing += b-a+1;
+      if(first<0 || a<first)
+        first = a;
+      if(c!=',')
+        break;
+    }
+    std::fclose(file);
+    return sharing>0;
+  }
+#else
+  EIGEN_UNUSED_VARIABLE(cpu);
+  EIGEN_UNUSED_VARIABLE(l3);
+  EIGEN_UNUSED_VARIABLE(sharing);
+  EIGEN_UNUSED_VARIABLE(first);
+#endif
+  return false;
+}
+
 /** \internal
  * Queries and returns the cache sizes in Bytes of the L1, L2, and L3 data caches respectively */
 inline void queryCacheSizes(int& l1, int& l2, int& l3)
@@ -960,6 +1699,35 @@ inline void queryCacheSizes(int& l1, int& l2, int& l3)
   #endif
 }
 
+/** \internal
+ * Queries the number of logical processors sharing each L3 cache, i.e., the size of the core groups of the processor,
+ * such as the CCX or CCD of AMD Zen processors whose L3 is split into one instance per group.
+ * The sysfs cache description is used on Linux, and the cpuid cache parameters otherwise. Returns -1 if unknown. */
+inline int queryL3CacheSharing()
+{
+  int l3, sharing, first;
+  if(queryL3CacheTopology_sysfs(0, l3, sharing, first))
+    return sharing;
+  #ifdef EIGEN_CPUID
+  int abcd[4];
+  const int GenuineIntel[] = {0x756e6547, 0x49656e69, 0x6c65746e};
+  const int AuthenticAMD[] = {0x68747541, 0x69746e65, 0x444d4163};
+  EIGEN_CPUID(abcd,0x0,0);
+  int max_std_funcs = abcd[0];
+  if(cpuid_is_vendor(abcd,AuthenticAMD))
+  {
+    if(queryL3CacheTopology_amd(l3, sharing))
+      return sharing;
+  }
+  else if(cpuid_is_vendor(abcd,GenuineIntel) && max_std_funcs>=4)
+  {
+    if(queryCacheTopology_leaf(0x4, 3, l3, sharing))
+      return sharing;
+  }
+  #endif
+  return -1;
+}
+
 /** \internal
  * \returns the size in Bytes of the L1 data cache */
 inline int queryL1CacheSize()
@@ -13,6 +13,12 @@
 
 #include "./Tridiagonalization.h"
 
+/** \internal size from which the eigenvectors of the tridiagonal matrix are computed by divide and conquer,
+  * see internal::tridiagonal_divide_conquer() */
+#ifndef EIGEN_SELFADJOINT_DIVIDE_CONQUER_THRESHOLD
+#define EIGEN_SELFADJOINT_DIVIDE_CONQUER_THRESHOLD 128
+#endif
+
 namespace Eigen { 
 
 template<typename _MatrixType>
@@ -22,6 +28,18 @@ namespace internal {
 template<typename SolverType,int Size,bool IsComplex> struct direct_selfadjoint_eigenvalues;
 template<typename MatrixType, typename DiagType, typename SubDiagType>
 ComputationInfo computeFromTridiagonal_impl(DiagType& diag, SubDiagType& subdiag, const Index maxIterations, bool computeEigenvectors, MatrixType& eivec);
+template<typename MatrixType, typename DiagType, typename SubDiagType>
+ComputationInfo tridiagonal_qr_iterations(DiagType& diag, SubDiagType& subdiag, const Index maxIterations, bool computeEigenvectors, MatrixType& eivec);
+template<typename VectorType, typename MatrixType>
+ComputationInfo tridiagonal_divide_conquer(VectorType& diag, const VectorType& subdiag, const Index maxIterations, MatrixType& eivec, Index leafSize);
+template<typename SubDiagType>
+typename SubDiagType::RealScalar tridiagonal_sturm_pivmin(const SubDiagType& subdiag);
+template<typename DiagType, typename SubDiagType>
+Index tridiagonal_sturm_count(const DiagType& diag, const SubDiagType& subdiag, typename DiagType::RealScalar x, typename DiagType::RealScalar pivmin);
+template<typename DiagType, typename SubDiagType, typename VectorType>
+void tridiagonal_bisection(const DiagType& diag, const SubDiagType& subdiag, Index first, VectorType& eivals, Matrix<Index,Dynamic,1>& blocks);
+template<typename DiagType, typename SubDiagType, typename VectorType, typename MatrixType>
+ComputationInfo tridiagonal_inverse_iteration(const DiagType& diag, const SubDiagType& subdiag, const VectorType& eivals, const Matrix<Index,Dynamic,1>& blocks, MatrixType& eivecs);
 }
 
 /** \eigenvalues_module \ingroup Eigenvalues_Module
@@ -185,6 +203,10 @@ template<typename _MatrixType> class SelfAdjointEigenSolver
       * tridiagonal matrix is then brought to diagonal form with implicit
       * symmetric QR steps with Wilkinson shift. Details can be found in
       * Section 8.3 of Golub \& Van Loan, <i>%Matrix Computations</i>.
+      * When the eigenvectors are required and the matrix has at least
+      * EIGEN_SELFADJOINT_DIVIDE_CONQUER_THRESHOLD (128 by default) columns,
+      * the tridiagonal matrix is instead diagonalized by the divide and conquer
+      * method of Cuppen, whose work mostly consists of matrix products.
       *
       * The cost of the computation is about \f$ 9n^3 \f$ if the eigenvectors
       * are required and \f$ 4n^3/3 \f$ if they are not required.
@@ -202,6 +224,56 @@ template<typename _MatrixType> class SelfAdjointEigenSolver
     EIGEN_DEVICE_FUNC
     SelfAdjointEigenSolver& compute(const EigenBase<InputType>& matrix, int options = ComputeEigenvectors);
     
+    /** \brief Computes some of the eigenvalues, given by their indices, of given matrix.
+      *
+      * \param[in]  matrix  Selfadjoint matrix whose eigendecomposition is to
+      *    be computed. Only the lower triangular part of the matrix is referenced.
+      * \param[in]  first   Index of the first eigenvalue to compute, the eigenvalues being sorted in increasing order.
+      * \param[in]  count   Number of eigenvalues to compute.
+      * \param[in]  options Can be #ComputeEigenvectors (default) or #EigenvaluesOnly.
+      * \returns    Reference to \c *this
+      *
+      * This function computes the eigenvalues of indices \p first to \p first + \p count - 1 of \p matrix, in
+      * increasing order, and their eigenvectors if \p options equals #ComputeEigenvectors. Then eigenvalues() is
+      * a vector of size \p count, and eigenvectors() a matrix of \p count columns.
+      *
+      * As in compute(), the matrix is first reduced to tridiagonal form. The selected eigenvalues of the tridiagonal
+      * matrix are then computed by bisection, and their eigenvectors by inverse iteration, before being transformed
+      * back by the Householder reflectors of the reduction. For a small number \f$ k \f$ of eigenvalues, the cost of
+      * the computation is thus about \f$ 4n^3/3 + 2n^2k \f$, and the eigenvectors take \f$ nk \f$ coefficients.
+      *
+      * This is only available for dynamic-size matrices, and the functions which need the whole eigen decomposition,
+      * like operatorSqrt(), cannot be used afterwards.
+      *
+      * \sa computeValueRange(), compute()
+      */
+    template<typename InputType>
+    SelfAdjointEigenSolver& computeIndexRange(const EigenBase<InputType>& matrix, Index first, Index count, int options = ComputeEigenvectors)
+    {
+      eigen_assert(first >= 0 && count >= 0 && first + count <= matrix.cols() && "invalid range of eigenvalues");
+      return computeRange(matrix.derived(), first, count, RealScalar(0), RealScalar(0), options);
+    }
+
+    /** \brief Computes the eigenvalues of given matrix lying in a given interval.
+      *
+      * \param[in]  matrix  Selfadjoint matrix whose eigendecomposition is to
+      *    be computed. Only the lower triangular part of the matrix is referenced.
+      * \param[in]  lower,upper The bounds of the interval \f$ [lower, upper) \f$ of the eigenvalues to compute.
+      * \param[in]  options Can be #ComputeEigenvectors (default) or #EigenvaluesOnly.
+      * \returns    Reference to \c *this
+      *
+      * This is the same as computeIndexRange(), the range of indices being the one of the eigenvalues
+      * \f$ \lambda \f$ such that \f$ lower \leq \lambda < upper \f$, which is found from Sturm sequences.
+      *
+      * \sa computeIndexRange(), compute()
+      */
+    template<typename InputType>
+    SelfAdjointEigenSolver& computeValueRange(const EigenBase<InputType>& matrix, const RealScalar& lower, const RealScalar& upper, int options = ComputeEigenvectors)
+    {
+      eigen_assert(lower <= upper && "invalid interval of eigenvalues");
+      return computeRange(matrix.derived(), -1, 0, lower, upper, options);
+    }
+
     /** \brief Computes eigendecomposition of given matrix using a closed-form algorithm
       *
       * This is a variant of compute(const MatrixType&, int options) which
@@ -307,6 +379,7 @@ template<typename _MatrixType> class SelfAdjointEigenSolver
     {
       eigen_assert(m_isInitialized && "SelfAdjointEigenSolver is not initialized.");
       eigen_assert(m_eigenvectorsOk && "The eigenvectors have not been computed together with the eigenvalues.");
+      eigen_assert(m_eivalues.size() == m_eivec.rows() && "The whole eigen decomposition has not been computed.");
       return m_eivec * m_eivalues.cwiseSqrt().asDiagonal() * m_eivec.adjoint();
     }
 
@@ -332,6 +405,7 @@ template<typename _MatrixType> class SelfAdjointEigenSolver
     {
       eigen_assert(m_isInitialized && "SelfAdjointEigenSolver is not initialized.");
       eigen_assert(m_eigenvectorsOk && "The eigenvectors have not been computed together with the eigenvalues.");
+      eigen_assert(m_eivalues.size() == m_eivec.rows() && "The whole eigen decomposition has not been computed.");
       return m_eivec * m_eivalues.cwiseInverse().cwiseSqrt().asDiagonal() * m_eivec.adjoint();
     }
 
@@ -358,6 +432,9 @@ template<typename _MatrixType> class SelfAdjointEigenSolver
     {
       EIGEN_STATIC_ASSERT_NON_INTEGER(Scalar);
     }
+
+    template<typename InputType>
+    SelfAdjointEigenSolver& computeRange(const InputType& matrix, Index first, Index count, RealScalar lower, RealScalar upper, int options);
     
     EigenvectorsType m_eivec;
     RealVectorType m_eivalues;
@@ -466,6 +543,72 @@ SelfAdjointEigenSolver<MatrixType>& SelfAdjointEigenSolver<MatrixType>
   return *this;
 }
 
+template<typename MatrixType>
+template<typename InputType>
+SelfAdjointEigenSolver<MatrixType>& SelfAdjointEigenSolver<MatrixType>
+::computeRange(const InputType& matrix, Index first, Index count, RealScalar lower, RealScalar upper, int options)
+{
+  check_template_parameters();
+  EIGEN_STATIC_ASSERT_DYNAMIC_SIZE(MatrixType)
+
+  eigen_assert(matrix.cols() == matrix.rows());
+  eigen_assert((options&~(EigVecMask|GenEigMask))==0
+          && (options&EigVecMask)!=EigVecMask
+          && "invalid option parameter");
+  bool computeEigenvectors = (options&ComputeEigenvectors)==ComputeEigenvectors;
+  Index n = matrix.cols();
+  typedef Matrix<RealScalar,Dynamic,Dynamic> RealMatrixType;
+  typedef typename TridiagonalizationType::CoeffVectorType CoeffVectorType;
+  typedef typename TridiagonalizationType::HouseholderSequenceType HouseholderSequenceType;
+
+  // map the matrix coefficients to [-1:1] to avoid over- and underflow.
+  EigenvectorsType& mat = m_eivec;
+  mat = matrix.template triangularView<Lower>();
+  RealScalar scale = mat.cwiseAbs().maxCoeff();
+  if(scale==RealScalar(0)) scale = RealScalar(1);
+  mat.template triangularView<Lower>() /= scale;
+
+  // the Householder reflectors are kept to transform back the eigenvectors of the tridiagonal matrix
+  RealVectorType diag(n);
+  m_subdiag.resize(n-1);
+  CoeffVectorType hCoeffs(n-1);
+  if(computeEigenvectors)
+  {
+    internal::tridiagonalization_inplace(mat, hCoeffs);
+    diag = mat.diagonal().real();
+    m_subdiag = mat.template diagonal<-1>().real();
+  }
+  else
+    internal::tridiagonalization_inplace(mat, diag, m_subdiag, false);
+
+  if(first < 0)
+  {
+    RealScalar pivmin = internal::tridiagonal_sturm_pivmin(m_subdiag);
+    first = internal::tridiagonal_sturm_count(diag, m_subdiag, lower / scale, pivmin);
+    count = internal::tridiagonal_sturm_count(diag, m_subdiag, upper / scale, pivmin) - first;
+  }
+  m_eivalues.resize(count);
+  Matrix<Index,Dynamic,1> blocks;
+  internal::tridiagonal_bisection(diag, m_subdiag, first, m_eivalues, blocks);
+
+  m_info = Success;
+  if(computeEigenvectors)
+  {
+    RealMatrixType eivecs;
+    m_info = internal::tridiagonal_inverse_iteration(diag, m_subdiag, m_eivalues, blocks, eivecs);
+    EigenvectorsType q = HouseholderSequenceType(mat, hCoeffs.conjugate()).setLength(n-1).setShift(1)
+                       * eivecs.template cast<Scalar>();
+    m_eivec.swap(q);
+  }
+
+  // scale back the eigen values
+  m_eivalues *= scale;
+
+  m_isInitialized = true;
+  m_eigenvectorsOk = computeEigenvectors;
+  return *this;
+}
+
 namespace internal {
 /**
   * \internal
@@ -480,6 +623,36 @@ namespace internal {
   */
 template<typename MatrixType, typename DiagType, typename SubDiagType>
 ComputationInfo computeFromTridiagonal_impl(DiagType& diag, SubDiagType& subdiag, const Index maxIterations, bool computeEigenvectors, MatrixType& eivec)
+{
+  typedef typename DiagType::RealScalar RealScalar;
+  const Index n = diag.size();
+  // the leaves of the divide and conquer tree are solved by the QR iterations
+  const Index leafSize = 32;
+
+  // the QR iterations take O(n^3) level-1 operations to update the eigenvectors
+  if (computeEigenvectors && MatrixType::ColsAtCompileTime==Dynamic
+      && n >= (std::max)(Index(EIGEN_SELFADJOINT_DIVIDE_CONQUER_THRESHOLD), 2*leafSize))
+  {
+    Matrix<RealScalar,Dynamic,1> d = diag, e = subdiag;
+    Matrix<RealScalar,Dynamic,Dynamic> z;
+    ComputationInfo info = tridiagonal_divide_conquer(d, e, maxIterations, z, leafSize);
+    if (info == Success)
+    {
+      diag = d;
+      eivec = eivec * z;
+    }
+    return info;
+  }
+  return tridiagonal_qr_iterations(diag, subdiag, maxIterations, computeEigenvectors, eivec);
+}
+
+/** \internal
+  * \brief Compute the eigendecomposition from a tridiagonal matrix by implicit symmetric QR iterations
+  *
+  * Same as computeFromTridiagonal_impl(), which calls it for the matrices which are not solved by divide and conquer.
+  */
+template<typename MatrixType, typename DiagType, typename SubDiagType>
+ComputationInfo tridiagonal_qr_iterations(DiagType& diag, SubDiagType& subdiag, const Index maxIterations, bool computeEigenvectors, MatrixType& eivec)
 {
   using std::abs;
 
@@ -494,7 +667,7 @@ ComputationInfo computeFromTridiagonal_impl(DiagType& diag, SubDiagType& subdiag
   typedef typename DiagType::RealScalar RealScalar;
   const RealScalar considerAsZero = (std::numeric_limits<RealScalar>::min)();
   const RealScalar precision = RealScalar(2)*NumTraits<RealScalar>::epsilon();
-  
+
   while (end>0)
   {
     for (Index i = start; i<end; ++i)
@@ -0,0 +1,304 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_TRIDIAGONAL_BISECTION_H
+#define EIGEN_TRIDIAGONAL_BISECTION_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal \returns the smallest pivot allowed in the Sturm sequences of the tridiagonal matrix of sub-diagonal
+  * \a subdiag, as in LAPACK's ?stebz */
+template<typename SubDiagType>
+typename SubDiagType::RealScalar tridiagonal_sturm_pivmin(const SubDiagType& subdiag)
+{
+  typedef typename SubDiagType::RealScalar RealScalar;
+  RealScalar maxSquare = subdiag.size() > 0 ? subdiag.cwiseAbs2().maxCoeff() : RealScalar(0);
+  return (std::numeric_limits<RealScalar>::min)() * (std::max)(RealScalar(1), maxSquare);
+}
+
+/** \internal \returns the number of eigenvalues smaller than \a x of the tridiagonal matrix of diagonal \a diag and
+  * sub-diagonal \a subdiag, which is the number of negative pivots of the LDL^T factorization of the matrix minus
+  * \a x times the identity, the pivots smaller than \a pivmin being replaced by \a -pivmin. */
+template<typename DiagType, typename SubDiagType>
+Index tridiagonal_sturm_count(const DiagType& diag, const SubDiagType& subdiag, typename DiagType::RealScalar x,
+                              typename DiagType::RealScalar pivmin)
+{
+  using std::abs;
+  typedef typename DiagType::RealScalar RealScalar;
+  Index count = 0;
+  RealScalar q = RealScalar(1);
+  for(Index i = 0; i < diag.size(); ++i)
+  {
+    q = diag(i) - x - (i > 0 ? numext::abs2(subdiag(i-1)) / q : RealScalar(0));
+    if(abs(q) <= pivmin)
+      q = -pivmin;
+    if(q < RealScalar(0))
+      ++count;
+  }
+  return count;
+}
+
+/** \internal \returns the sub-diagonal \a subdiag of the tridiagonal matrix of diagonal \a diag, with the negligible
+  * entries set to zero as in LAPACK's ?stebz, which splits the matrix into unreduced blocks */
+template<typename DiagType, typename SubDiagType>
+Matrix<typename DiagType::RealScalar,Dynamic,1> tridiagonal_split(const DiagType& diag, const SubDiagType& subdiag)
+{
+  using std::abs;
+  typedef typename DiagType::RealScalar RealScalar;
+  const RealScalar eps = NumTraits<RealScalar>::epsilon();
+  const Index n = diag.size();
+  Matrix<RealScalar,Dynamic,1> e = subdiag.head((std::max)(n-1, Index(0)));
+  for(Index i = 0; i < n-1; ++i)
+    if(numext::abs2(e(i)) <= eps * eps * abs(diag(i) * diag(i+1)) + (std::numeric_limits<RealScalar>::min)())
+      e(i) = RealScalar(0);
+  return e;
+}
+
+/** \internal \returns the size of the unreduced block starting at row \a start of a matrix split by tridiagonal_split() */
+template<typename SubDiagType>
+Index tridiagonal_block_size(const SubDiagType& splitSubdiag, Index start)
+{
+  Index end = start;
+  while(end < splitSubdiag.size() && splitSubdiag(end) != typename SubDiagType::RealScalar(0))
+    ++end;
+  return end - start + 1;
+}
+
+/** \internal
+  * Computes the eigenvalues of indices \a first to \a first + \a eivals.size() - 1, in increasing order, of the
+  * tridiagonal matrix of diagonal \a diag and sub-diagonal \a subdiag by bisection of the Sturm counts, starting from
+  * the Gershgorin interval of the matrix. Each eigenvalue is computed to an absolute accuracy of the order of the
+  * machine epsilon times the norm of the matrix.
+  *
+  * The matrix is split into unreduced blocks by tridiagonal_split(), and the first row of the block of each eigenvalue
+  * is stored in \a blocks, as the block indices of LAPACK's ?stebz: the rank of an eigenvalue among those of the final
+  * bisection interval tells which block it belongs to, even when several blocks share the same eigenvalue.
+  */
+template<typename DiagType, typename SubDiagType, typename VectorType>
+void tridiagonal_bisection(const DiagType& diag, const SubDiagType& subdiag, Index first, VectorType& eivals,
+                           Matrix<Index,Dynamic,1>& blocks)
+{
+  using std::abs;
+  typedef typename DiagType::RealScalar RealScalar;
+  const RealScalar eps = NumTraits<RealScalar>::epsilon();
+  const Index n = diag.size();
+  const Matrix<RealScalar,Dynamic,1> e = tridiagonal_split(diag, subdiag);
+  const RealScalar pivmin = tridiagonal_sturm_pivmin(e);
+  blocks.resize(eivals.size());
+
+  Matrix<Index,Dynamic,1> starts(n);
+  Index nbBlocks = 0;
+  for(Index start = 0; start < n; start += tridiagonal_block_size(e, start))
+    starts(nbBlocks++) = start;
+  Matrix<Index,Dynamic,1> below(nbBlocks), within(nbBlocks);
+
+  RealScalar lower = diag(0), upper = diag(0);
+  for(Index i = 0; i < n; ++i)
+  {
+    RealScalar radius = (i > 0 ? abs(e(i-1)) : RealScalar(0)) + (i < n-1 ? abs(e(i)) : RealScalar(0));
+    lower = (std::min)(lower, diag(i) - radius);
+    upper = (std::max)(upper, diag(i) + radius);
+  }
+  RealScalar tnorm = (std::max)(abs(lower), abs(upper));
+  RealScalar margin = RealScalar(2) * eps * tnorm * RealScalar(n) + RealScalar(2) * pivmin;
+  lower -= margin;
+  upper += margin;
+
+  for(Index j = 0; j < eivals.size(); ++j)
+  {
+    // the previous eigenvalue is a lower bound
+    RealScalar lo = j > 0 ? (std::max)(lower, eivals(j-1) - margin) : lower;
+    RealScalar hi = upper;
+    for(;;)
+    {
+      RealScalar mid = (lo + hi) / RealScalar(2);
+      if(mid == lo || mid == hi || hi - lo <= RealScalar(2) * eps * ((std::max)(abs(lo), abs(hi)) + tnorm))
+        break;
+      if(tridiagonal_sturm_count(diag, e, mid, pivmin) > first + j)
+        hi = mid;
+      else
+        lo = mid;
+    }
+    eivals(j) = (lo + hi) / RealScalar(2);
+
+    // the Sturm count of the split matrix is the sum of those of its blocks
+    Index rank = first + j;
+    for(Index b = 0; b < nbBlocks; ++b)
+    {
+      Index start = starts(b), size = (b+1 < nbBlocks ? starts(b+1) : n) - start;
+      below(b) = tridiagonal_sturm_count(diag.segment(start, size), e.segment(start, size-1), lo, pivmin);
+      within(b) = tridiagonal_sturm_count(diag.segment(start, size), e.segment(start, size-1), hi, pivmin) - below(b);
+      rank -= below(b);
+    }
+    blocks(j) = starts(nbBlocks-1);
+    for(Index b = 0; b < nbBlocks; ++b)
+    {
+      if(rank < within(b))
+      {
+        blocks(j) = starts(b);
+        break;
+      }
+      rank -= within(b);
+    }
+  }
+}
+
+/** \internal
+  * Computes the eigenvectors of the tridiagonal matrix of diagonal \a diag and sub-diagonal \a subdiag associated to the
+  * increasing eigenvalues \a eivals by inverse iteration, as in LAPACK's ?stein: the eigenvectors of eigenvalues
+  * closer than 10^-3 times the norm of their block are orthogonalized against each other at each iteration. Unlike
+  * ?stein, the equal eigenvalues are not perturbed, as these perturbations add up in large clusters: the
+  * eigenvectors of a cluster are told apart by their starting vectors and by the orthogonalization only.
+  *
+  * Each eigenvector is computed on the unreduced block of the split matrix of first row \a blocks, see
+  * tridiagonal_bisection(), and is zero outside of it. The eigenvectors of the blocks of size one are unit vectors.
+  *
+  * \returns \c Success, or \c NoConvergence if an eigenvector did not converge within 5 iterations, in which case
+  * the last iterate is returned.
+  */
+template<typename DiagType, typename SubDiagType, typename VectorType, typename MatrixType>
+ComputationInfo tridiagonal_inverse_iteration(const DiagType& diag, const SubDiagType& subdiag, const VectorType& eivals,
+                                              const Matrix<Index,Dynamic,1>& blocks, MatrixType& eivecs)
+{
+  using std::abs;
+  using std::sqrt;
+  typedef typename DiagType::RealScalar RealScalar;
+  typedef Matrix<RealScalar,Dynamic,1> RealVectorType;
+  const RealScalar eps = NumTraits<RealScalar>::epsilon();
+  const Index n = diag.size();
+  const Index maxIterations = 5, extraIterations = 2;
+  const RealVectorType e = tridiagonal_split(diag, subdiag);
+  ComputationInfo info = Success;
+  eivecs.setZero(n, eivals.size());
+
+  // LU factorization with partial pivoting of T - lambda I, as in LAPACK's ?lagtf: U has the diagonal a, and the two
+  // super-diagonals b and d, and the multipliers are stored in c, the rows k and k+1 being swapped if swapped(k)
+  RealVectorType a(n), b(n), c(n), d(n), x(n);
+  Matrix<bool,Dynamic,1> swapped(n);
+
+  Index clusterStart = 0;
+  for(Index j = 0; j < eivals.size(); ++j)
+  {
+    const Index s = blocks(j), m = tridiagonal_block_size(e, s);
+    if(m == 1)
+    {
+      eivecs(s, j) = RealScalar(1);
+      continue;
+    }
+
+    RealScalar onenorm = RealScalar(0);
+    for(Index i = s; i < s+m; ++i)
+      onenorm = (std::max)(onenorm, abs(diag(i)) + (i > s ? abs(e(i-1)) : RealScalar(0))
+                                                 + (i < s+m-1 ? abs(e(i)) : RealScalar(0)));
+    if(onenorm == RealScalar(0))
+      onenorm = RealScalar(1);
+    const RealScalar ortol = RealScalar(1e-3) * onenorm;
+    const RealScalar stpcrt = sqrt(RealScalar(0.1) / RealScalar(m));
+
+    RealScalar lambda = eivals(j);
+    if(j > 0 && lambda - eivals(j-1) > ortol)
+      clusterStart = j;
+
+    a.head(m) = diag.segment(s, m) - RealVectorType::Constant(m, lambda);
+    b.head(m-1) = e.segment(s, m-1);
+    c.head(m-1) = e.segment(s, m-1);
+    swapped.setConstant(false);
+    for(Index k = 0; k < m-1; ++k)
+    {
+      if(abs(a(k)) >= abs(c(k)))
+      {
+        c(k) = a(k) == RealScalar(0) ? RealScalar(0) : c(k) / a(k);
+        a(k+1) -= c(k) * b(k);
+        d(k) = RealScalar(0);
+      }
+      else
+      {
+        swapped(k) = true;
+        RealScalar mult = a(k) / c(k);
+        a(k) = c(k);
+        RealScalar tmp = a(k+1);
+        a(k+1) = b(k) - mult * tmp;
+        if(k < m-2)
+        {
+          d(k) = b(k+1);
+          b(k+1) = -mult * d(k);
+        }
+        b(k) = tmp;
+        c(k) = mult;
+      }
+    }
+    RealScalar pivotTol = eps * (std::max)(a.head(m).cwiseAbs().maxCoeff(), b.head(m-1).cwiseAbs().maxCoeff());
+    if(pivotTol == RealScalar(0))
+      pivotTol = eps;
+
+    Index converged = 0, it = 0;
+    for(; it < maxIterations && converged <= extraIterations; ++it)
+    {
+      // deterministic pseudo-random starting vector, which is also taken again if the iterate vanished or overflowed
+      RealScalar xsum = it > 0 ? x.head(m).cwiseAbs().sum() : RealScalar(0);
+      if(!(xsum > RealScalar(0) && (numext::isfinite)(xsum)))
+      {
+        for(Index i = 0; i < m; ++i)
+          x(i) = RealScalar(((i+1) * 7919 + (j + it * n) * 104729) % 2003) / RealScalar(1001) - RealScalar(1);
+        xsum = x.head(m).cwiseAbs().sum();
+      }
+      x.head(m) *= RealScalar(m) * onenorm * (std::max)(eps, abs(a(m-1))) / xsum;
+
+      // solves (T - lambda I) x = x, perturbing the small pivots
+      for(Index k = 0; k < m-1; ++k)
+      {
+        if(swapped(k))
+        {
+          RealScalar tmp = x(k);
+          x(k) = x(k+1);
+          x(k+1) = tmp - c(k) * x(k+1);
+        }
+        else
+          x(k+1) -= c(k) * x(k);
+      }
+      for(Index k = m-1; k >= 0; --k)
+      {
+        RealScalar tmp = x(k);
+        if(k < m-1) tmp -= b(k) * x(k+1);
+        if(k < m-2) tmp -= d(k) * x(k+2);
+        RealScalar pivot = a(k);
+        if(abs(pivot) < pivotTol)
+          pivot = pivot < RealScalar(0) ? -pivotTol : pivotTol;
+        x(k) = tmp / pivot;
+      }
+
+      // the eigenvectors of the other blocks are zero on this one
+      for(Index i = clusterStart; i < j; ++i)
+        x.head(m) -= eivecs.col(i).segment(s, m).dot(x.head(m)) * eivecs.col(i).segment(s, m);
+
+      // a non-finite iterate does not pass this test
+      if(!(x.head(m).cwiseAbs().maxCoeff() >= stpcrt))
+        continue;
+      ++converged;
+    }
+    RealScalar xnorm = x.head(m).norm();
+    if(converged <= extraIterations || !(xnorm > RealScalar(0) && (numext::isfinite)(xnorm)))
+    {
+      info = NoConvergence;
+      if(!(xnorm > RealScalar(0) && (numext::isfinite)(xnorm)))
+        continue;
+    }
+
+    Index jmax;
+    x.head(m).cwiseAbs().maxCoeff(&jmax);
+    eivecs.col(j).segment(s, m) = x.head(m) / (x(jmax) < RealScalar(0) ? -xnorm : xnorm);
+  }
+  return info;
+}
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_TRIDIAGONAL_BISECTION_H
@@ -0,0 +1,412 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_TRIDIAGONAL_DIVIDE_CONQUER_H
+#define EIGEN_TRIDIAGONAL_DIVIDE_CONQUER_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal \returns the first row of the node \a j of the level \a level of the divide and conquer tree of a
+  * matrix of size \a size, the nodes of a level being all of the same size up to one row. */
+inline Index tridiagonal_dc_node_start(Index size, Index level, Index j)
+{
+  return j * size / (Index(1) << level);
+}
+
+template<typename RealScalar>
+struct tridiagonal_dc_less
+{
+  tridiagonal_dc_less(const RealScalar* values) : m_values(values) {}
+  bool operator()(Index a, Index b) const { return m_values[a] < m_values[b]; }
+  const RealScalar* m_values;
+};
+
+/* Value at shift + mu of the secular function 1 + rho sum_i z2_i / (d_i - lambda), diagShifted being d - shift.
+ * If error is not null, it is set to a bound of the rounding errors of the value, as in LAPACK's ?laed4. */
+template<typename RealVectorType>
+typename RealVectorType::Scalar tridiagonal_dc_secular(const RealVectorType& z2, const RealVectorType& diagShifted,
+                                                       typename RealVectorType::Scalar rho, typename RealVectorType::Scalar mu,
+                                                       typename RealVectorType::Scalar* error = 0)
+{
+  typedef typename RealVectorType::Scalar RealScalar;
+  if(error)
+    *error = RealScalar(8) * NumTraits<RealScalar>::epsilon() * (RealScalar(1) + rho * (z2.array() / (diagShifted.array() - mu)).abs().sum());
+  return RealScalar(1) + rho * (z2.array() / (diagShifted.array() - mu)).sum();
+}
+
+/** \internal
+  * Computes the eigen decomposition of the matrix \f$ Q (D + \rho z z^T) Q^T \f$, where \f$ D \f$ is the diagonal
+  * matrix \a diag, and \f$ Q \f$ is the block diagonal matrix \a q made of the eigenvectors of the \a n1 first and of
+  * the remaining diagonal entries, as in LAPACK's ?laed1.
+  *
+  * \param[in,out] diag On input the eigenvalues of the two halves, each sorted increasingly, on output the eigenvalues
+  *                     sorted increasingly.
+  * \param[in,out] q On input the eigenvectors of the two halves, on output the eigenvectors.
+  * \param[in] n1 the size of the first half
+  * \param[in] beta the entry of the sub-diagonal which has been removed between the two halves, such that
+  *                 \f$ \rho = |\beta| \f$ and \f$ z \f$ is made of the last row of the first half of \a q and of the
+  *                 first row of the second half times the sign of \a beta.
+  *
+  * After the deflation of the small components of z and of the close eigenvalues, the eigenvalues are the roots of
+  * the secular equation \f$ 1 + \rho \sum_i z_i^2 / (d_i - \lambda) = 0 \f$, which are computed relatively to their
+  * closest pole by rational interpolation, safeguarded by bisection. The vector z is then recomputed from them as
+  * proposed by Gu and Eisenstat, so that the eigenvectors \f$ (D - \lambda I)^{-1} z \f$ are numerically orthogonal,
+  * and they are applied to \a q by two matrix products which skip the zero blocks of \a q.
+  *
+  * The secular equation of BDCSVD is the one of the singular values of an arrowhead matrix,
+  * \f$ 1 + \sum_i z_i^2 / ((d_i - \sigma)(d_i + \sigma)) = 0 \f$, with roots in \f$ [0,\infty) \f$, and its
+  * deflation, root finder and recomputation of z work in place on the members and the workspace of BDCSVD (col0,
+  * perm and the shifts and mus of each root). Hence they are not shared, and the same steps are written here for
+  * the eigenvalues of a rank-one modification, the root finder using the rational interpolation of
+  * BDCSVD::computeSingVals.
+  */
+template<typename VectorType, typename MatrixType>
+void tridiagonal_dc_merge(VectorType& diag, MatrixType& q, Index n1, typename VectorType::RealScalar beta)
+{
+  using std::abs;
+  using std::sqrt;
+  using std::swap;
+  typedef typename VectorType::RealScalar RealScalar;
+  typedef Matrix<RealScalar,Dynamic,1> RealVectorType;
+  typedef Matrix<RealScalar,Dynamic,Dynamic> RealMatrixType;
+  typedef Matrix<Index,Dynamic,1> IndicesType;
+  const RealScalar eps = NumTraits<RealScalar>::epsilon();
+  const Index n = diag.size();
+  const Index n2 = n-n1;
+
+  RealVectorType z(n);
+  z.head(n1) = q.row(n1-1).head(n1).transpose();
+  z.tail(n2) = q.row(n1).tail(n2).transpose();
+  if(beta < RealScalar(0))
+    z.tail(n2) = -z.tail(n2);
+  RealScalar znorm = z.norm();
+  RealScalar rho = abs(beta) * znorm * znorm;
+  z /= znorm;
+
+  // merge the two sorted halves, the columns of q being of type 0 (first half), 1 (both) or 2 (second half)
+  IndicesType perm(n), type(n);
+  for(Index i = 0, i1 = 0, i2 = n1; i < n; ++i)
+    perm(i) = (i2 == n || (i1 < n1 && diag(i1) <= diag(i2))) ? i1++ : i2++;
+  for(Index i = 0; i < n; ++i)
+    type(i) = i < n1 ? 0 : 2;
+  RealVectorType d(n), zp(n);
+  for(Index i = 0; i < n; ++i)
+  {
+    d(i) = diag(perm(i));
+    zp(i) = z(perm(i));
+  }
+
+  // deflation, as in LAPACK's ?laed2
+  const RealScalar tol = RealScalar(8) * eps * (std::max)(d.cwiseAbs().maxCoeff(), zp.cwiseAbs().maxCoeff());
+  IndicesType nondeflated(n), deflated(n);
+  Index k = 0, nbDeflated = 0, prev = -1;
+  for(Index i = 0; i < n; ++i)
+  {
+    if(rho * abs(zp(i)) <= tol)
+    {
+      deflated(nbDeflated++) = i;
+      continue;
+    }
+    if(prev >= 0)
+    {
+      RealScalar tau = numext::hypot(zp(prev), zp(i));
+      RealScalar c = zp(prev) / tau, s = zp(i) / tau;
+      if(abs((d(i) - d(prev)) * c * s) <= tol)
+      {
+        // rotates the two columns such that only the second one has a non-zero component in z
+        RealVectorType tmp = q.col(perm(prev));
+        q.col(perm(prev)) = s * tmp - c * q.col(perm(i));
+        q.col(perm(i)) = c * tmp + s * q.col(perm(i));
+        RealScalar dprev = s * s * d(prev) + c * c * d(i);
+        d(i) = c * c * d(prev) + s * s * d(i);
+        d(prev) = dprev;
+        zp(prev) = RealScalar(0);
+        zp(i) = tau;
+        if(type(perm(prev)) != type(perm(i)))
+          type(perm(prev)) = type(perm(i)) = 1;
+        deflated(nbDeflated++) = prev;
+        prev = i;
+        continue;
+      }
+      nondeflated(k++) = prev;
+    }
+    prev = i;
+  }
+  if(prev >= 0)
+    nondeflated(k++) = prev;
+
+  // roots of the secular equation, each of them as mu(j) + dk(shift(j))
+  RealVectorType dk(k), zk(k), mu(k);
+  IndicesType shift(k);
+  for(Index i = 0; i < k; ++i)
+  {
+    dk(i) = d(nondeflated(i));
+    zk(i) = zp(nondeflated(i));
+  }
+  RealVectorType zk2 = zk.cwiseAbs2();
+  RealVectorType diagShifted(k);
+  for(Index j = 0; j < k; ++j)
+  {
+    RealScalar lo, hi;
+    if(j < k-1)
+    {
+      RealScalar mid = (dk(j+1) - dk(j)) / RealScalar(2);
+      diagShifted = dk.array() - dk(j);
+      RealScalar fmid = tridiagonal_dc_secular(zk2, diagShifted, rho, mid);
+      if(fmid >= RealScalar(0))
+      {
+        shift(j) = j;
+        lo = RealScalar(0);
+        hi = mid;
+      }
+      else
+      {
+        shift(j) = j+1;
+        diagShifted = dk.array() - dk(j+1);
+        lo = -mid;
+        hi = RealScalar(0);
+      }
+    }
+    else
+    {
+      shift(j) = j;
+      diagShifted = dk.array() - dk(j);
+      lo = RealScalar(0);
+      hi = rho * zk2.sum();
+    }
+
+    // rational interpolation as in BDCSVD::computeSingVals: the next iterate is the zero of the function a / mu + b
+    // matching the secular function at the two previous iterates. The secular function being increasing between two
+    // poles, each evaluation narrows the interval [lo,hi] of the root, and a bisection step is taken instead when the
+    // interpolated iterate leaves it or when the previous interpolation step did not halve |f|. The iteration stops
+    // once |f| is below its rounding errors, or once the interval cannot be narrowed anymore.
+    RealScalar muCur = shift(j) == j ? hi : lo;
+    RealScalar muPrev = RealScalar(0.2) * muCur;
+    RealScalar errCur, errPrev;
+    RealScalar fCur = tridiagonal_dc_secular(zk2, diagShifted, rho, muCur, &errCur);
+    RealScalar fPrev = tridiagonal_dc_secular(zk2, diagShifted, rho, muPrev, &errPrev);
+    if(fPrev < RealScalar(0))
+      lo = muPrev;
+    else
+      hi = muPrev;
+    if(abs(fPrev) < abs(fCur))
+    {
+      swap(fPrev, fCur);
+      swap(muPrev, muCur);
+      swap(errPrev, errCur);
+    }
+    bool interpolate = true;
+    while(abs(fCur) > errCur && hi - lo > RealScalar(2) * eps * (std::max)(abs(lo), abs(hi)))
+    {
+      RealScalar muNext = (lo + hi) / RealScalar(2);
+      bool interpolated = false;
+      if(interpolate)
+      {
+        RealScalar a = (fCur - fPrev) / (RealScalar(1) / muCur - RealScalar(1) / muPrev);
+        RealScalar b = fCur - a / muCur;
+        RealScalar muZero = -a / b;
+        if(muZero > lo && muZero < hi)
+        {
+          muNext = muZero;
+          interpolated = true;
+        }
+      }
+      if(muNext == lo || muNext == hi)
+        break;
+      RealScalar errNext;
+      RealScalar fNext = tridiagonal_dc_secular(zk2, diagShifted, rho, muNext, &errNext);
+      if(fNext < RealScalar(0))
+        lo = muNext;
+      else
+        hi = muNext;
+      interpolate = !interpolated || abs(fNext) <= abs(fCur) / RealScalar(2);
+      muPrev = muCur;
+      fPrev = fCur;
+      muCur = muNext;
+      fCur = fNext;
+      errCur = errNext;
+    }
+    mu(j) = muCur;
+  }
+
+  // Gu and Eisenstat's recomputation of z, and eigenvectors of the rank-one modification
+  RealMatrixType v(k, k);
+  for(Index i = 0; i < k; ++i)
+  {
+    RealScalar prod = (dk(shift(k-1)) - dk(i) + mu(k-1)) / rho;
+    for(Index j = 0; j < i; ++j)
+      prod *= (dk(shift(j)) - dk(i) + mu(j)) / (dk(j) - dk(i));
+    for(Index j = i; j < k-1; ++j)
+      prod *= (dk(shift(j)) - dk(i) + mu(j)) / (dk(j+1) - dk(i));
+    RealScalar zhat = sqrt(abs(prod));
+    zk(i) = zk(i) < RealScalar(0) ? -zhat : zhat;
+  }
+  for(Index j = 0; j < k; ++j)
+  {
+    for(Index i = 0; i < k; ++i)
+      v(i,j) = zk(i) / ((dk(i) - dk(shift(j))) - mu(j));
+    v.col(j).normalize();
+  }
+
+  // products by the non-deflated columns of q, ordered by type to skip their zero blocks
+  IndicesType count = IndicesType::Zero(3);
+  for(Index i = 0; i < k; ++i)
+    ++count(type(perm(nondeflated(i))));
+  IndicesType pos(3);
+  pos << 0, count(0), count(0) + count(1);
+  RealMatrixType qk(n, k), vk(k, k);
+  for(Index i = 0; i < k; ++i)
+  {
+    Index c = pos(type(perm(nondeflated(i))))++;
+    qk.col(c) = q.col(perm(nondeflated(i)));
+    vk.row(c) = v.row(i);
+  }
+  RealMatrixType res(n, k);
+  res.topRows(n1).noalias() = qk.topLeftCorner(n1, count(0) + count(1)) * vk.topRows(count(0) + count(1));
+  res.bottomRows(n2).noalias() = qk.bottomRightCorner(n2, count(1) + count(2)) * vk.bottomRows(count(1) + count(2));
+
+  // sorted eigenvalues and eigenvectors, the deflated ones being left unchanged
+  RealVectorType values(n);
+  for(Index j = 0; j < k; ++j)
+    values(j) = dk(shift(j)) + mu(j);
+  for(Index i = 0; i < nbDeflated; ++i)
+    values(k+i) = d(deflated(i));
+  IndicesType order(n);
+  for(Index i = 0; i < n; ++i)
+    order(i) = i;
+  std::sort(order.data(), order.data() + n, tridiagonal_dc_less<RealScalar>(values.data()));
+
+  RealMatrixType deflatedVectors(n, nbDeflated);
+  for(Index i = 0; i < nbDeflated; ++i)
+    deflatedVectors.col(i) = q.col(perm(deflated(i)));
+  for(Index i = 0; i < n; ++i)
+  {
+    diag(i) = values(order(i));
+    if(order(i) < k)
+      q.col(i) = res.col(order(i));
+    else
+      q.col(i) = deflatedVectors.col(order(i) - k);
+  }
+}
+
+template<typename VectorType, typename MatrixType>
+struct tridiagonal_dc_leaf
+{
+  typedef typename VectorType::RealScalar RealScalar;
+
+  tridiagonal_dc_leaf(VectorType& diag, const VectorType& subdiag, MatrixType& eivec, Index levels, Index maxIterations,
+                      Matrix<int,Dynamic,1>& info)
+    : m_diag(diag), m_subdiag(subdiag), m_eivec(eivec), m_levels(levels), m_maxIterations(maxIterations), m_info(info)
+  {}
+
+  void operator()(Index j) const
+  {
+    Index n = m_diag.size();
+    Index start = tridiagonal_dc_node_start(n, m_levels, j);
+    Index size = tridiagonal_dc_node_start(n, m_levels, j+1) - start;
+    Matrix<RealScalar,Dynamic,1> d = m_diag.segment(start, size);
+    Matrix<RealScalar,Dynamic,1> e = m_subdiag.segment(start, size-1);
+    Matrix<RealScalar,Dynamic,Dynamic> q = Matrix<RealScalar,Dynamic,Dynamic>::Identity(size, size);
+    m_info(j) = tridiagonal_qr_iterations(d, e, m_maxIterations, true, q);
+    m_diag.segment(start, size) = d;
+    m_eivec.block(start, start, size, size) = q;
+  }
+
+  VectorType& m_diag;
+  const VectorType& m_subdiag;
+  MatrixType& m_eivec;
+  Index m_levels, m_maxIterations;
+  Matrix<int,Dynamic,1>& m_info;
+};
+
+template<typename VectorType, typename MatrixType>
+struct tridiagonal_dc_node
+{
+  tridiagonal_dc_node(VectorType& diag, const VectorType& subdiag, MatrixType& eivec, Index level)
+    : m_diag(diag), m_subdiag(subdiag), m_eivec(eivec), m_level(level)
+  {}
+
+  void operator()(Index j) const
+  {
+    Index n = m_diag.size();
+    Index start = tridiagonal_dc_node_start(n, m_level, j);
+    Index size = tridiagonal_dc_node_start(n, m_level, j+1) - start;
+    Index n1 = tridiagonal_dc_node_start(n, m_level+1, 2*j+1) - start;
+    typename VectorType::SegmentReturnType diag(m_diag, start, size);
+    Block<MatrixType> q(m_eivec, start, start, size, size);
+    tridiagonal_dc_merge(diag, q, n1, m_subdiag(start+n1-1));
+  }
+
+  VectorType& m_diag;
+  const VectorType& m_subdiag;
+  MatrixType& m_eivec;
+  Index m_level;
+};
+
+/** \internal
+  * \brief Computes the eigen decomposition of a symmetric tridiagonal matrix by divide and conquer
+  *
+  * \param[in,out] diag On input the diagonal of the matrix, on output the eigenvalues sorted increasingly
+  * \param[in] subdiag The sub-diagonal of the matrix
+  * \param[in] maxIterations The maximum number of iterations of the QR algorithm for the smallest subproblems
+  * \param[out] eivec The eigenvectors
+  * \param[in] leafSize The size under which the subproblems are solved with the QR algorithm
+  * \returns \c Success or \c NoConvergence
+  *
+  * The matrix is split as in Cuppen's method into a tree of subproblems of equal sizes, each of them being the sum
+  * of the two tridiagonal matrices below it and of a rank-one modification, see tridiagonal_dc_merge(). The smallest
+  * subproblems, and then the subproblems of each level of the tree, are solved concurrently when multi-threading is
+  * enabled, the products of the largest ones being parallelized in turn.
+  */
+template<typename VectorType, typename MatrixType>
+ComputationInfo tridiagonal_divide_conquer(VectorType& diag, const VectorType& subdiag, const Index maxIterations,
+                                           MatrixType& eivec, Index leafSize)
+{
+  typedef typename VectorType::RealScalar RealScalar;
+  const Index n = diag.size();
+  eivec.setZero(n, n);
+
+  // map the coefficients to [-1:1] to avoid over- and underflow
+  RealScalar scale = (std::max)(diag.cwiseAbs().maxCoeff(), n > 1 ? subdiag.head(n-1).cwiseAbs().maxCoeff() : RealScalar(0));
+  if(scale == RealScalar(0))
+    scale = RealScalar(1);
+  VectorType e = subdiag / scale;
+  diag /= scale;
+
+  Index levels = 0;
+  while((n >> levels) > leafSize)
+    ++levels;
+
+  // removes the sub-diagonal entries between the nodes from the diagonal entries around them
+  for(Index l = 0; l < levels; ++l)
+    for(Index j = 0; j < (Index(1) << l); ++j)
+    {
+      Index split = tridiagonal_dc_node_start(n, l+1, 2*j+1);
+      RealScalar beta = numext::abs(e(split-1));
+      diag(split-1) -= beta;
+      diag(split) -= beta;
+    }
+
+  Matrix<int,Dynamic,1> info(Index(1) << levels);
+  parallel_for(tridiagonal_dc_leaf<VectorType,MatrixType>(diag, e, eivec, levels, maxIterations, info), info.size());
+  if((info.array() != int(Success)).any())
+    return NoConvergence;
+
+  for(Index l = levels-1; l >= 0; --l)
+    parallel_for(tridiagonal_dc_node<VectorType,MatrixType>(diag, e, eivec, l), Index(1) << l);
+
+  diag *= scale;
+  return Success;
+}
+
+} // end namespace internal
+
+} // end namespace Eigen
+
+#endif // EIGEN_TRIDIAGONAL_DIVIDE_CONQUER_H
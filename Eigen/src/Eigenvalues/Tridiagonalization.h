@@ -11,6 +11,12 @@
 #ifndef EIGEN_TRIDIAGONALIZATION_H
 #define EIGEN_TRIDIAGONALIZATION_H
 
+/** \internal size from which the tridiagonalization of SelfAdjointEigenSolver is performed in two stages when the
+  * eigenvectors are not requested, see internal::tridiagonalization_two_stage_inplace() */
+#ifndef EIGEN_TRIDIAGONALIZATION_TWO_STAGE_THRESHOLD
+#define EIGEN_TRIDIAGONALIZATION_TWO_STAGE_THRESHOLD 768
+#endif
+
 namespace Eigen { 
 
 namespace internal {
@@ -377,6 +383,167 @@ void tridiagonalization_inplace(MatrixType& matA, CoeffVectorType& hCoeffs)
   }
 }
 
+/** \internal
+  * Reduces the selfadjoint matrix \a matA in-place to a band matrix of \a bandwidth sub-diagonals, which is the first
+  * stage of the two-stage tridiagonalization.
+  *
+  * \param[in,out] matA On input the selfadjoint matrix. Only the \b lower triangular part is referenced.
+  *                     On output, the band matrix B is stored in the \a bandwidth first sub-diagonals of the lower
+  *                     triangular part, and the Householder vectors of Q below them, in the same packed format as
+  *                     tridiagonalization_inplace(matA,hCoeffs) with a shift of \a bandwidth instead of 1.
+  * \param[out]    hCoeffs returned Householder coefficients, of size matA.rows()-bandwidth-1
+  *
+  * The columns are reduced by panels of \a bandwidth columns: the QR decomposition of the part of the panel below the
+  * band gives a block reflector \f$ Q = I - V T V^* \f$ which is applied to both sides of the trailing matrix with
+  * level-3 products as \f$ A - V W^* - W V^* \f$, where \f$ W = X - \frac{1}{2} V T^* V^* X \f$ and \f$ X = A V T \f$.
+  */
+template<typename MatrixType, typename CoeffVectorType>
+void tridiagonalization_band_inplace(MatrixType& matA, CoeffVectorType& hCoeffs, Index bandwidth)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrixType;
+  typedef Block<MatrixType,Dynamic,Dynamic> BlockType;
+  typedef typename CoeffVectorType::SegmentReturnType CoeffsSegmentType;
+  Index n = matA.rows();
+  Index reduced = (std::max)(n-bandwidth-1, Index(0));
+  eigen_assert(n==matA.cols() && hCoeffs.size()==reduced);
+
+  for(Index k = 0; k < reduced; k += bandwidth)
+  {
+    Index bs = (std::min)(bandwidth, reduced-k);   // actual size of the panel
+    Index r = k+bandwidth;                         // first row below the band
+    Index m = n-r;
+
+    BlockType panel(matA, r, k, m, bs);
+    CoeffsSegmentType coeffs = hCoeffs.segment(k, bs);
+    householder_qr_inplace_unblocked(panel, coeffs);
+
+    DenseMatrixType V = panel.template triangularView<UnitLower>();
+    Matrix<Scalar,Dynamic,Dynamic,RowMajor> T(bs, bs);
+    make_block_householder_triangular_factor(T, V, coeffs.conjugate());
+
+    BlockType A22(matA, r, r, m, m);
+    DenseMatrixType W = A22.template selfadjointView<Lower>() * (V * T.template triangularView<Upper>());
+    DenseMatrixType M = T.template triangularView<Upper>().adjoint() * (V.adjoint() * W);
+    W.noalias() -= RealScalar(0.5) * V * M;
+    A22.template triangularView<Lower>() -= V * W.adjoint();
+    A22.template triangularView<Lower>() -= W * V.adjoint();
+
+    // the remaining columns of the last panel, the entries of which are within the band
+    if(bs < bandwidth)
+    {
+      BlockType A21(matA, r, k+bs, m, bandwidth-bs);
+      apply_block_householder_on_the_left(A21, panel, coeffs, false);
+    }
+  }
+}
+
+/** \internal \returns the block of size \a rows x \a cols starting at (\a i, \a j) of the band matrix stored in \a band,
+  * where the coefficient (i,j) lies at (bandwidth+i-j, j), as a matrix of outer stride band.outerStride()-1. */
+template<typename BandType>
+Map<Matrix<typename BandType::Scalar,Dynamic,Dynamic>,0,OuterStride<> >
+tridiagonalization_band_block(BandType& band, Index bandwidth, Index i, Index j, Index rows, Index cols)
+{
+  return Map<Matrix<typename BandType::Scalar,Dynamic,Dynamic>,0,OuterStride<> >(
+           band.data() + (bandwidth+i-j) + j*band.outerStride(), rows, cols, OuterStride<>(band.outerStride()-1));
+}
+
+/** \internal
+  * Performs a full tridiagonalization in place in two stages, see tridiagonalization_inplace(mat,diag,subdiag,extractQ).
+  *
+  * The first stage reduces \a mat to a band matrix with tridiagonalization_band_inplace(). The second one reduces the
+  * band matrix to tridiagonal form by chasing the bulges created by each Householder reflector down the band, as in
+  * LAPACK's ?sytrd_sb2st: for each column, a reflector annihilates its entries below the sub-diagonal and is applied
+  * to both sides of the next diagonal block, which creates a bulge in the block below the latter; only the first column
+  * of the bulge is annihilated by the next reflector, the remaining of it being annihilated by the next sweeps.
+  * The band matrix is kept in a compact storage with room for \a bandwidth super-diagonals, and for the bulges below
+  * the band, so that any of these blocks is a strided matrix.
+  *
+  * This takes O(n^2 \a bandwidth) operations for the second stage, instead of the O(n^3) memory bound level-2
+  * operations of the one-stage tridiagonalization, the cubic part of the work being done by level-3 products.
+  * When \a extractQ is true, the reflectors of the second stage are however applied one by one to Q, in O(n^3).
+  */
+template<typename MatrixType, typename DiagonalType, typename SubDiagonalType>
+void tridiagonalization_two_stage_inplace(MatrixType& mat, DiagonalType& diag, SubDiagonalType& subdiag, bool extractQ, Index bandwidth)
+{
+  using numext::conj;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrixType;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef Map<DenseMatrixType,0,OuterStride<> > BandBlockType;
+  const Index n = mat.rows();
+  const Index b = bandwidth;
+
+  VectorType hCoeffs((std::max)(n-b-1, Index(0)));
+  tridiagonalization_band_inplace(mat, hCoeffs, b);
+
+  DenseMatrixType band = DenseMatrixType::Zero(3*b+1, n);
+  for(Index j = 0; j < n; ++j)
+  {
+    Index len = (std::min)(b+1, n-j);
+    band.col(j).segment(b, len) = mat.col(j).segment(j, len);
+  }
+
+  if(extractQ)
+  {
+    // the in-place evaluation of a HouseholderSequence assumes that the shift is at most 1
+    DenseMatrixType q = HouseholderSequence<MatrixType,typename internal::remove_all<typename VectorType::ConjugateReturnType>::type>
+                          (mat, hCoeffs.conjugate())
+                        .setLength(hCoeffs.size())
+                        .setShift(b);
+    mat = q;
+  }
+
+  // applyHouseholderOnTheRight(essential,tau) multiplies by I - tau conj(v) v^T, hence the conjugates to apply H^*
+  VectorType essential(b), workspace(n);
+  for(Index i = 0; i < n-1; ++i)
+  {
+    // annihilates the column i below its sub-diagonal
+    Index st = i+1, len = (std::min)(b, n-st);
+    Scalar tau;
+    RealScalar beta;
+    {
+      BandBlockType col = tridiagonalization_band_block(band, b, st, i, len, 1);
+      col.col(0).makeHouseholderInPlace(tau, beta);
+      essential.head(len-1) = col.col(0).tail(len-1);
+      col(0,0) = beta;
+      col.col(0).tail(len-1).setZero();
+    }
+
+    for(;;)
+    {
+      // two-sided application to the diagonal block, after having restored its upper part
+      BandBlockType diagBlock = tridiagonalization_band_block(band, b, st, st, len, len);
+      for(Index c = 1; c < len; ++c)
+        diagBlock.col(c).head(c) = diagBlock.row(c).head(c).adjoint();
+      diagBlock.applyHouseholderOnTheLeft(essential.head(len-1), tau, workspace.data());
+      diagBlock.applyHouseholderOnTheRight(essential.head(len-1).conjugate(), conj(tau), workspace.data());
+      if(extractQ)
+        mat.middleCols(st, len).applyHouseholderOnTheRight(essential.head(len-1).conjugate(), conj(tau), workspace.data());
+
+      // application to the block below, and annihilation of the first column of the bulge
+      Index next = st+len;
+      if(next >= n)
+        break;
+      Index nextLen = (std::min)(b, n-next);
+      BandBlockType bulge = tridiagonalization_band_block(band, b, next, st, nextLen, len);
+      bulge.applyHouseholderOnTheRight(essential.head(len-1).conjugate(), conj(tau), workspace.data());
+      bulge.col(0).makeHouseholderInPlace(tau, beta);
+      essential.head(nextLen-1) = bulge.col(0).tail(nextLen-1);
+      bulge(0,0) = beta;
+      bulge.col(0).tail(nextLen-1).setZero();
+      bulge.rightCols(len-1).applyHouseholderOnTheLeft(essential.head(nextLen-1), tau, workspace.data());
+      st = next;
+      len = nextLen;
+    }
+  }
+
+  diag = band.row(b).real().transpose();
+  subdiag = band.row(b+1).head(n-1).real().transpose();
+}
+
 // forward declaration, implementation at the end of this file
 template<typename MatrixType,
          int Size=MatrixType::ColsAtCompileTime,
@@ -441,6 +608,13 @@ struct tridiagonalization_inplace_selector
   template<typename DiagonalType, typename SubDiagonalType>
   static void run(MatrixType& mat, DiagonalType& diag, SubDiagonalType& subdiag, bool extractQ)
   {
+    // the accumulation of the reflectors of the second stage is level-2, which makes the two-stage reduction slower
+    // than the one-stage one when Q is extracted
+    if(Size==Dynamic && !extractQ && mat.rows() >= EIGEN_TRIDIAGONALIZATION_TWO_STAGE_THRESHOLD)
+    {
+      tridiagonalization_two_stage_inplace(mat, diag, subdiag, false, 32);
+      return;
+    }
     CoeffVectorType hCoeffs(mat.cols()-1);
     tridiagonalization_inplace(mat,hCoeffs);
     diag = mat.diagonal().real();
@@ -0,0 +1,360 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_MIXED_PRECISION_SOLVER_H
+#define EIGEN_MIXED_PRECISION_SOLVER_H
+
+namespace Eigen {
+
+template<typename _MatrixType, typename _Decomposition> class MixedPrecisionSolver;
+
+namespace internal {
+
+/* The scalar type in which the factorization of a matrix of scalar type T is computed */
+template<typename T> struct mixed_precision_scalar;
+template<> struct mixed_precision_scalar<double> { typedef float type; };
+template<> struct mixed_precision_scalar<std::complex<double> > { typedef std::complex<float> type; };
+
+template<typename MatrixType> struct mixed_precision_matrix
+{
+  typedef Matrix<typename mixed_precision_scalar<typename MatrixType::Scalar>::type,
+                 MatrixType::RowsAtCompileTime, MatrixType::ColsAtCompileTime, MatrixType::Options,
+                 MatrixType::MaxRowsAtCompileTime, MatrixType::MaxColsAtCompileTime> type;
+};
+
+/* The decomposition of the same kind as Decomposition working on MatrixType, used as the fallback */
+template<typename Decomposition, typename MatrixType> struct mixed_precision_fallback;
+template<typename LowMatrixType, typename MatrixType>
+struct mixed_precision_fallback<PartialPivLU<LowMatrixType>, MatrixType> { typedef PartialPivLU<MatrixType> type; };
+template<typename LowMatrixType, int UpLo, typename MatrixType>
+struct mixed_precision_fallback<LLT<LowMatrixType,UpLo>, MatrixType> { typedef LLT<MatrixType,UpLo> type; };
+template<typename LowMatrixType, int UpLo, typename MatrixType>
+struct mixed_precision_fallback<LDLT<LowMatrixType,UpLo>, MatrixType> { typedef LDLT<MatrixType,UpLo> type; };
+
+/* PartialPivLU does not report failures: they show up as non-finite iterates during the refinement */
+template<typename MatrixType>
+ComputationInfo mixed_precision_info(const PartialPivLU<MatrixType>&) { return Success; }
+template<typename MatrixType, int UpLo>
+ComputationInfo mixed_precision_info(const LLT<MatrixType,UpLo>& dec) { return dec.info(); }
+template<typename MatrixType, int UpLo>
+ComputationInfo mixed_precision_info(const LDLT<MatrixType,UpLo>& dec) { return dec.info(); }
+
+template<typename _MatrixType, typename _Decomposition>
+struct traits<MixedPrecisionSolver<_MatrixType,_Decomposition> >
+ : traits<_MatrixType>
+{
+  typedef MatrixXpr XprKind;
+  typedef SolverStorage StorageKind;
+  typedef traits<_MatrixType> BaseTraits;
+  enum {
+    Flags = BaseTraits::Flags & RowMajorBit,
+    CoeffReadCost = Dynamic
+  };
+};
+
+} // end namespace internal
+
+/** \ingroup LU_Module
+  *
+  * \class MixedPrecisionSolver
+  *
+  * \brief Linear solver factorizing in single precision and refining the solution in double precision
+  *
+  * \tparam _MatrixType the type of the matrix A of the system Ax=b, of scalar type \c double or \c std::complex<double>
+  * \tparam _Decomposition the decomposition used in low precision: a PartialPivLU (the default), or a LLT or a LDLT
+  *                        for selfadjoint positive (semi-)definite matrices, of a matrix of scalar type \c float or
+  *                        \c std::complex<float>
+  *
+  * This class solves a square system Ax=b to the accuracy of a double precision factorization of A, while only
+  * factorizing A in single precision. The O(n^3) factorization then runs at the speed of the single precision
+  * matrix products, about twice as fast as in double precision, and each solve refines the single precision
+  * solution x by the classical iterative refinement
+  * \f[ r = b - Ax, \quad x \leftarrow x + \tilde A^{-1} r \f]
+  * where the residual \c r is computed in double precision, and \f$ \tilde A^{-1} \f$ applies the single
+  * precision factorization, at a cost of O(n^2) per iteration.
+  *
+  * The refinement stops when, for each column of b, \f$ \| r \|_\infty \le \epsilon \sqrt{n} \| A \|_\infty \| x \|_\infty \f$
+  * where \f$ \epsilon \f$ is the tolerance(), which is the criterion of LAPACK's dsgesv. It converges as long as A
+  * is not too ill-conditioned for single precision, say when \f$ \kappa(A) \ll 10^7 \f$. Otherwise the refinement
+  * stalls or diverges, and the solver falls back to a double precision factorization of A, which is then used by
+  * all the subsequent solves. The solver also falls back when the single precision LLT or LDLT factorization fails.
+  * A and the residuals are scaled before their conversion to single precision, so that their magnitudes do not
+  * matter as long as the dynamic range of their coefficients fits in single precision.
+  *
+  * \code
+  * MixedPrecisionSolver<MatrixXd> solver(A);
+  * VectorXd x = solver.solve(b);
+  * std::cout << solver.iterations() << " refinement steps, fallback: " << solver.usesFallback() << "\n";
+  * \endcode
+  *
+  * Since the refinement needs the residuals in double precision, the solver keeps a copy of A, and its memory
+  * footprint is one and a half times that of a double precision factorization.
+  *
+  * \warning Because of the fallback, solve() updates the state of the solver, and must not be called concurrently
+  * on the same object.
+  *
+  * \sa class PartialPivLU, class LLT
+  */
+template<typename _MatrixType, typename _Decomposition = PartialPivLU<typename internal::mixed_precision_matrix<_MatrixType>::type> >
+class MixedPrecisionSolver
+  : public SolverBase<MixedPrecisionSolver<_MatrixType,_Decomposition> >
+{
+  public:
+
+    typedef _MatrixType MatrixType;
+    typedef _Decomposition Decomposition;
+    typedef SolverBase<MixedPrecisionSolver> Base;
+    EIGEN_GENERIC_PUBLIC_INTERFACE(MixedPrecisionSolver)
+    enum {
+      MaxRowsAtCompileTime = MatrixType::MaxRowsAtCompileTime,
+      MaxColsAtCompileTime = MatrixType::MaxColsAtCompileTime
+    };
+    typedef typename MatrixType::PlainObject PlainObject;
+    typedef typename Decomposition::Scalar LowScalar;
+    typedef typename NumTraits<LowScalar>::Real LowRealScalar;
+    typedef typename internal::mixed_precision_fallback<Decomposition,PlainObject>::type FallbackDecomposition;
+
+    /** \brief Default Constructor.
+      *
+      * The default constructor is useful in cases in which the user intends to
+      * perform decompositions via MixedPrecisionSolver::compute(const MatrixType&).
+      */
+    MixedPrecisionSolver()
+      : m_matrix(), m_normInf(0), m_scale(1), m_tolerance(NumTraits<RealScalar>::epsilon()), m_maxIterations(30),
+        m_iterations(0), m_error(0), m_info(Success), m_usesFallback(false), m_isInitialized(false)
+    {}
+
+    /** Constructor.
+      *
+      * \param matrix the square matrix A of the systems to solve.
+      */
+    template<typename InputType>
+    explicit MixedPrecisionSolver(const EigenBase<InputType>& matrix)
+      : m_matrix(), m_normInf(0), m_scale(1), m_tolerance(NumTraits<RealScalar>::epsilon()), m_maxIterations(30),
+        m_iterations(0), m_error(0), m_info(Success), m_usesFallback(false), m_isInitialized(false)
+    {
+      compute(matrix.derived());
+    }
+
+    /** Computes the single precision factorization of \a matrix, or its double precision factorization if
+      * the single precision factorization fails.
+      */
+    template<typename InputType>
+    MixedPrecisionSolver& compute(const EigenBase<InputType>& matrix);
+
+    /** \returns the solution x of Ax=b, refined to double precision accuracy.
+      *
+      * \param b the right-hand-side of the equation to solve. Can be a vector or a matrix, whose columns are
+      *          refined together.
+      *
+      * \sa iterations(), error(), usesFallback()
+      */
+    template<typename Rhs>
+    inline const Solve<MixedPrecisionSolver, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_isInitialized && "MixedPrecisionSolver is not initialized.");
+      return Solve<MixedPrecisionSolver, Rhs>(*this, b.derived());
+    }
+
+    /** \brief Reports whether the last computation was successful.
+      *
+      * \returns \c Success if the last solve converged, \c NumericalIssue if the double precision factorization
+      *          used as a fallback failed.
+      */
+    ComputationInfo info() const
+    {
+      eigen_assert(m_isInitialized && "MixedPrecisionSolver is not initialized.");
+      return m_info;
+    }
+
+    /** \returns the number of refinement steps of the last solve, 0 if it used the fallback factorization */
+    Index iterations() const
+    {
+      eigen_assert(m_isInitialized && "MixedPrecisionSolver is not initialized.");
+      return m_iterations;
+    }
+
+    /** \returns the largest relative residual \f$ \| r \|_\infty / (\| A \|_\infty \| x \|_\infty) \f$
+      * over the columns of the solution of the last solve */
+    RealScalar error() const
+    {
+      eigen_assert(m_isInitialized && "MixedPrecisionSolver is not initialized.");
+      return m_error;
+    }
+
+    /** \returns true if the solver uses the double precision factorization of A */
+    bool usesFallback() const
+    {
+      eigen_assert(m_isInitialized && "MixedPrecisionSolver is not initialized.");
+      return m_usesFallback;
+    }
+
+    /** \returns the tolerance of the stopping criterion, the machine epsilon of \c double by default */
+    RealScalar tolerance() const { return m_tolerance; }
+
+    /** Sets the tolerance of the stopping criterion of the refinement, see the class documentation. */
+    MixedPrecisionSolver& setTolerance(const RealScalar& tolerance)
+    {
+      m_tolerance = tolerance;
+      return *this;
+    }
+
+    /** \returns the maximal number of refinement steps before falling back, 30 by default */
+    Index maxIterations() const { return m_maxIterations; }
+
+    /** Sets the maximal number of refinement steps before the solver falls back to a double precision
+      * factorization. */
+    MixedPrecisionSolver& setMaxIterations(Index maxIterations)
+    {
+      m_maxIterations = maxIterations;
+      return *this;
+    }
+
+    /** \returns the single precision decomposition of A divided by its infinity norm, only meaningful if
+      * usesFallback() is false */
+    const Decomposition& decomposition() const { return m_decomposition; }
+
+    inline Index rows() const { return m_matrix.rows(); }
+    inline Index cols() const { return m_matrix.cols(); }
+
+    #ifndef EIGEN_PARSED_BY_DOXYGEN
+    template<typename RhsType, typename DstType>
+    void _solve_impl(const RhsType &rhs, DstType &dst) const;
+    #endif
+
+  protected:
+
+    static void check_template_parameters()
+    {
+      EIGEN_STATIC_ASSERT_NON_INTEGER(Scalar);
+    }
+
+    void fallback() const
+    {
+      m_fallback.compute(m_matrix);
+      m_usesFallback = true;
+    }
+
+    /* Returns the largest relative residual of the columns of x, and stores the residual b-Ax in r */
+    template<typename RhsType, typename DstType, typename ResidualType>
+    RealScalar residual(const RhsType& b, const DstType& x, ResidualType& r) const
+    {
+      r = b;
+      r.noalias() -= m_matrix * x;
+      RealScalar error(0);
+      for(Index j = 0; j < r.cols(); ++j)
+      {
+        RealScalar rnorm = r.col(j).cwiseAbs().maxCoeff();
+        // an exact solution is converged even if it is zero
+        if(rnorm == RealScalar(0))
+          continue;
+        RealScalar ratio = rnorm / (m_normInf * x.col(j).cwiseAbs().maxCoeff());
+        if(!(ratio <= error))
+          error = ratio;
+      }
+      return error;
+    }
+
+    PlainObject m_matrix;
+    Decomposition m_decomposition;
+    mutable FallbackDecomposition m_fallback;
+    RealScalar m_normInf;
+    RealScalar m_scale;
+    RealScalar m_tolerance;
+    Index m_maxIterations;
+    mutable Index m_iterations;
+    mutable RealScalar m_error;
+    mutable ComputationInfo m_info;
+    mutable bool m_usesFallback;
+    bool m_isInitialized;
+};
+
+template<typename MatrixType, typename Decomposition>
+template<typename InputType>
+MixedPrecisionSolver<MatrixType,Decomposition>&
+MixedPrecisionSolver<MatrixType,Decomposition>::compute(const EigenBase<InputType>& matrix)
+{
+  check_template_parameters();
+
+  eigen_assert(matrix.rows() == matrix.cols() && "MixedPrecisionSolver requires a square matrix");
+  m_matrix = matrix.derived();
+  m_normInf = m_matrix.rows() > 0 ? m_matrix.cwiseAbs().rowwise().sum().maxCoeff() : RealScalar(0);
+  m_iterations = 0;
+  m_error = 0;
+  m_usesFallback = false;
+  m_isInitialized = true;
+
+  // factorize A scaled to a unit norm, so that its coefficients are representable in single precision
+  m_scale = m_normInf > RealScalar(0) ? m_normInf : RealScalar(1);
+  m_decomposition.compute((m_matrix / m_scale).template cast<LowScalar>());
+  if(internal::mixed_precision_info(m_decomposition) != Success)
+    fallback();
+  m_info = m_usesFallback ? internal::mixed_precision_info(m_fallback) : Success;
+  return *this;
+}
+
+#ifndef EIGEN_PARSED_BY_DOXYGEN
+template<typename _MatrixType, typename _Decomposition>
+template<typename RhsType, typename DstType>
+void MixedPrecisionSolver<_MatrixType,_Decomposition>::_solve_impl(const RhsType &rhs, DstType &dst) const
+{
+  typedef typename internal::plain_matrix_type_column_major<RhsType>::type ResidualType;
+  typedef Matrix<LowScalar, ResidualType::RowsAtCompileTime, ResidualType::ColsAtCompileTime, ResidualType::Options,
+                 ResidualType::MaxRowsAtCompileTime, ResidualType::MaxColsAtCompileTime> LowResidualType;
+
+  using std::sqrt;
+  eigen_assert(rhs.rows() == m_matrix.rows());
+
+  ResidualType r;
+  m_iterations = 0;
+  m_error = 0;
+  m_info = Success;
+  if(rhs.size() == 0)
+  {
+    dst = rhs;
+    return;
+  }
+
+  if(!m_usesFallback)
+  {
+    const RealScalar threshold = m_tolerance * sqrt(RealScalar(m_matrix.rows()));
+    RealScalar previous = NumTraits<RealScalar>::infinity();
+    dst.setZero();
+    r = rhs;
+    for(Index step = 0; ; ++step)
+    {
+      // scale the residual so that it neither underflows nor overflows in single precision
+      RealScalar scale = r.cwiseAbs().maxCoeff();
+      if(scale != RealScalar(0))
+      {
+        LowResidualType lowResidual = (r / scale).template cast<LowScalar>();
+        dst += (scale / m_scale) * m_decomposition.solve(lowResidual).template cast<Scalar>();
+      }
+      m_error = residual(rhs, dst, r);
+      if(m_error <= threshold)
+      {
+        m_iterations = step;
+        return;
+      }
+      // the refinement stalls or diverges: A is too ill-conditioned for the single precision factorization
+      if(step == m_maxIterations || !(m_error < RealScalar(0.5) * previous))
+        break;
+      previous = m_error;
+    }
+    fallback();
+  }
+
+  dst = m_fallback.solve(rhs);
+  m_info = internal::mixed_precision_info(m_fallback);
+  m_error = residual(rhs, dst, r);
+}
+#endif
+
+} // end namespace Eigen
+
+#endif // EIGEN_MIXED_PRECISION_SOLVER_H
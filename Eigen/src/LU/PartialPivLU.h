@@ -436,14 +436,7 @@ struct partial_lu_impl
       return unblocked_lu(lu, row_transpositions, nb_transpositions);
     }
 
-    // automatically adjust the number of subdivisions to the size
-    // of the matrix so that there is enough sub blocks:
-    Index blockSize;
-    {
-      blockSize = size/8;
-      blockSize = (blockSize/16)*16;
-      blockSize = (std::min)((std::max)(blockSize,Index(8)), maxBlockSize);
-    }
+    Index blockSize = panel_size(size, maxBlockSize);
 
     nb_transpositions = 0;
     Index first_zero_pivot = -1;
@@ -494,6 +487,141 @@ struct partial_lu_impl
     }
     return first_zero_pivot;
   }
+
+  /** \internal automatically adjusts the number of subdivisions to the size
+    * of the matrix so that there is enough sub blocks */
+  static Index panel_size(Index size, Index maxBlockSize)
+  {
+    Index blockSize = size/8;
+    blockSize = (blockSize/16)*16;
+    return (std::min)((std::max)(blockSize,Index(8)), maxBlockSize);
+  }
+
+#if defined(EIGEN_HAS_OPENMP) || defined(EIGEN_GEMM_THREADPOOL)
+  /** \internal applies the row transpositions of the panel of \a bs columns starting at \a k to the \a ncols
+    * columns of \a lu starting at \a c0, and if \a trailing is true, updates these columns by the panel:
+    * A12 = A11^-1 A12 and A22 -= A21 * A12. The kernels run sequentially on the calling thread.
+    */
+  static void update_columns(MatrixType& lu, Index k, Index bs, Index c0, Index ncols, const PivIndex* row_transpositions, bool trailing)
+  {
+    BlockType A_c(lu,0,c0,lu.rows(),ncols);
+    for(Index i=k; i<k+bs; ++i)
+      A_c.row(i).swap(A_c.row(row_transpositions[i]));
+    if(!trailing)
+      return;
+
+    const Index trows = lu.rows()-k-bs;
+    const Index stride = lu.outerStride();
+    gemm_blocking_space<StorageOrder,Scalar,Scalar,Dynamic,Dynamic,Dynamic,4> trsmBlocking(bs, ncols, bs, 1, false);
+    triangular_solve_matrix<Scalar,Index,OnTheLeft,UnitLower,false,StorageOrder,StorageOrder>
+      ::run(bs, ncols, &lu.coeffRef(k,k), stride, &lu.coeffRef(k,c0), stride, trsmBlocking);
+    if(trows>0)
+    {
+      gemm_blocking_space<StorageOrder,Scalar,Scalar,Dynamic,Dynamic,Dynamic> gemmBlocking(trows, ncols, bs, 1, true);
+      general_matrix_matrix_product<Index,Scalar,StorageOrder,false,Scalar,StorageOrder,false,StorageOrder>
+        ::run(trows, ncols, bs, &lu.coeffRef(k+bs,k), stride, &lu.coeffRef(k,c0), stride,
+              &lu.coeffRef(k+bs,c0), stride, Scalar(-1), gemmBlocking, 0);
+    }
+  }
+
+  /** \internal One step of parallel_blocked_lu(): the panel starting at \a k has been factorized, the task 0 updates
+    * the next panel and factorizes it (look-ahead), while all the tasks update the remaining columns by chunks. */
+  struct parallel_step_task
+  {
+    parallel_step_task(MatrixType& lu, PivIndex* row_transpositions, Index k, Index bs, Index nextBs, Index chunk,
+                       parallel_work_counter& counter, Index& panelRet, PivIndex& panelTranspositions)
+      : m_lu(lu), m_row_transpositions(row_transpositions), m_k(k), m_bs(bs), m_nextBs(nextBs), m_chunk(chunk),
+        m_rightStart(k+bs+nextBs),
+        m_rightChunks((lu.cols()-m_rightStart+chunk-1)/chunk),
+        m_leftChunks((k+chunk-1)/chunk),
+        m_counter(counter), m_panelRet(panelRet), m_panelTranspositions(panelTranspositions)
+    {}
+
+    Index items() const { return m_rightChunks + m_leftChunks; }
+
+    void operator()(Index i, Index) const
+    {
+      if(i==0 && m_nextBs>0)
+      {
+        // the next panel is on the critical path
+        const Index next = m_k+m_bs;
+        update_columns(m_lu, m_k, m_bs, next, m_nextBs, m_row_transpositions, true);
+        m_panelRet = blocked_lu(m_lu.rows()-next, m_nextBs, &m_lu.coeffRef(next,next), m_lu.outerStride(),
+                                m_row_transpositions+next, m_panelTranspositions, 16);
+        for(Index j=next; j<next+m_nextBs; ++j)
+          m_row_transpositions[j] += internal::convert_index<PivIndex>(next);
+      }
+
+      // the trailing columns, and then the row transpositions of the left columns
+      for(Index c=m_counter.next(); c<items(); c=m_counter.next())
+      {
+        if(c<m_rightChunks)
+        {
+          Index c0 = m_rightStart + c*m_chunk;
+          update_columns(m_lu, m_k, m_bs, c0, (std::min)(m_chunk, m_lu.cols()-c0), m_row_transpositions, true);
+        }
+        else
+        {
+          Index c0 = (c-m_rightChunks)*m_chunk;
+          update_columns(m_lu, m_k, m_bs, c0, (std::min)(m_chunk, m_k-c0), m_row_transpositions, false);
+        }
+      }
+    }
+
+    MatrixType& m_lu;
+    PivIndex* m_row_transpositions;
+    Index m_k, m_bs, m_nextBs, m_chunk, m_rightStart, m_rightChunks, m_leftChunks;
+    parallel_work_counter& m_counter;
+    Index& m_panelRet;
+    PivIndex& m_panelTranspositions;
+  };
+#endif
+
+  /** \internal Multi-threaded version of blocked_lu() for square or tall matrices, with a one-step look-ahead:
+    * while the columns right of the panel k+1 are updated by the panel k, the panel k+1 is updated and factorized
+    * by one of the threads, so that the factorization of the panels does not stall the other threads.
+    * The trailing updates are split by chunks of columns distributed dynamically to the threads, and the panels
+    * are factorized sequentially by the recursive blocked_lu(). Falls back to blocked_lu() when multi-threading is
+    * not enabled, or not worth it.
+    */
+  static Index parallel_blocked_lu(Index rows, Index cols, Scalar* lu_data, Index luStride, PivIndex* row_transpositions, PivIndex& nb_transpositions)
+  {
+#if defined(EIGEN_HAS_OPENMP) || defined(EIGEN_GEMM_THREADPOOL)
+    const Index size = (std::min)(rows,cols);
+    const Index threads = nbThreads();
+    if(rows<cols || size<256 || threads<=1 || is_in_parallel_region())
+      return blocked_lu(rows, cols, lu_data, luStride, row_transpositions, nb_transpositions);
+
+    MapLU lu1(lu_data,StorageOrder==RowMajor?rows:luStride,StorageOrder==RowMajor?luStride:cols);
+    MatrixType lu(lu1,0,0,rows,cols);
+
+    const Index blockSize = panel_size(size, 256);
+    const Index chunk = (std::max)(Index(32), blockSize/2);
+    Eigen::initParallel();
+
+    // factorize the first panel
+    Index first_zero_pivot = blocked_lu(rows, (std::min)(size,blockSize), lu_data, luStride, row_transpositions, nb_transpositions, 16);
+
+    for(Index k = 0; k < size; k+=blockSize)
+    {
+      Index bs = (std::min)(size-k,blockSize);
+      Index nextBs = (std::min)(size-k-bs,blockSize);
+
+      Index panelRet = -1;
+      PivIndex panelTranspositions = 0;
+      parallel_work_counter counter;
+      parallel_step_task task(lu, row_transpositions, k, bs, nextBs, chunk, counter, panelRet, panelTranspositions);
+      parallelize_tasks((std::min)(threads, task.items()+1), task);
+
+      if(panelRet>=0 && first_zero_pivot==-1)
+        first_zero_pivot = k+bs+panelRet;
+      nb_transpositions += panelTranspositions;
+    }
+    return first_zero_pivot;
+#else
+    return blocked_lu(rows, cols, lu_data, luStride, row_transpositions, nb_transpositions);
+#endif
+  }
 };
 
 /** \internal performs the LU decomposition with partial pivoting in-place.
@@ -506,7 +634,7 @@ void partial_lu_inplace(MatrixType& lu, TranspositionType& row_transpositions, t
 
   partial_lu_impl
     <typename MatrixType::Scalar, MatrixType::Flags&RowMajorBit?RowMajor:ColMajor, typename TranspositionType::StorageIndex>
-    ::blocked_lu(lu.rows(), lu.cols(), &lu.coeffRef(0,0), lu.outerStride(), &row_transpositions.coeffRef(0), nb_transpositions);
+    ::parallel_blocked_lu(lu.rows(), lu.cols(), &lu.coeffRef(0,0), lu.outerStride(), &row_transpositions.coeffRef(0), nb_transpositions);
 }
 
 } // end namespace internal
@@ -35,7 +35,8 @@ namespace Eigen {
   * If you want that feature, use FullPivHouseholderQR or ColPivHouseholderQR instead.
   *
   * This Householder QR decomposition is faster, but less numerically stable and less feature-full than
-  * FullPivHouseholderQR or ColPivHouseholderQR.
+  * FullPivHouseholderQR or ColPivHouseholderQR. For matrices having much more rows than columns,
+  * TallSkinnyQR is faster.
   *
   * This class supports the \link InplaceDecomposition inplace decomposition \endlink mechanism.
   *
@@ -0,0 +1,433 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_TALLSKINNYQR_H
+#define EIGEN_TALLSKINNYQR_H
+
+namespace Eigen {
+
+namespace internal {
+
+/** \internal \returns the first row of the block \a i out of \a blocks blocks of rows */
+inline Index tsqr_block_start(Index i, Index rows, Index blocks)
+{
+  return i * rows / blocks;
+}
+
+} // end namespace internal
+
+/** \ingroup QR_Module
+  *
+  *
+  * \class TallSkinnyQR
+  *
+  * \brief Communication-avoiding Householder QR decomposition of a tall and skinny matrix
+  *
+  * \tparam _MatrixType the type of the matrix of which we are computing the QR decomposition
+  *
+  * This class performs a QR decomposition \f$ \mathbf{A} = \mathbf{Q} \, \mathbf{R} \f$ of a matrix \b A
+  * having much more rows than columns, like HouseholderQR, but with the TSQR algorithm: the rows of \b A are
+  * split into blocks which are factorized independently, and the resulting triangular factors are merged
+  * pairwise along a binary reduction tree, whose root holds \b R. The blocks fit in the cache, and they are
+  * factorized concurrently when multi-threading is enabled (see \ref TopicMultiThreading), as well as the nodes
+  * of each level of the tree.
+  *
+  * The factor \b Q is stored implicitly as the Householder reflectors of the blocks and of the nodes of the tree,
+  * and is applied by applyQOnTheLeft() and applyQAdjointOnTheLeft().
+  *
+  * The number of rows of the blocks is set by setBlockRows(), by default it is chosen from the number of columns and
+  * the size of the L2 cache. Matrices which do not have at least twice this number of rows, in particular matrices
+  * which are not much taller than wide, are factorized as a single block, which is then exactly HouseholderQR.
+  *
+  * Note that no pivoting is performed. This is \b not a rank-revealing decomposition.
+  *
+  * \sa HouseholderQR, MatrixBase::householderQr()
+  */
+template<typename _MatrixType> class TallSkinnyQR
+{
+  public:
+
+    typedef _MatrixType MatrixType;
+    enum {
+      RowsAtCompileTime = MatrixType::RowsAtCompileTime,
+      ColsAtCompileTime = MatrixType::ColsAtCompileTime,
+      MaxRowsAtCompileTime = MatrixType::MaxRowsAtCompileTime,
+      MaxColsAtCompileTime = MatrixType::MaxColsAtCompileTime
+    };
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename MatrixType::RealScalar RealScalar;
+    typedef typename MatrixType::StorageIndex StorageIndex;
+    typedef Matrix<Scalar, Dynamic, Dynamic> DenseMatrixType;
+    typedef Matrix<Index, 2, Dynamic> NodeIndicesType;
+    typedef Matrix<Index, Dynamic, 1> LevelIndicesType;
+
+    /** \brief Default Constructor.
+      *
+      * The default constructor is useful in cases in which the user intends to
+      * perform decompositions via TallSkinnyQR::compute(const MatrixType&).
+      */
+    TallSkinnyQR() : m_blockRows(0), m_blocks(0), m_isInitialized(false) {}
+
+    /** \brief Constructs a QR factorization from a given matrix
+      *
+      * This constructor computes the QR factorization of the matrix \a matrix by calling
+      * the method compute().
+      */
+    template<typename InputType>
+    explicit TallSkinnyQR(const EigenBase<InputType>& matrix)
+      : m_blockRows(0), m_blocks(0), m_isInitialized(false)
+    {
+      compute(matrix.derived());
+    }
+
+    /** Performs the QR factorization of the given matrix \a matrix. The result of
+      * the factorization is stored into \c *this, and a reference to \c *this
+      * is returned.
+      */
+    template<typename InputType>
+    TallSkinnyQR& compute(const EigenBase<InputType>& matrix)
+    {
+      m_qr = matrix.derived();
+      computeInPlace();
+      return *this;
+    }
+
+    /** This method finds a solution x to the equation Ax=b, where A is the matrix of which
+      * *this is the QR decomposition, if any exists. For overdetermined systems, this is
+      * the least-squares solution.
+      *
+      * \param b the right-hand-side of the equation to solve.
+      *
+      * \returns a solution.
+      *
+      * \note_about_checking_solutions
+      *
+      * \note_about_arbitrary_choice_of_solution
+      */
+    template<typename Rhs>
+    inline const Solve<TallSkinnyQR, Rhs>
+    solve(const MatrixBase<Rhs>& b) const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      return Solve<TallSkinnyQR, Rhs>(*this, b.derived());
+    }
+
+    /** \returns the upper triangular (or trapezoidal for wide matrices) factor \b R, of size min(rows,cols) x cols */
+    const TriangularView<const DenseMatrixType, Upper> matrixR() const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      return m_r.template triangularView<Upper>();
+    }
+
+    /** Replaces \a other by \b Q \a other, where \b Q is the rows x rows unitary factor
+      *
+      * \sa applyQAdjointOnTheLeft(), thinQ()
+      */
+    template<typename Derived>
+    void applyQOnTheLeft(MatrixBase<Derived>& other) const;
+
+    /** Replaces \a other by \f$ \mathbf{Q}^* \f$ \a other, where \b Q is the rows x rows unitary factor
+      *
+      * \sa applyQOnTheLeft()
+      */
+    template<typename Derived>
+    void applyQAdjointOnTheLeft(MatrixBase<Derived>& other) const;
+
+    /** \returns the first min(rows,cols) columns of \b Q, such that \b A is the product of the thin Q by matrixR() */
+    DenseMatrixType thinQ() const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      DenseMatrixType q = DenseMatrixType::Identity(rows(), (std::min)(rows(),cols()));
+      applyQOnTheLeft(q);
+      return q;
+    }
+
+    /** \returns a reference to the matrix where the blocks of rows are factorized, in the same
+      * compact format as HouseholderQR::matrixQR() for each block. */
+    const MatrixType& matrixQR() const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      return m_qr;
+    }
+
+    /** Sets the number of rows of the blocks factorized independently, \a rows=0 restores the default.
+      * It is clamped to at least twice the number of columns.
+      */
+    TallSkinnyQR& setBlockRows(Index rows)
+    {
+      m_blockRows = rows;
+      return *this;
+    }
+
+    /** \returns the number of rows of the blocks, as set by setBlockRows(), or the default one */
+    Index blockRows() const
+    {
+      Index cols = (std::max)(m_qr.cols(), Index(1));
+      Index blockRows = m_blockRows>0 ? m_blockRows
+                      : Index(l2CacheSize() / (2 * cols * Index(sizeof(Scalar))));
+      return (std::max)(blockRows, 2 * cols);
+    }
+
+    /** \returns the number of blocks of rows of the last factorization, 1 when it was factorized as a whole */
+    Index blocks() const
+    {
+      eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+      return m_blocks;
+    }
+
+    inline Index rows() const { return m_qr.rows(); }
+    inline Index cols() const { return m_qr.cols(); }
+
+    #ifndef EIGEN_PARSED_BY_DOXYGEN
+    template<typename RhsType, typename DstType>
+    void _solve_impl(const RhsType &rhs, DstType &dst) const;
+    #endif
+
+  protected:
+
+    static void check_template_parameters()
+    {
+      EIGEN_STATIC_ASSERT_NON_INTEGER(Scalar);
+    }
+
+    void computeInPlace();
+
+    template<typename Derived> struct apply_blocks;
+    template<typename Derived> struct apply_nodes;
+    struct factorize_blocks;
+    struct factorize_nodes;
+
+    // the blocks of rows, factorized in place, and their Householder coefficients by columns
+    MatrixType m_qr;
+    DenseMatrixType m_blockCoeffs;
+    // the 2*cols x cols factorizations of the nodes of the tree, side by side, and their Householder coefficients;
+    // a node merges the triangular factors held by the first rows of two blocks, given by m_nodeBlocks, into the
+    // first one, and m_levels holds the index of the first node of each level followed by the number of nodes
+    DenseMatrixType m_nodeQR;
+    DenseMatrixType m_nodeCoeffs;
+    NodeIndicesType m_nodeBlocks;
+    LevelIndicesType m_levels;
+    DenseMatrixType m_r;
+    Index m_blockRows;
+    Index m_blocks;
+    bool m_isInitialized;
+};
+
+template<typename MatrixType>
+struct TallSkinnyQR<MatrixType>::factorize_blocks
+{
+  factorize_blocks(TallSkinnyQR& qr) : m_qr(qr) {}
+
+  void operator()(Index i) const
+  {
+    typedef Block<MatrixType,Dynamic,Dynamic> BlockType;
+    typedef Block<DenseMatrixType,Dynamic,1,true> CoeffsType;
+    const Index rows = m_qr.rows(), cols = m_qr.cols();
+    Index start = internal::tsqr_block_start(i, rows, m_qr.m_blocks);
+    Index blockRows = internal::tsqr_block_start(i+1, rows, m_qr.m_blocks) - start;
+    BlockType block(m_qr.m_qr, start, 0, blockRows, cols);
+    CoeffsType coeffs(m_qr.m_blockCoeffs, 0, i, (std::min)(blockRows,cols), 1);
+    internal::householder_qr_inplace_blocked<BlockType, CoeffsType>::run(block, coeffs, 48);
+  }
+
+  TallSkinnyQR& m_qr;
+};
+
+template<typename MatrixType>
+struct TallSkinnyQR<MatrixType>::factorize_nodes
+{
+  // factorizes the node first+k, the children of which are the nodes of the previous levels
+  // recorded in childNodes, or the blocks themselves when -1
+  factorize_nodes(TallSkinnyQR& qr, Index first, const LevelIndicesType& childNodes)
+    : m_qr(qr), m_first(first), m_childNodes(childNodes) {}
+
+  void operator()(Index k) const
+  {
+    typedef Block<DenseMatrixType,Dynamic,Dynamic,true> BlockType;
+    typedef Block<DenseMatrixType,Dynamic,1,true> CoeffsType;
+    const Index cols = m_qr.cols();
+    const Index j = m_first+k;
+    BlockType node(m_qr.m_nodeQR, 0, j*cols, 2*cols, cols);
+    node.setZero();
+    for(Index c = 0; c < 2; ++c)
+    {
+      Index b = m_qr.m_nodeBlocks(c,j);
+      Index child = m_childNodes(b);
+      if(child<0)
+        node.middleRows(c*cols,cols).template triangularView<Upper>()
+          = m_qr.m_qr.block(internal::tsqr_block_start(b, m_qr.rows(), m_qr.m_blocks), 0, cols, cols);
+      else
+        node.middleRows(c*cols,cols).template triangularView<Upper>() = m_qr.m_nodeQR.block(0, child*cols, cols, cols);
+    }
+    CoeffsType coeffs(m_qr.m_nodeCoeffs, 0, j, cols, 1);
+    internal::householder_qr_inplace_blocked<BlockType, CoeffsType>::run(node, coeffs, 48);
+  }
+
+  TallSkinnyQR& m_qr;
+  Index m_first;
+  const LevelIndicesType& m_childNodes;
+};
+
+template<typename MatrixType>
+template<typename Derived>
+struct TallSkinnyQR<MatrixType>::apply_blocks
+{
+  apply_blocks(const TallSkinnyQR& qr, MatrixBase<Derived>& other, bool adjoint)
+    : m_qr(qr), m_other(other), m_adjoint(adjoint) {}
+
+  void operator()(Index i) const
+  {
+    const Index rows = m_qr.rows(), cols = m_qr.cols();
+    Index start = internal::tsqr_block_start(i, rows, m_qr.m_blocks);
+    Index blockRows = internal::tsqr_block_start(i+1, rows, m_qr.m_blocks) - start;
+    Block<Derived,Dynamic,Dynamic> dst(m_other.derived(), start, 0, blockRows, m_other.cols());
+    // as in HouseholderQR, Q = H_0^* H_1^*... so its inverse is Q^* = (H_0 H_1 ...)^T
+    if(m_adjoint)
+      dst.applyOnTheLeft(householderSequence(m_qr.m_qr.block(start, 0, blockRows, cols),
+                                             m_qr.m_blockCoeffs.col(i).head((std::min)(blockRows,cols))).transpose());
+    else
+      dst.applyOnTheLeft(householderSequence(m_qr.m_qr.block(start, 0, blockRows, cols),
+                                             m_qr.m_blockCoeffs.col(i).head((std::min)(blockRows,cols)).conjugate()));
+  }
+
+  const TallSkinnyQR& m_qr;
+  MatrixBase<Derived>& m_other;
+  bool m_adjoint;
+};
+
+template<typename MatrixType>
+template<typename Derived>
+struct TallSkinnyQR<MatrixType>::apply_nodes
+{
+  // applies the node first+k of a level to the first rows of the blocks it merges
+  apply_nodes(const TallSkinnyQR& qr, MatrixBase<Derived>& other, Index first, bool adjoint)
+    : m_qr(qr), m_other(other), m_first(first), m_adjoint(adjoint) {}
+
+  void operator()(Index k) const
+  {
+    typedef Matrix<typename Derived::Scalar,Dynamic,Dynamic> TmpType;
+    const Index cols = m_qr.cols();
+    TmpType tmp(2*cols, m_other.cols());
+    const Index j = m_first+k;
+    Index start0 = internal::tsqr_block_start(m_qr.m_nodeBlocks(0,j), m_qr.rows(), m_qr.m_blocks);
+    Index start1 = internal::tsqr_block_start(m_qr.m_nodeBlocks(1,j), m_qr.rows(), m_qr.m_blocks);
+    tmp.topRows(cols) = m_other.middleRows(start0, cols);
+    tmp.bottomRows(cols) = m_other.middleRows(start1, cols);
+    if(m_adjoint)
+      tmp.applyOnTheLeft(householderSequence(m_qr.m_nodeQR.middleCols(j*cols, cols),
+                                             m_qr.m_nodeCoeffs.col(j)).transpose());
+    else
+      tmp.applyOnTheLeft(householderSequence(m_qr.m_nodeQR.middleCols(j*cols, cols),
+                                             m_qr.m_nodeCoeffs.col(j).conjugate()));
+    m_other.middleRows(start0, cols) = tmp.topRows(cols);
+    m_other.middleRows(start1, cols) = tmp.bottomRows(cols);
+  }
+
+  const TallSkinnyQR& m_qr;
+  MatrixBase<Derived>& m_other;
+  Index m_first;
+  bool m_adjoint;
+};
+
+template<typename MatrixType>
+template<typename Derived>
+void TallSkinnyQR<MatrixType>::applyQOnTheLeft(MatrixBase<Derived>& other) const
+{
+  eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+  eigen_assert(other.rows() == rows());
+  // Q is the product of the blocks by the levels of the tree, from the leaves to the root
+  for(Index l = m_levels.size()-2; l >= 0; --l)
+    internal::parallel_for(apply_nodes<Derived>(*this, other, m_levels(l), false), m_levels(l+1)-m_levels(l));
+  internal::parallel_for(apply_blocks<Derived>(*this, other, false), m_blocks);
+}
+
+template<typename MatrixType>
+template<typename Derived>
+void TallSkinnyQR<MatrixType>::applyQAdjointOnTheLeft(MatrixBase<Derived>& other) const
+{
+  eigen_assert(m_isInitialized && "TallSkinnyQR is not initialized.");
+  eigen_assert(other.rows() == rows());
+  internal::parallel_for(apply_blocks<Derived>(*this, other, true), m_blocks);
+  for(Index l = 0; l+1 < m_levels.size(); ++l)
+    internal::parallel_for(apply_nodes<Derived>(*this, other, m_levels(l), true), m_levels(l+1)-m_levels(l));
+}
+
+#ifndef EIGEN_PARSED_BY_DOXYGEN
+template<typename _MatrixType>
+template<typename RhsType, typename DstType>
+void TallSkinnyQR<_MatrixType>::_solve_impl(const RhsType &rhs, DstType &dst) const
+{
+  const Index rank = (std::min)(rows(), cols());
+  eigen_assert(rhs.rows() == rows());
+
+  typename RhsType::PlainObject c(rhs);
+  applyQAdjointOnTheLeft(c);
+
+  m_r.topLeftCorner(rank, rank)
+     .template triangularView<Upper>()
+     .solveInPlace(c.topRows(rank));
+
+  dst.topRows(rank) = c.topRows(rank);
+  dst.bottomRows(cols()-rank).setZero();
+}
+#endif
+
+template<typename MatrixType>
+void TallSkinnyQR<MatrixType>::computeInPlace()
+{
+  check_template_parameters();
+
+  const Index rows = m_qr.rows();
+  const Index cols = m_qr.cols();
+  const Index size = (std::min)(rows,cols);
+
+  m_blocks = (std::max)(rows / blockRows(), Index(1));
+  m_blockCoeffs.resize(size, m_blocks);
+  internal::parallel_for(factorize_blocks(*this), m_blocks);
+
+  // merge the blocks pairwise, level by level, the node of a pair of blocks (or of subtrees) being recorded
+  // in childNodes at the index of its first block
+  const Index nodes = m_blocks-1;
+  m_nodeQR.resize(2*cols, nodes*cols);
+  m_nodeCoeffs.resize(cols, nodes);
+  m_nodeBlocks.resize(2, nodes);
+  LevelIndicesType active = LevelIndicesType::LinSpaced(m_blocks, 0, m_blocks-1);
+  LevelIndicesType childNodes = LevelIndicesType::Constant(m_blocks, -1);
+  m_levels.resize(m_blocks+1);
+  m_levels(0) = 0;
+  Index node = 0, level = 0;
+  while(active.size() > 1)
+  {
+    Index pairs = active.size()/2;
+    for(Index p = 0; p < pairs; ++p)
+      m_nodeBlocks.col(node+p) << active(2*p), active(2*p+1);
+    internal::parallel_for(factorize_nodes(*this, node, childNodes), pairs);
+
+    LevelIndicesType next((active.size()+1)/2);
+    for(Index p = 0; p < next.size(); ++p)
+    {
+      next(p) = active(2*p);
+      if(p < pairs)
+        childNodes(active(2*p)) = node+p;
+    }
+    active.swap(next);
+    node += pairs;
+    m_levels(++level) = node;
+  }
+  m_levels.conservativeResize(level+1);
+
+  if(nodes > 0)
+    m_r = m_nodeQR.block(0, (nodes-1)*cols, cols, cols).template triangularView<Upper>();
+  else
+    m_r = m_qr.topRows(size).template triangularView<Upper>();
+
+  m_isInitialized = true;
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_TALLSKINNYQR_H
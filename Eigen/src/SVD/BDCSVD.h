@@ -61,6 +61,9 @@ struct traits<BDCSVD<_MatrixType> >
  * For small matrice (<16), it is thus preferable to directly use JacobiSVD. For larger ones, BDCSVD is highly
  * recommended and can several order of magnitude faster.
  *
+ * When multi-threading is enabled, the independent subproblems of the first levels of the divide and conquer
+ * recursion are solved concurrently, see \ref TopicMultiThreading.
+ *
  * \warning this algorithm is unlikely to provide accurate result when compiled with unsafe math optimizations.
  * For instance, this concerns Intel's compiler (ICC), which perfroms such optimization by default unless
  * you compile with the \c -fp-model \c precise option. Likewise, the \c -ffast-math option of GCC or clang will
@@ -176,23 +179,40 @@ public:
   }
  
 private:
+  // Scratch memory of a subproblem of the divide step, the subproblems which are solved concurrently using disjoint
+  // slices of m_workspace and m_workspaceI.
+  struct Workspace
+  {
+    RealScalar* real;
+    Index* index;
+    int numIters;
+  };
+  struct SubproblemTask;
+  struct SingValsTask;
+
   void allocate(Index rows, Index cols, unsigned int computationOptions);
-  void divide(Index firstCol, Index lastCol, Index firstRowW, Index firstColW, Index shift);
-  void computeSVDofM(Index firstCol, Index n, MatrixXr& U, VectorType& singVals, MatrixXr& V);
-  void computeSingVals(const ArrayRef& col0, const ArrayRef& diag, const IndicesRef& perm, VectorType& singVals, ArrayRef shifts, ArrayRef mus);
+  void divideAndConquer();
+  void subproblem(Index level, Index j, Index& firstCol, Index& lastCol, Index& firstRowW, Index& firstColW, Index& shift, Workspace& workspace);
+  void divide(Index firstCol, Index lastCol, Index firstRowW, Index firstColW, Index shift, Workspace& workspace);
+  void conquer(Index firstCol, Index lastCol, Index firstRowW, Index firstColW, Index shift, Workspace& workspace);
+  void computeSVDofM(Index firstCol, Index n, MatrixXr& U, VectorType& singVals, MatrixXr& V, Workspace& workspace);
+  void computeSingVals(const ArrayRef& col0, const ArrayRef& diag, const IndicesRef& perm, VectorType& singVals, ArrayRef shifts, ArrayRef mus, Workspace& workspace);
+  void computeSingValsRange(const ArrayRef& col0, const ArrayRef& diag, const IndicesRef& perm, VectorType& singVals, ArrayRef shifts, ArrayRef mus, Index actual_n, Index begin, Index end, ArrayRef diagShifted, int& numIters);
   void perturbCol0(const ArrayRef& col0, const ArrayRef& diag, const IndicesRef& perm, const VectorType& singVals, const ArrayRef& shifts, const ArrayRef& mus, ArrayRef zhat);
   void computeSingVecs(const ArrayRef& zhat, const ArrayRef& diag, const IndicesRef& perm, const VectorType& singVals, const ArrayRef& shifts, const ArrayRef& mus, MatrixXr& U, MatrixXr& V);
   void deflation43(Index firstCol, Index shift, Index i, Index size);
   void deflation44(Index firstColu , Index firstColm, Index firstRowW, Index firstColW, Index i, Index j, Index size);
-  void deflation(Index firstCol, Index lastCol, Index k, Index firstRowW, Index firstColW, Index shift);
+  void deflation(Index firstCol, Index lastCol, Index k, Index firstRowW, Index firstColW, Index shift, Workspace& workspace);
   template<typename HouseholderU, typename HouseholderV, typename NaiveU, typename NaiveV>
   void copyUV(const HouseholderU &householderU, const HouseholderV &householderV, const NaiveU &naiveU, const NaiveV &naivev);
-  void structured_update(Block<MatrixXr,Dynamic,Dynamic> A, const MatrixXr &B, Index n1);
+  void structured_update(Block<MatrixXr,Dynamic,Dynamic> A, const MatrixXr &B, Index n1, Workspace& workspace);
   static RealScalar secularEq(RealScalar x, const ArrayRef& col0, const ArrayRef& diag, const IndicesRef &perm, const ArrayRef& diagShifted, RealScalar shift);
 
 protected:
   MatrixXr m_naiveU, m_naiveV;
   MatrixXr m_computed;
+  // diagonal and sub-diagonal of the transposed bidiagonal matrix, which is the initial value of m_computed
+  ArrayXr m_diagonal, m_subDiagonal;
   Index m_nRec;
   ArrayXr m_workspace;
   ArrayXi m_workspaceI;
@@ -277,10 +297,12 @@ BDCSVD<MatrixType>& BDCSVD<MatrixType>::compute(const MatrixType& matrix, unsign
   //**** step 2 - Divide & Conquer
   m_naiveU.setZero();
   m_naiveV.setZero();
-  // FIXME this line involves a temporary matrix
-  m_computed.topRows(m_diagSize) = bid.bidiagonal().toDenseMatrix().transpose();
-  m_computed.template bottomRows<1>().setZero();
-  divide(0, m_diagSize - 1, 0, 0, 0);
+  m_computed.setZero();
+  m_diagonal = bid.bidiagonal().diagonal();
+  m_subDiagonal.resize(m_diagSize);
+  m_subDiagonal.head(m_diagSize - 1) = bid.bidiagonal().diagonal(1);
+  m_subDiagonal(m_diagSize - 1) = Literal(0);
+  divideAndConquer();
 
   //**** step 3 - Copy singular values and vectors
   for (int i=0; i<m_diagSize; i++)
@@ -342,7 +364,7 @@ void BDCSVD<MatrixType>::copyUV(const HouseholderU &householderU, const Househol
   * enough.
   */
 template<typename MatrixType>
-void BDCSVD<MatrixType>::structured_update(Block<MatrixXr,Dynamic,Dynamic> A, const MatrixXr &B, Index n1)
+void BDCSVD<MatrixType>::structured_update(Block<MatrixXr,Dynamic,Dynamic> A, const MatrixXr &B, Index n1, Workspace& workspace)
 {
   Index n = A.rows();
   if(n>100)
@@ -350,10 +372,10 @@ void BDCSVD<MatrixType>::structured_update(Block<MatrixXr,Dynamic,Dynamic> A, co
     // If the matrices are large enough, let's exploit the sparse structure of A by
     // splitting it in half (wrt n1), and packing the non-zero columns.
     Index n2 = n - n1;
-    Map<MatrixXr> A1(m_workspace.data()      , n1, n);
-    Map<MatrixXr> A2(m_workspace.data()+ n1*n, n2, n);
-    Map<MatrixXr> B1(m_workspace.data()+  n*n, n,  n);
-    Map<MatrixXr> B2(m_workspace.data()+2*n*n, n,  n);
+    Map<MatrixXr> A1(workspace.real      , n1, n);
+    Map<MatrixXr> A2(workspace.real+ n1*n, n2, n);
+    Map<MatrixXr> B1(workspace.real+  n*n, n,  n);
+    Map<MatrixXr> B2(workspace.real+2*n*n, n,  n);
     Index k1=0, k2=0;
     for(Index j=0; j<n; ++j)
     {
@@ -376,12 +398,92 @@ void BDCSVD<MatrixType>::structured_update(Block<MatrixXr,Dynamic,Dynamic> A, co
   }
   else
   {
-    Map<MatrixXr,Aligned> tmp(m_workspace.data(),n,n);
+    Map<MatrixXr,Aligned> tmp(workspace.real,n,n);
     tmp.noalias() = A*B;
     A = tmp;
   }
 }
 
+// Solves the bidiagonal problem. The subproblems of a given depth of the recursion being independent, when
+// multi-threading is enabled the subproblems of depth levels are solved concurrently, and then the subproblems of
+// each depth above them are merged concurrently, the products of the largest ones being parallelized in turn.
+template<typename MatrixType>
+void BDCSVD<MatrixType>::divideAndConquer()
+{
+  Index levels = 0;
+#if defined(EIGEN_HAS_OPENMP) || defined(EIGEN_GEMM_THREADPOOL)
+  // the subproblems of depth l have at least ((m_diagSize+1) >> l) - 1 columns, and are not worth a task below 128
+  const Index minSize = (std::max)(Index(128), Index(m_algoswap));
+  while((Index(1) << levels) < Index(nbThreads()) && ((m_diagSize + 1) >> (levels + 1)) - 1 >= minSize)
+    ++levels;
+#endif
+  Matrix<int,Dynamic,1> numIters = Matrix<int,Dynamic,1>::Zero(Index(1) << levels);
+  internal::parallel_for(SubproblemTask(*this, levels, true, numIters), numIters.size());
+  for(Index l = levels-1; l >= 0; --l)
+    internal::parallel_for(SubproblemTask(*this, l, false, numIters), Index(1) << l);
+  m_numIters += numIters.sum();
+}
+
+template<typename MatrixType>
+struct BDCSVD<MatrixType>::SubproblemTask
+{
+  SubproblemTask(BDCSVD& svd, Index level, bool divide, Matrix<int,Dynamic,1>& numIters)
+    : m_svd(svd), m_level(level), m_divide(divide), m_numIters(numIters)
+  {}
+
+  void operator()(Index j) const
+  {
+    Index firstCol, lastCol, firstRowW, firstColW, shift;
+    Workspace workspace;
+    m_svd.subproblem(m_level, j, firstCol, lastCol, firstRowW, firstColW, shift, workspace);
+    if (m_divide) m_svd.divide(firstCol, lastCol, firstRowW, firstColW, shift, workspace);
+    else          m_svd.conquer(firstCol, lastCol, firstRowW, firstColW, shift, workspace);
+    m_numIters(j) += workspace.numIters;
+  }
+
+  BDCSVD& m_svd;
+  Index m_level;
+  bool m_divide;
+  Matrix<int,Dynamic,1>& m_numIters;
+};
+
+// Computes the arguments of divide() for the j-th subproblem of depth level, the bits of j telling from the most
+// significant one whether the left (1) or the right (0) submatrix is taken at each depth. The slices of the workspaces
+// of the subproblems of a given depth do not overlap: a submatrix of size n needs 3(n+1)^2 scalars, see
+// structured_update(), and 3n indices, see deflation(), so that the right submatrix can use the workspaces after the
+// ones of the left submatrix.
+template<typename MatrixType>
+void BDCSVD<MatrixType>::subproblem(Eigen::Index level, Eigen::Index j, Eigen::Index& firstCol, Eigen::Index& lastCol, Eigen::Index& firstRowW, Eigen::Index& firstColW, Eigen::Index& shift, Workspace& workspace)
+{
+  firstCol = 0;
+  lastCol = m_diagSize - 1;
+  firstRowW = 0;
+  firstColW = 0;
+  shift = 0;
+  workspace.real = m_workspace.data();
+  workspace.index = m_workspaceI.data();
+  workspace.numIters = 0;
+  for(Index l = level-1; l >= 0; --l)
+  {
+    const Index k = (lastCol - firstCol + 1)/2;
+    if((j >> l) & 1)
+    {
+      lastCol = k - 1 + firstCol;
+      firstColW += 1;
+      shift += 1;
+    }
+    else
+    {
+      firstCol += k + 1;
+      firstRowW += k + 1;
+      firstColW += k + 1;
+      // keep the workspace aligned for the products of structured_update()
+      workspace.real += internal::first_multiple<Index>(3*(k+1)*(k+1), 16);
+      workspace.index += 3*k;
+    }
+  }
+}
+
 // The divide algorithm is done "in place", we are always working on subsets of the same matrix. The divide methods takes as argument the 
 // place of the submatrix we are currently working on.
 
@@ -392,27 +494,21 @@ void BDCSVD<MatrixType>::structured_update(Block<MatrixXr,Dynamic,Dynamic> A, co
 //@param firstRowW : Same as firstRowW with the column.
 //@param shift : Each time one takes the left submatrix, one must add 1 to the shift. Why? Because! We actually want the last column of the U submatrix 
 // to become the first column (*coeff) and to shift all the other columns to the right. There are more details on the reference paper.
+//@param workspace : The scratch memory of the submatrix, see subproblem().
 template<typename MatrixType>
-void BDCSVD<MatrixType>::divide (Eigen::Index firstCol, Eigen::Index lastCol, Eigen::Index firstRowW, Eigen::Index firstColW, Eigen::Index shift)
+void BDCSVD<MatrixType>::divide (Eigen::Index firstCol, Eigen::Index lastCol, Eigen::Index firstRowW, Eigen::Index firstColW, Eigen::Index shift, Workspace& workspace)
 {
-  // requires rows = cols + 1;
-  using std::pow;
-  using std::sqrt;
-  using std::abs;
   const Index n = lastCol - firstCol + 1;
   const Index k = n/2;
-  const RealScalar considerZero = (std::numeric_limits<RealScalar>::min)();
-  RealScalar alphaK;
-  RealScalar betaK; 
-  RealScalar r0; 
-  RealScalar lambda, phi, c0, s0;
-  VectorType l, f;
   // We use the other algorithm which is more efficient for small 
   // matrices.
   if (n < m_algoswap)
   {
     // FIXME this line involves temporaries
-    JacobiSVD<MatrixXr> b(m_computed.block(firstCol, firstCol, n + 1, n), ComputeFullU | (m_compV ? ComputeFullV : 0));
+    MatrixXr bidiagonal = MatrixXr::Zero(n + 1, n);
+    bidiagonal.diagonal() = m_diagonal.segment(firstCol, n).matrix();
+    bidiagonal.template diagonal<-1>() = m_subDiagonal.segment(firstCol, n).matrix();
+    JacobiSVD<MatrixXr> b(bidiagonal, ComputeFullU | (m_compV ? ComputeFullV : 0));
     if (m_compU)
       m_naiveU.block(firstCol, firstCol, n + 1, n + 1).real() = b.matrixU();
     else 
@@ -425,14 +521,30 @@ void BDCSVD<MatrixType>::divide (Eigen::Index firstCol, Eigen::Index lastCol, Ei
     m_computed.diagonal().segment(firstCol + shift, n) = b.singularValues().head(n);
     return;
   }
-  // We use the divide and conquer algorithm
-  alphaK =  m_computed(firstCol + k, firstCol + k);
-  betaK = m_computed(firstCol + k + 1, firstCol + k);
-  // The divide must be done in that order in order to have good results. Divide change the data inside the submatrices
-  // and the divide of the right submatrice reads one column of the left submatrice. That's why we need to treat the 
-  // right submatrix before the left one. 
-  divide(k + 1 + firstCol, lastCol, k + 1 + firstRowW, k + 1 + firstColW, shift);
-  divide(firstCol, k - 1 + firstCol, firstRowW, firstColW + 1, shift + 1);
+  // We use the divide and conquer algorithm. The submatrices read their coefficients from m_diagonal and m_subDiagonal
+  // rather than from m_computed, where the results of the left submatrix overwrite the first columns of the right one,
+  // and write their results to distinct columns of m_computed, m_naiveU and m_naiveV: they can be treated in any order.
+  divide(k + 1 + firstCol, lastCol, k + 1 + firstRowW, k + 1 + firstColW, shift, workspace);
+  divide(firstCol, k - 1 + firstCol, firstRowW, firstColW + 1, shift + 1, workspace);
+  conquer(firstCol, lastCol, firstRowW, firstColW, shift, workspace);
+}
+
+// Merges the SVDs of the two submatrices computed by divide() into the SVD of the submatrix.
+template<typename MatrixType>
+void BDCSVD<MatrixType>::conquer (Eigen::Index firstCol, Eigen::Index lastCol, Eigen::Index firstRowW, Eigen::Index firstColW, Eigen::Index shift, Workspace& workspace)
+{
+  // requires rows = cols + 1;
+  using std::pow;
+  using std::sqrt;
+  using std::abs;
+  const Index n = lastCol - firstCol + 1;
+  const Index k = n/2;
+  const RealScalar considerZero = (std::numeric_limits<RealScalar>::min)();
+  RealScalar alphaK = m_diagonal(firstCol + k);
+  RealScalar betaK = m_subDiagonal(firstCol + k);
+  RealScalar r0; 
+  RealScalar lambda, phi, c0, s0;
+  VectorType l, f;
 
   if (m_compU)
   {
@@ -520,7 +632,7 @@ void BDCSVD<MatrixType>::divide (Eigen::Index firstCol, Eigen::Index lastCol, Ei
   ArrayXr tmp1 = (m_computed.block(firstCol+shift, firstCol+shift, n, n)).jacobiSvd().singularValues();
 #endif
   // Second part: try to deflate singular values in combined matrix
-  deflation(firstCol, lastCol, k, firstRowW, firstColW, shift);
+  deflation(firstCol, lastCol, k, firstRowW, firstColW, shift, workspace);
 #ifdef EIGEN_BDCSVD_DEBUG_VERBOSE
   ArrayXr tmp2 = (m_computed.block(firstCol+shift, firstCol+shift, n, n)).jacobiSvd().singularValues();
   std::cout << "\n\nj1 = " << tmp1.transpose().format(bdcsvdfmt) << "\n";
@@ -536,7 +648,7 @@ void BDCSVD<MatrixType>::divide (Eigen::Index firstCol, Eigen::Index lastCol, Ei
   // Third part: compute SVD of combined matrix
   MatrixXr UofSVD, VofSVD;
   VectorType singVals;
-  computeSVDofM(firstCol + shift, n, UofSVD, singVals, VofSVD);
+  computeSVDofM(firstCol + shift, n, UofSVD, singVals, VofSVD, workspace);
   
 #ifdef EIGEN_BDCSVD_SANITY_CHECKS
   assert(UofSVD.allFinite());
@@ -544,15 +656,15 @@ void BDCSVD<MatrixType>::divide (Eigen::Index firstCol, Eigen::Index lastCol, Ei
 #endif
   
   if (m_compU)
-    structured_update(m_naiveU.block(firstCol, firstCol, n + 1, n + 1), UofSVD, (n+2)/2);
+    structured_update(m_naiveU.block(firstCol, firstCol, n + 1, n + 1), UofSVD, (n+2)/2, workspace);
   else
   {
-    Map<Matrix<RealScalar,2,Dynamic>,Aligned> tmp(m_workspace.data(),2,n+1);
+    Map<Matrix<RealScalar,2,Dynamic>,Aligned> tmp(workspace.real,2,n+1);
     tmp.noalias() = m_naiveU.middleCols(firstCol, n+1) * UofSVD;
     m_naiveU.middleCols(firstCol, n + 1) = tmp;
   }
   
-  if (m_compV)  structured_update(m_naiveV.block(firstRowW, firstColW, n, n), VofSVD, (n+1)/2);
+  if (m_compV)  structured_update(m_naiveV.block(firstRowW, firstColW, n, n), VofSVD, (n+1)/2, workspace);
   
 #ifdef EIGEN_BDCSVD_SANITY_CHECKS
   assert(m_naiveU.allFinite());
@@ -562,7 +674,7 @@ void BDCSVD<MatrixType>::divide (Eigen::Index firstCol, Eigen::Index lastCol, Ei
   
   m_computed.block(firstCol + shift, firstCol + shift, n, n).setZero();
   m_computed.block(firstCol + shift, firstCol + shift, n, n).diagonal() = singVals;
-}// end divide
+}// end conquer
 
 // Compute SVD of m_computed.block(firstCol, firstCol, n + 1, n); this block only has non-zeros in
 // the first column and on the diagonal and has undergone deflation, so diagonal is in increasing
@@ -573,13 +685,13 @@ void BDCSVD<MatrixType>::divide (Eigen::Index firstCol, Eigen::Index lastCol, Ei
 // handling of round-off errors, be consistent in ordering
 // For instance, to solve the secular equation using FMM, see http://www.stat.uchicago.edu/~lekheng/courses/302/classics/greengard-rokhlin.pdf
 template <typename MatrixType>
-void BDCSVD<MatrixType>::computeSVDofM(Eigen::Index firstCol, Eigen::Index n, MatrixXr& U, VectorType& singVals, MatrixXr& V)
+void BDCSVD<MatrixType>::computeSVDofM(Eigen::Index firstCol, Eigen::Index n, MatrixXr& U, VectorType& singVals, MatrixXr& V, Workspace& workspace)
 {
   const RealScalar considerZero = (std::numeric_limits<RealScalar>::min)();
   using std::abs;
   ArrayRef col0 = m_computed.col(firstCol).segment(firstCol, n);
-  m_workspace.head(n) =  m_computed.block(firstCol, firstCol, n, n).diagonal();
-  ArrayRef diag = m_workspace.head(n);
+  Map<ArrayXr> diag(workspace.real, n);
+  diag = m_computed.block(firstCol, firstCol, n, n).diagonal();
   diag(0) = Literal(0);
 
   // Allocate space for singular values and vectors
@@ -600,12 +712,12 @@ void BDCSVD<MatrixType>::computeSVDofM(Eigen::Index firstCol, Eigen::Index n, Ma
   Index m = 0; // size of the deflated problem
   for(Index k=0;k<actual_n;++k)
     if(abs(col0(k))>considerZero)
-      m_workspaceI(m++) = k;
-  Map<ArrayXi> perm(m_workspaceI.data(),m);
+      workspace.index[m++] = k;
+  Map<ArrayXi> perm(workspace.index,m);
   
-  Map<ArrayXr> shifts(m_workspace.data()+1*n, n);
-  Map<ArrayXr> mus(m_workspace.data()+2*n, n);
-  Map<ArrayXr> zhat(m_workspace.data()+3*n, n);
+  Map<ArrayXr> shifts(workspace.real+1*n, n);
+  Map<ArrayXr> mus(workspace.real+2*n, n);
+  Map<ArrayXr> zhat(workspace.real+3*n, n);
 
 #ifdef EIGEN_BDCSVD_DEBUG_VERBOSE
   std::cout << "computeSVDofM using:\n";
@@ -614,7 +726,7 @@ void BDCSVD<MatrixType>::computeSVDofM(Eigen::Index firstCol, Eigen::Index n, Ma
 #endif
   
   // Compute singVals, shifts, and mus
-  computeSingVals(col0, diag, perm, singVals, shifts, mus);
+  computeSingVals(col0, diag, perm, singVals, shifts, mus, workspace);
   
 #ifdef EIGEN_BDCSVD_DEBUG_VERBOSE
   std::cout << "  j:        " << (m_computed.block(firstCol, firstCol, n, n)).jacobiSvd().singularValues().transpose().reverse() << "\n\n";
@@ -717,20 +829,68 @@ typename BDCSVD<MatrixType>::RealScalar BDCSVD<MatrixType>::secularEq(RealScalar
 }
 
 template <typename MatrixType>
-void BDCSVD<MatrixType>::computeSingVals(const ArrayRef& col0, const ArrayRef& diag, const IndicesRef &perm,
-                                         VectorType& singVals, ArrayRef shifts, ArrayRef mus)
+struct BDCSVD<MatrixType>::SingValsTask
 {
-  using std::abs;
-  using std::swap;
-  using std::sqrt;
+  SingValsTask(BDCSVD& svd, const ArrayRef& col0, const ArrayRef& diag, const IndicesRef& perm, VectorType& singVals,
+               ArrayRef& shifts, ArrayRef& mus, Index actual_n, Index chunks, RealScalar* diagShifted, Matrix<int,Dynamic,1>& numIters)
+    : m_svd(svd), m_col0(col0), m_diag(diag), m_perm(perm), m_singVals(singVals), m_shifts(shifts), m_mus(mus),
+      m_actual_n(actual_n), m_chunks(chunks), m_diagShifted(diagShifted), m_numIters(numIters)
+  {}
 
+  void operator()(Index j) const
+  {
+    Index n = m_col0.size();
+    Map<ArrayXr> diagShifted(m_diagShifted + j*n, n);
+    m_svd.computeSingValsRange(m_col0, m_diag, m_perm, m_singVals, m_shifts, m_mus, m_actual_n,
+                               j*n/m_chunks, (j+1)*n/m_chunks, diagShifted, m_numIters(j));
+  }
+
+  BDCSVD& m_svd;
+  const ArrayRef& m_col0;
+  const ArrayRef& m_diag;
+  const IndicesRef& m_perm;
+  VectorType& m_singVals;
+  ArrayRef& m_shifts;
+  ArrayRef& m_mus;
+  Index m_actual_n, m_chunks;
+  RealScalar* m_diagShifted;
+  Matrix<int,Dynamic,1>& m_numIters;
+};
+
+// The singular values are independent, so that they are computed concurrently for the largest subproblems when
+// multi-threading is enabled, each chunk of them using its own slice of the workspace.
+template <typename MatrixType>
+void BDCSVD<MatrixType>::computeSingVals(const ArrayRef& col0, const ArrayRef& diag, const IndicesRef &perm,
+                                         VectorType& singVals, ArrayRef shifts, ArrayRef mus, Workspace& workspace)
+{
   Index n = col0.size();
   Index actual_n = n;
   // Note that here actual_n is computed based on col0(i)==0 instead of diag(i)==0 as above
   // because 1) we have diag(i)==0 => col0(i)==0 and 2) if col0(i)==0, then diag(i) is already a singular value.
   while(actual_n>1 && col0(actual_n-1)==Literal(0)) --actual_n;
 
-  for (Index k = 0; k < n; ++k)
+  Index chunks = 1;
+#if defined(EIGEN_HAS_OPENMP) || defined(EIGEN_GEMM_THREADPOOL)
+  if(!internal::is_in_parallel_region())
+    chunks = (std::max)(Index(1), (std::min)(Index(nbThreads()), n/128));
+#endif
+  // the first 4n scalars of the workspace are used by computeSVDofM()
+  Matrix<int,Dynamic,1> numIters = Matrix<int,Dynamic,1>::Zero(chunks);
+  internal::parallel_for(SingValsTask(*this, col0, diag, perm, singVals, shifts, mus, actual_n, chunks, workspace.real + 4*n, numIters), chunks);
+  workspace.numIters += numIters.sum();
+}
+
+template <typename MatrixType>
+void BDCSVD<MatrixType>::computeSingValsRange(const ArrayRef& col0, const ArrayRef& diag, const IndicesRef &perm,
+                                              VectorType& singVals, ArrayRef shifts, ArrayRef mus, Index actual_n,
+                                              Index begin, Index end, ArrayRef diagShifted, int& numIters)
+{
+  using std::abs;
+  using std::swap;
+  using std::sqrt;
+
+  Index n = col0.size();
+  for (Index k = begin; k < end; ++k)
   {
     if (col0(k) == Literal(0) || actual_n==1)
     {
@@ -781,7 +941,6 @@ void BDCSVD<MatrixType>::computeSingVals(const ArrayRef& col0, const ArrayRef& d
     RealScalar shift = (k == actual_n-1 || fMid > Literal(0)) ? left : right;
     
     // measure everything relative to shift
-    Map<ArrayXr> diagShifted(m_workspace.data()+4*n, n);
     diagShifted = diag - shift;
     
     // initial guess
@@ -811,7 +970,7 @@ void BDCSVD<MatrixType>::computeSingVals(const ArrayRef& col0, const ArrayRef& d
     bool useBisection = fPrev*fCur>Literal(0);
     while (fCur!=Literal(0) && abs(muCur - muPrev) > Literal(8) * NumTraits<RealScalar>::epsilon() * numext::maxi<RealScalar>(abs(muCur), abs(muPrev)) && abs(fCur - fPrev)>NumTraits<RealScalar>::epsilon() && !useBisection)
     {
-      ++m_numIters;
+      ++numIters;
 
       // Find a and b such that the function f(mu) = a / mu + b matches the current and previous samples.
       RealScalar a = (fCur - fPrev) / (Literal(1)/muCur - Literal(1)/muPrev);
@@ -918,7 +1077,7 @@ void BDCSVD<MatrixType>::computeSingVals(const ArrayRef& col0, const ArrayRef& d
       std::cout << "found " << singVals[k] << " == " << shift << " + " << muCur << " from " << diag(k) << " .. "  << diag(k+1) << "\n";
 #endif
 #ifdef EIGEN_BDCSVD_SANITY_CHECKS
-    assert(k==0 || singVals[k]>=singVals[k-1]);
+    assert(k==begin || singVals[k]>=singVals[k-1]);
     assert(singVals[k]>=diag(k));
 #endif
 
@@ -1128,7 +1287,7 @@ void BDCSVD<MatrixType>::deflation44(Eigen::Index firstColu , Eigen::Index first
 
 // acts on block from (firstCol+shift, firstCol+shift) to (lastCol+shift, lastCol+shift) [inclusive]
 template <typename MatrixType>
-void BDCSVD<MatrixType>::deflation(Eigen::Index firstCol, Eigen::Index lastCol, Eigen::Index k, Eigen::Index firstRowW, Eigen::Index firstColW, Eigen::Index shift)
+void BDCSVD<MatrixType>::deflation(Eigen::Index firstCol, Eigen::Index lastCol, Eigen::Index k, Eigen::Index firstRowW, Eigen::Index firstColW, Eigen::Index shift, Workspace& workspace)
 {
   using std::sqrt;
   using std::abs;
@@ -1198,7 +1357,7 @@ void BDCSVD<MatrixType>::deflation(Eigen::Index firstCol, Eigen::Index lastCol,
     
     // Sort the diagonal entries, since diag(1:k-1) and diag(k:length) are already sorted, let's do a sorted merge.
     // First, compute the respective permutation.
-    Index *permutation = m_workspaceI.data();
+    Index *permutation = workspace.index;
     {
       permutation[0] = 0;
       Index p = 1;
@@ -1235,8 +1394,8 @@ void BDCSVD<MatrixType>::deflation(Eigen::Index firstCol, Eigen::Index lastCol,
     }
     
     // Current index of each col, and current column of each index
-    Index *realInd = m_workspaceI.data()+length;
-    Index *realCol = m_workspaceI.data()+2*length;
+    Index *realInd = workspace.index+length;
+    Index *realCol = workspace.index+2*length;
     
     for(int pos = 0; pos< length; pos++)
     {
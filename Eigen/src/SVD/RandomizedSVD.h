@@ -0,0 +1,269 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef EIGEN_RANDOMIZEDSVD_H
+#define EIGEN_RANDOMIZEDSVD_H
+
+namespace Eigen {
+
+template<typename _MatrixType> class RandomizedSVD;
+
+namespace internal {
+
+template<typename _MatrixType>
+struct traits<RandomizedSVD<_MatrixType> >
+{
+  // the singular vectors are dense whatever the type of the decomposed operator
+  typedef Matrix<typename _MatrixType::Scalar, Dynamic, Dynamic> MatrixType;
+};
+
+} // end namespace internal
+
+/** \ingroup SVD_Module
+  *
+  *
+  * \class RandomizedSVD
+  *
+  * \brief Truncated singular value decomposition by randomized subspace iteration
+  *
+  * \tparam _MatrixType the type of the matrix, or of the operator, of which we are computing the truncated SVD
+  *
+  * This class computes the \a k largest singular values of a n-by-p matrix \a A, and optionally the associated left
+  * and right singular vectors, with the randomized range finder of Halko, Martinsson and Tropp, "Finding structure
+  * with randomness", SIAM Review 53(2), 2011:
+  *  - the range of \a A is sampled by \f$ Y = A \Omega \f$, where \f$ \Omega \f$ is a p-by-l pseudo-random matrix
+  *    drawn from a PhiloxGenerator (see setSeed()), l being \a k plus an oversampling (10 by default, see
+  *    setOversampling()),
+  *  - the sample is refined by power iterations \f$ Y = A A^* Y \f$ (2 by default, see setPowerIterations()),
+  *    which amplify the decay of the singular values, the samples being orthonormalized by TallSkinnyQR after
+  *    each product,
+  *  - the SVD of the l-by-p matrix \f$ Q^* A \f$, where the columns of \a Q are an orthonormal basis of \a Y,
+  *    is computed by JacobiSVD, whose QR preconditioner first reduces it to a l-by-l matrix, and gives the SVD of
+  *    the approximation \f$ Q Q^* A \f$ of \a A.
+  *
+  * The cost is thus dominated by the \f$ 2q+2 \f$ products of \a A or \f$ A^* \f$ with dense n-by-l or p-by-l
+  * blocks, q being the number of power iterations, and no matrix larger than \a A itself is formed. These products
+  * are the only operations performed on \a A, so that \a _MatrixType can be a dense matrix, a SparseMatrix, or any
+  * operator providing rows(), cols(), and products \c A*X and \c A.adjoint()*X with dense matrices \c X.
+  *
+  * The computed singular values are lower bounds of the exact ones, and the approximation error is close to the
+  * (k+1)-th singular value when the singular values decay fast enough. Otherwise, a larger oversampling and more
+  * power iterations improve the accuracy.
+  *
+  * Only thin unitaries are available: \c matrixU() is n-by-k, \c matrixV() is p-by-k, and \c singularValues() has
+  * size k. \c solve() then returns the least-squares solution restricted to the span of the k dominant right singular
+  * vectors, which is a regularized solution of ill-posed problems.
+  *
+  * Example: \code
+  * SparseMatrix<double> A = ...;
+  * RandomizedSVD<SparseMatrix<double> > svd(A, 20, ComputeThinU | ComputeThinV);
+  * MatrixXd scores = svd.matrixU() * svd.singularValues().asDiagonal();
+  * \endcode
+  *
+  * \sa class BDCSVD, class JacobiSVD
+  */
+template<typename _MatrixType>
+class RandomizedSVD : public SVDBase<RandomizedSVD<_MatrixType> >
+{
+  typedef SVDBase<RandomizedSVD> Base;
+
+public:
+  using Base::rows;
+  using Base::cols;
+  using Base::computeU;
+  using Base::computeV;
+
+  typedef _MatrixType MatrixType;
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef Matrix<Scalar, Dynamic, Dynamic> DenseMatrixType;
+
+  typedef typename Base::MatrixUType MatrixUType;
+  typedef typename Base::MatrixVType MatrixVType;
+  typedef typename Base::SingularValuesType SingularValuesType;
+
+  /** \brief Default Constructor.
+   *
+   * The default constructor is useful in cases in which the user intends to
+   * perform decompositions via RandomizedSVD::compute(const MatrixType&, Index, unsigned int).
+   */
+  RandomizedSVD() : m_oversampling(10), m_powerIterations(2), m_seed(0)
+  {}
+
+  /** \brief Constructor performing the decomposition of given matrix.
+   *
+   * \param matrix the matrix, or operator, to decompose
+   * \param rank the number \a k of singular values to compute
+   * \param computationOptions optional parameter allowing to specify if you want the thin U or V to be computed.
+   *                           By default, none is computed. This is a bit-field, the possible bits are #ComputeThinU,
+   *                           #ComputeThinV.
+   */
+  RandomizedSVD(const MatrixType& matrix, Index rank, unsigned int computationOptions = 0)
+    : m_oversampling(10), m_powerIterations(2), m_seed(0)
+  {
+    compute(matrix, rank, computationOptions);
+  }
+
+  /** \brief Method performing the decomposition of given matrix.
+   *
+   * \param matrix the matrix, or operator, to decompose
+   * \param rank the number \a k of singular values to compute, which is bounded by the minimum of the number of rows
+   *             and of columns of \a matrix
+   * \param computationOptions optional parameter allowing to specify if you want the thin U or V to be computed.
+   *                           By default, none is computed. This is a bit-field, the possible bits are #ComputeThinU,
+   *                           #ComputeThinV.
+   */
+  RandomizedSVD& compute(const MatrixType& matrix, Index rank, unsigned int computationOptions);
+
+  /** \brief Method performing the decomposition of given matrix using current options.
+   *
+   * This method uses the current \a computationOptions, as already passed to the constructor or to
+   * compute(const MatrixType&, Index, unsigned int).
+   */
+  RandomizedSVD& compute(const MatrixType& matrix, Index rank)
+  {
+    return compute(matrix, rank, this->m_computationOptions);
+  }
+
+  /** Sets the number of samples of the range of the matrix in excess of the number of singular values to compute,
+    * 10 by default. */
+  RandomizedSVD& setOversampling(Index oversampling)
+  {
+    eigen_assert(oversampling >= 0);
+    m_oversampling = oversampling;
+    return *this;
+  }
+
+  /** \returns the number of samples in excess of the number of singular values, see setOversampling() */
+  Index oversampling() const { return m_oversampling; }
+
+  /** Sets the number of power iterations, 2 by default. Each of them costs a product by the matrix and one by its
+    * adjoint, and improves the accuracy when the singular values decay slowly. */
+  RandomizedSVD& setPowerIterations(Index iterations)
+  {
+    eigen_assert(iterations >= 0);
+    m_powerIterations = iterations;
+    return *this;
+  }
+
+  /** \returns the number of power iterations, see setPowerIterations() */
+  Index powerIterations() const { return m_powerIterations; }
+
+  /** Sets the seed of the PhiloxGenerator drawing the random sample matrix, 0 by default. Each call to compute()
+    * draws the sample from a generator constructed from this seed, so that the decomposition is reproducible, and
+    * does not alter the state of std::rand(). */
+  RandomizedSVD& setSeed(unsigned int seed)
+  {
+    m_seed = seed;
+    return *this;
+  }
+
+  /** \returns the seed of the random sample matrix, see setSeed() */
+  unsigned int seed() const { return m_seed; }
+
+private:
+  void allocate(Index rows, Index cols, Index rank, unsigned int computationOptions);
+  void orthonormalize(DenseMatrixType& basis);
+
+protected:
+  TallSkinnyQR<DenseMatrixType> m_qr;
+  Index m_oversampling, m_powerIterations;
+  unsigned int m_seed;
+
+  using Base::m_singularValues;
+  using Base::m_diagSize;
+  using Base::m_computeFullU;
+  using Base::m_computeFullV;
+  using Base::m_computeThinU;
+  using Base::m_computeThinV;
+  using Base::m_matrixU;
+  using Base::m_matrixV;
+  using Base::m_isInitialized;
+  using Base::m_isAllocated;
+  using Base::m_computationOptions;
+  using Base::m_nonzeroSingularValues;
+  using Base::m_rows;
+  using Base::m_cols;
+};
+
+// Unlike SVDBase::allocate(), the singular values and vectors are only allocated for the rank first ones
+template<typename MatrixType>
+void RandomizedSVD<MatrixType>::allocate(Index rows, Index cols, Index rank, unsigned int computationOptions)
+{
+  eigen_assert(rows >= 0 && cols >= 0 && rank >= 0);
+  m_rows = rows;
+  m_cols = cols;
+  m_isInitialized = false;
+  m_isAllocated = true;
+  m_computationOptions = computationOptions;
+  m_computeFullU = (computationOptions & ComputeFullU) != 0;
+  m_computeThinU = (computationOptions & ComputeThinU) != 0;
+  m_computeFullV = (computationOptions & ComputeFullV) != 0;
+  m_computeThinV = (computationOptions & ComputeThinV) != 0;
+  eigen_assert(!m_computeFullU && !m_computeFullV && "RandomizedSVD: only thin U and V are available");
+
+  m_diagSize = (std::min)(m_rows, m_cols);
+  rank = (std::min)(rank, m_diagSize);
+  m_singularValues.resize(rank);
+  m_matrixU.resize(m_rows, m_computeThinU ? rank : 0);
+  m_matrixV.resize(m_cols, m_computeThinV ? rank : 0);
+}
+
+// Replaces the columns of basis by an orthonormal basis of their span, which is the thin Q factor of their QR
+// decomposition: unlike Gram-Schmidt, it remains orthonormal when the columns are linearly dependent.
+template<typename MatrixType>
+void RandomizedSVD<MatrixType>::orthonormalize(DenseMatrixType& basis)
+{
+  m_qr.compute(basis);
+  basis.setIdentity();
+  m_qr.applyQOnTheLeft(basis);
+}
+
+template<typename MatrixType>
+RandomizedSVD<MatrixType>& RandomizedSVD<MatrixType>::compute(const MatrixType& matrix, Index rank, unsigned int computationOptions)
+{
+  allocate(matrix.rows(), matrix.cols(), rank, computationOptions);
+  const Index k = m_singularValues.size();
+  const Index l = (std::min)(k + m_oversampling, m_diagSize);
+  if(l == 0)
+  {
+    m_nonzeroSingularValues = 0;
+    m_isInitialized = true;
+    return *this;
+  }
+
+  // orthonormal bases of the samples of the ranges of A and of A^*
+  PhiloxGenerator generator(m_seed);
+  DenseMatrixType range(m_rows, l), corange = DenseMatrixType::Random(m_cols, l, generator);
+  range.noalias() = matrix * corange;
+  orthonormalize(range);
+  for(Index i = 0; i < m_powerIterations; ++i)
+  {
+    corange.noalias() = matrix.adjoint() * range;
+    orthonormalize(corange);
+    range.noalias() = matrix * corange;
+    orthonormalize(range);
+  }
+
+  // Q^* A is the adjoint of A^* Q = U_B S V_B^*, so that Q Q^* A = (Q V_B) S U_B^*. As l is small, JacobiSVD is
+  // cheap, and it remains accurate when A^* Q is rank deficient, which is the case when the rank of A is below l.
+  corange.noalias() = matrix.adjoint() * range;
+  JacobiSVD<DenseMatrixType> svd(corange, (computeU() ? ComputeThinV : 0) | (computeV() ? ComputeThinU : 0));
+  m_singularValues = svd.singularValues().head(k);
+  if(computeU()) m_matrixU.noalias() = range * svd.matrixV().leftCols(k);
+  if(computeV()) m_matrixV = svd.matrixU().leftCols(k);
+
+  m_nonzeroSingularValues = k;
+  while(m_nonzeroSingularValues > 0 && m_singularValues(m_nonzeroSingularValues-1) < (std::numeric_limits<RealScalar>::min)())
+    --m_nonzeroSingularValues;
+  m_isInitialized = true;
+  return *this;
+}
+
+} // end namespace Eigen
+
+#endif // EIGEN_RANDOMIZEDSVD_H
@@ -0,0 +1,77 @@
+
+// Measures the scaling of the parallel matrix-matrix product from 1 thread up to the given maximal
+// number of threads (default 128), for square, tall-skinny, short-wide and deep products.
+//
+// g++ bench_gemm_scaling.cpp -I .. -O3 -DNDEBUG -march=native -fopenmp -o bench_gemm_scaling && ./bench_gemm_scaling
+// g++ bench_gemm_scaling.cpp -I .. -O3 -DNDEBUG -march=native -std=c++11 -pthread -DEIGEN_GEMM_THREADPOOL -o bench_gemm_scaling && ./bench_gemm_scaling
+//
+// Usage: ./bench_gemm_scaling [max threads] [size]
+// For reproducible results on NUMA machines, pin the threads, e.g. with OMP_PROC_BIND=close OMP_PLACES=cores.
+
+#include <iostream>
+#include <cstdlib>
+#include <Eigen/Core>
+#include <bench/BenchTimer.h>
+#ifdef EIGEN_GEMM_THREADPOOL
+#include <unsupported/Eigen/CXX11/ThreadPool>
+#endif
+
+using namespace std;
+using namespace Eigen;
+
+#ifndef SCALAR
+#define SCALAR double
+#endif
+
+typedef SCALAR Scalar;
+typedef Matrix<Scalar,Dynamic,Dynamic> Mat;
+
+void bench_shape(const char* name, Index m, Index n, Index k, int max_threads, int tries, int rep)
+{
+  Mat a = Mat::Random(m,k);
+  Mat b = Mat::Random(k,n);
+  Mat c = Mat::Zero(m,n);
+  double flops = 2. * double(m) * double(n) * double(k) * rep;
+
+  cout << name << " " << m << "x" << k << " * " << k << "x" << n << "\n";
+  double t1 = 0;
+  for(int threads=1; threads<=max_threads; threads*=2)
+  {
+#ifdef EIGEN_GEMM_THREADPOOL
+    ThreadPool pool(threads);
+    setGemmThreadPool(&pool);
+#else
+    setNbThreads(threads);
+#endif
+    BenchTimer t;
+    BENCH(t, tries, rep, c.noalias() += a*b);
+    if(threads==1)
+      t1 = t.best(REAL_TIMER);
+    cout << "  " << threads << " threads:\t" << t.best(REAL_TIMER)/rep << "s\t" << flops/t.best(REAL_TIMER)*1e-9 << " GFLOPS\t"
+         << "speedup x" << t1/t.best(REAL_TIMER) << " (" << 100.*t1/t.best(REAL_TIMER)/threads << "%)\n";
+#ifdef EIGEN_GEMM_THREADPOOL
+    setGemmThreadPool(0);
+#endif
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  int max_threads = argc>1 ? atoi(argv[1]) : 128;
+  Index s = argc>2 ? atoi(argv[2]) : 4096;
+  int tries = 3;
+  int rep = 1;
+
+  std::ptrdiff_t l1 = internal::queryL1CacheSize();
+  std::ptrdiff_t l2 = internal::queryTopLevelCacheSize();
+  cout << "L1 cache size     = " << (l1>0 ? l1/1024 : -1) << " KB\n";
+  cout << "L2/L3 cache size  = " << (l2>0 ? l2/1024 : -1) << " KB\n";
+  cout << "Max threads per packed lhs (EIGEN_GEMM_MAX_GROUP_THREADS) = " << EIGEN_GEMM_MAX_GROUP_THREADS << "\n";
+
+  bench_shape("square    ", s, s, s, max_threads, tries, rep);
+  bench_shape("tall-skinny", 16*s, 64, s/4, max_threads, tries, rep);
+  bench_shape("short-wide", 64, 16*s, s/4, max_threads, tries, rep);
+  bench_shape("deep      ", 256, 256, 64*s, max_threads, tries, rep);
+
+  return 0;
+}
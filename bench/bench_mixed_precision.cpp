@@ -0,0 +1,48 @@
+// Compares the mixed-precision solver, which factorizes in single precision and refines the solution in double
+// precision, with the double precision PartialPivLU, for well conditioned systems of increasing sizes.
+//
+// g++ bench_mixed_precision.cpp -I .. -O3 -DNDEBUG -mavx2 -mfma -fopenmp -o bench_mixed_precision && ./bench_mixed_precision
+//
+// Usage: ./bench_mixed_precision [max size] [number of right-hand sides]
+
+#include <iostream>
+#include <cstdlib>
+#include <Eigen/Dense>
+#include <bench/BenchTimer.h>
+
+using namespace std;
+using namespace Eigen;
+
+void bench_size(Index n, Index nrhs, int tries)
+{
+  MatrixXd a = MatrixXd::Random(n, n) + double(n) * MatrixXd::Identity(n, n) * 0.1;
+  MatrixXd b = MatrixXd::Random(n, nrhs);
+  MatrixXd x(n, nrhs);
+
+  BenchTimer tDouble, tMixed;
+  double errDouble = 0, errMixed = 0;
+  Index iterations = 0;
+  bool fallback = false;
+
+  BENCH(tDouble, tries, 1, { PartialPivLU<MatrixXd> lu(a); x = lu.solve(b); });
+  errDouble = (a * x - b).norm() / b.norm();
+
+  BENCH(tMixed, tries, 1, { MixedPrecisionSolver<MatrixXd> solver(a); x = solver.solve(b);
+                            iterations = solver.iterations(); fallback = solver.usesFallback(); });
+  errMixed = (a * x - b).norm() / b.norm();
+
+  cout << n << "\t" << tDouble.best() << "\t" << tMixed.best() << "\t" << tDouble.best() / tMixed.best()
+       << "\t" << iterations << (fallback ? " (fallback)" : "") << "\t" << errDouble << "\t" << errMixed << endl;
+}
+
+int main(int argc, char** argv)
+{
+  Index max_size = argc > 1 ? atoi(argv[1]) : 4096;
+  Index nrhs = argc > 2 ? atoi(argv[2]) : 1;
+  int tries = 3;
+
+  cout << "size\tPartialPivLU<MatrixXd>\tMixedPrecisionSolver\tspeedup\titerations\tresidual(double)\tresidual(mixed)" << endl;
+  for(Index n = 128; n <= max_size; n *= 2)
+    bench_size(n, nrhs, tries);
+  return 0;
+}
@@ -0,0 +1,152 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define EIGEN_ALLOCATOR_HOOK
+#include "main.h"
+
+template<int Id> struct counting_hook
+{
+  static Index allocations;
+  static Index live;
+
+  static void* allocate(std::size_t size)
+  {
+    ++allocations;
+    ++live;
+    return internal::handmade_aligned_malloc(size);
+  }
+
+  static void deallocate(void* ptr)
+  {
+    if(ptr)
+      --live;
+    internal::handmade_aligned_free(ptr);
+  }
+
+  static const AllocatorHook* get()
+  {
+    static const AllocatorHook hook = { allocate, deallocate };
+    return &hook;
+  }
+};
+
+template<int Id> Index counting_hook<Id>::allocations = 0;
+template<int Id> Index counting_hook<Id>::live = 0;
+
+void allocator_hook_global()
+{
+  typedef counting_hook<0> Hook;
+  VERIFY(setAllocatorHook(Hook::get()) == 0);
+  {
+    MatrixXd a = MatrixXd::Random(300, 300), b = MatrixXd::Random(300, 300);
+    VERIFY(Hook::allocations >= 2);
+    Index before = Hook::allocations;
+    // the blocking buffers of the product go through the hook as well
+    MatrixXd c = a * b;
+    VERIFY(Hook::allocations >= before + 2);
+    VERIFY_IS_APPROX(c, a.lazyProduct(b));
+
+    VectorXd v = VectorXd::LinSpaced(100, 0, 99);
+    v.conservativeResize(200);
+    VERIFY_IS_EQUAL(v.head(100), VectorXd::LinSpaced(100, 0, 99));
+    v.conservativeResize(50);
+    VERIFY_IS_EQUAL(v, VectorXd::LinSpaced(50, 0, 49));
+  }
+  VERIFY_IS_EQUAL(Hook::live, 0);
+  VERIFY(setAllocatorHook(0) == Hook::get());
+}
+
+void allocator_hook_per_type()
+{
+  typedef counting_hook<1> FloatHook;
+  typedef counting_hook<2> GlobalHook;
+  setAllocatorHook(GlobalHook::get());
+  VERIFY(setAllocatorHook<float>(FloatHook::get()) == 0);
+  {
+    MatrixXf a = MatrixXf::Random(50, 60);
+    VERIFY_IS_EQUAL(FloatHook::allocations, 1);
+    VERIFY_IS_EQUAL(GlobalHook::allocations, 0);
+
+    MatrixXd b = MatrixXd::Random(50, 60);
+    VERIFY_IS_EQUAL(FloatHook::allocations, 1);
+    VERIFY_IS_EQUAL(GlobalHook::allocations, 1);
+
+    // storage without alignment requirements is not hooked
+    Matrix<float,Dynamic,Dynamic,DontAlign> c = a;
+    VERIFY_IS_EQUAL(FloatHook::allocations, 1);
+    VERIFY_IS_EQUAL(GlobalHook::allocations, 1);
+
+    a.conservativeResize(70, 70);
+    VERIFY_IS_EQUAL(a.block(0, 0, 50, 60), c);
+    VERIFY_IS_EQUAL(FloatHook::allocations, 2);
+  }
+  VERIFY_IS_EQUAL(FloatHook::live, 0);
+  VERIFY_IS_EQUAL(GlobalHook::live, 0);
+  VERIFY(setAllocatorHook<float>(0) == FloatHook::get());
+  setAllocatorHook(0);
+}
+
+void allocator_hook_huge_pages(bool parallelFirstTouch)
+{
+  const AllocatorHook* hook = hugePageAllocatorHook(parallelFirstTouch);
+  VERIFY(setAllocatorHook<double>(hook) == 0);
+  {
+    // 8MB, placed on huge pages
+    MatrixXd a = MatrixXd::Random(1024, 1024);
+    VERIFY_IS_EQUAL(std::size_t(a.data()) % EIGEN_HUGE_PAGE_SIZE, std::size_t(0));
+    MatrixXd small = MatrixXd::Random(10, 10);
+    VERIFY_IS_EQUAL(std::size_t(small.data()) % EIGEN_DEFAULT_ALIGN_BYTES, std::size_t(0));
+    VectorXd v = VectorXd::Random(1024);
+    VectorXd ref = a.lazyProduct(v);
+    VERIFY_IS_APPROX(a * v, ref);
+    a.conservativeResize(2048, 1024);
+    VERIFY_IS_EQUAL(std::size_t(a.data()) % EIGEN_HUGE_PAGE_SIZE, std::size_t(0));
+    VERIFY_IS_APPROX(a.topRows(1024) * v, ref);
+  }
+  VERIFY(setAllocatorHook<double>(0) == hook);
+}
+
+// the buffers are freed by the allocator which allocated them, whatever the hooks installed in the meantime
+void allocator_hook_ownership()
+{
+  typedef counting_hook<3> Hook;
+  MatrixXd before = MatrixXd::Random(100, 100);
+  VectorXd grown = VectorXd::LinSpaced(100, 0, 99);
+  VERIFY(setAllocatorHook(Hook::get()) == 0);
+  MatrixXd during = MatrixXd::Random(100, 100);
+  VERIFY_IS_EQUAL(Hook::live, 1);
+  before.resize(0, 0);
+  VERIFY_IS_EQUAL(Hook::live, 1);
+  grown.conservativeResize(200);
+  VERIFY_IS_EQUAL(grown.head(100), VectorXd::LinSpaced(100, 0, 99));
+  VERIFY_IS_EQUAL(Hook::live, 2);
+
+  VERIFY(setAllocatorHook(0) == Hook::get());
+  during.resize(0, 0);
+  VERIFY_IS_EQUAL(Hook::live, 1);
+  grown.conservativeResize(50);
+  VERIFY_IS_EQUAL(grown, VectorXd::LinSpaced(50, 0, 49));
+  VERIFY_IS_EQUAL(Hook::live, 0);
+
+  // large buffers living across the installation and the removal of the huge page policy
+  MatrixXd large = MatrixXd::Random(1024, 1024);
+  VERIFY(setAllocatorHook<double>(hugePageAllocatorHook()) == 0);
+  MatrixXd huge = MatrixXd::Random(1024, 1024);
+  VERIFY_IS_EQUAL(std::size_t(huge.data()) % EIGEN_HUGE_PAGE_SIZE, std::size_t(0));
+  large.resize(0, 0);
+  VERIFY(setAllocatorHook<double>(0) == hugePageAllocatorHook());
+  huge.resize(0, 0);
+}
+
+void test_allocator_hook()
+{
+  CALL_SUBTEST_1( allocator_hook_global() );
+  CALL_SUBTEST_1( allocator_hook_per_type() );
+  CALL_SUBTEST_2( allocator_hook_huge_pages(false) );
+  CALL_SUBTEST_2( allocator_hook_huge_pages(true) );
+  CALL_SUBTEST_3( allocator_hook_ownership() );
+}
@@ -0,0 +1,115 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define EIGEN_GEMM_THREADPOOL
+#define EIGEN_PARALLELIZE_ASSIGNMENT
+// split even small assignments
+#define EIGEN_ASSIGNMENT_MIN_TASK_COST 64
+#include "main.h"
+#include <unsupported/Eigen/CXX11/ThreadPool>
+
+// a functor without packet access
+struct cube_op {
+  template<typename Scalar> Scalar operator()(const Scalar& x) const { return x*x*x; }
+};
+
+// the coefficient-wise expressions are evaluated on a single thread first, and compared exactly
+template<typename MatrixType> void assign_threaded(const MatrixType& m)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef Matrix<Scalar,Dynamic,Dynamic,MatrixType::IsRowMajor ? ColMajor : RowMajor> OtherMatrixType;
+
+  Index rows = m.rows();
+  Index cols = m.cols();
+  MatrixType a = MatrixType::Random(rows, cols);
+  MatrixType b = MatrixType::Random(rows, cols);
+  MatrixType c = MatrixType::Random(rows, cols).cwiseAbs();
+  OtherMatrixType oa = a;
+  VectorType v = VectorType::Random(rows*cols);
+  VectorType w = VectorType::Random(rows*cols);
+  Index r = internal::random<Index>(0,rows-1), nr = internal::random<Index>(1,rows-r);
+  Index o = internal::random<Index>(0,3);
+
+  ThreadPoolInterface* pool = setGemmThreadPool(0);
+  MatrixType ref1 = a.array()*b.array() + c.array().sqrt();
+  MatrixType ref2 = a + oa;
+  MatrixType ref3 = a.unaryExpr(cube_op());
+  VectorType ref4 = v;
+  ref4.tail(v.size()-o) += Scalar(2)*w.head(v.size()-o);
+  MatrixType ref5 = b;
+  ref5.middleRows(r,nr) = a.middleRows(r,nr) - c.middleRows(r,nr);
+  unsigned int seed = internal::random<unsigned int>();
+  PhiloxGenerator gen(seed);
+  MatrixType ref6 = MatrixType::RandomNormal(rows, cols, gen);
+  setGemmThreadPool(pool);
+
+  MatrixType res = a.array()*b.array() + c.array().sqrt();     // linear vectorized
+  VERIFY_IS_EQUAL(res, ref1);
+  res = a + oa;                                                   // default traversal
+  VERIFY_IS_EQUAL(res, ref2);
+  res = a.unaryExpr(cube_op());           // linear traversal
+  VERIFY_IS_EQUAL(res, ref3);
+  VectorType resv = v;
+  resv.tail(v.size()-o) += Scalar(2)*w.head(v.size()-o);          // unaligned destination
+  VERIFY_IS_EQUAL(resv, ref4);
+  res = b;
+  res.middleRows(r,nr) = a.middleRows(r,nr) - c.middleRows(r,nr); // slice vectorized
+  VERIFY_IS_EQUAL(res, ref5);
+
+  // random generators are not evaluated concurrently
+  res = MatrixType::Random(rows, cols);
+  VERIFY((res.array().abs() <= RealScalar(2)).all());
+
+  // including when they are nested in other expressions
+  std::srand(seed);
+  pool = setGemmThreadPool(0);
+  MatrixType ref7 = a + MatrixType::Random(rows, cols).cwiseAbs();
+  MatrixType ref8 = Scalar(2) * MatrixType::Random(cols, rows).transpose();
+  setGemmThreadPool(pool);
+  std::srand(seed);
+  res = a + MatrixType::Random(rows, cols).cwiseAbs();
+  VERIFY_IS_EQUAL(res, ref7);
+  res = Scalar(2) * MatrixType::Random(cols, rows).transpose();
+  VERIFY_IS_EQUAL(res, ref8);
+
+  // unless their coefficients only depend on their index
+  gen.seed(seed);
+  res.setRandomNormal(gen);
+  VERIFY_IS_EQUAL(res, ref6);
+}
+
+void assign_threaded_fixed_inner()
+{
+  typedef Matrix<float,4,Dynamic> MatrixType;
+  Index cols = internal::random<Index>(1,10000);
+  MatrixType a = MatrixType::Random(4,cols), b = MatrixType::Random(4,cols);
+  ThreadPoolInterface* pool = setGemmThreadPool(0);
+  MatrixType ref = a.cwiseMax(b);
+  setGemmThreadPool(pool);
+  MatrixType res = a.cwiseMax(b);                                // inner vectorized
+  VERIFY_IS_EQUAL(res, ref);
+  Matrix<float,3,Dynamic> res3 = a.topRows<3>() + b.bottomRows<3>();
+  VERIFY_IS_APPROX(res3, (a.topRows<3>() + b.bottomRows<3>()).eval());
+}
+
+void test_assign_threaded()
+{
+  ThreadPool pool(internal::random<int>(2,16));
+  setGemmThreadPool(&pool);
+
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( assign_threaded(MatrixXf(internal::random<int>(1,10*EIGEN_TEST_MAX_SIZE), internal::random<int>(1,10*EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_2( assign_threaded(MatrixXd(internal::random<int>(1,10*EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_3( assign_threaded(Matrix<double,Dynamic,Dynamic,RowMajor>(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,10*EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_4( assign_threaded(MatrixXcf(internal::random<int>(1,5*EIGEN_TEST_MAX_SIZE), internal::random<int>(1,5*EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_5( assign_threaded_fixed_inner() );
+  }
+
+  setGemmThreadPool(0);
+}
@@ -471,6 +471,72 @@ void cholesky_faillure_cases()
   }
 }
 
+template<typename MatrixType, int UpLo> void cholesky_ldlt_blocked_check(const MatrixType& A, bool samePivots)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  const Index size = A.rows();
+
+  LDLT<MatrixType,UpLo> ldlt(A);
+  MatrixType ref = A;
+  Transpositions<Dynamic> transpositions(size);
+  VectorType temp(size);
+  internal::SignMatrix sign = internal::ZeroSign;
+  bool ok = internal::ldlt_inplace<UpLo>::unblocked(ref, transpositions, temp, sign);
+
+  VERIFY_IS_APPROX(A, ldlt.reconstructedMatrix());
+  // with zero pivots, the rounding errors may change the pivots, and the detection of failures
+  if(samePivots)
+  {
+    VERIFY_IS_EQUAL(ldlt.info(), ok ? Success : NumericalIssue);
+    VERIFY(ldlt.transpositionsP().indices() == transpositions.indices());
+    VERIFY_IS_APPROX(ldlt.vectorD(), ref.diagonal());
+    VERIFY_IS_APPROX(MatrixType(ldlt.matrixLDLT().template triangularView<UpLo>()), MatrixType(ref.template triangularView<UpLo>()));
+    VERIFY_IS_EQUAL(ldlt.isPositive(), sign==internal::PositiveSemiDef || sign==internal::ZeroSign);
+    VERIFY_IS_EQUAL(ldlt.isNegative(), sign==internal::NegativeSemiDef || sign==internal::ZeroSign);
+    RealScalar rcond = (RealScalar(1) / matrix_l1_norm<MatrixType, Lower>(A)) /
+                        matrix_l1_norm<MatrixType, Lower>(MatrixType(ldlt.solve(MatrixType::Identity(size, size))));
+    VERIFY(ldlt.rcond() > rcond / 10 && ldlt.rcond() < rcond * 10);
+  }
+
+  VectorType x = VectorType::Random(size), b = A * x;
+  VERIFY_IS_APPROX(A * ldlt.solve(b), b);
+}
+
+template<typename MatrixType> void cholesky_ldlt_blocked(Index size)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef Matrix<RealScalar,Dynamic,1> RealVectorType;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+
+  // positive definite and indefinite matrices, large enough for several panels
+  MatrixType a = MatrixType::Random(size, size);
+  MatrixType spd = a * a.adjoint() + MatrixType::Identity(size, size);
+  cholesky_ldlt_blocked_check<MatrixType,Lower>(spd, true);
+  cholesky_ldlt_blocked_check<MatrixType,Upper>(spd, true);
+  RealVectorType d = RealVectorType::Random(size);
+  MatrixType indefinite = a * d.template cast<Scalar>().asDiagonal() * a.adjoint();
+  cholesky_ldlt_blocked_check<MatrixType,Lower>(indefinite, true);
+  cholesky_ldlt_blocked_check<MatrixType,Upper>(-indefinite, true);
+
+  // semidefinite matrices whose zero pivots show up in the middle of a panel
+  MatrixType b = MatrixType::Random(size, internal::random<Index>(size/3, size-1));
+  cholesky_ldlt_blocked_check<MatrixType,Lower>(MatrixType(b * b.adjoint()), false);
+  MatrixType zeroPivots = spd;
+  zeroPivots.bottomRightCorner(size/2, size/2).setZero();
+  zeroPivots.bottomLeftCorner(size/2, size-size/2).setZero();
+  zeroPivots.topRightCorner(size-size/2, size/2).setZero();
+  cholesky_ldlt_blocked_check<MatrixType,Lower>(zeroPivots, false);
+
+  // updates of a blocked factorization
+  LDLT<MatrixType> ldlt(spd);
+  VectorType w = VectorType::Random(size);
+  ldlt.rankUpdate(w);
+  VERIFY_IS_APPROX(ldlt.reconstructedMatrix(), MatrixType(spd + w * w.adjoint()));
+}
+
 template<typename MatrixType> void cholesky_verify_assert()
 {
   MatrixType tmp;
@@ -511,6 +577,9 @@ void test_cholesky()
     TEST_SET_BUT_UNUSED_VARIABLE(s)
   }
 
+  CALL_SUBTEST_2( cholesky_ldlt_blocked<MatrixXd>(internal::random<int>(100,400)) );
+  CALL_SUBTEST_6( cholesky_ldlt_blocked<MatrixXcd>(internal::random<int>(100,200)) );
+
   CALL_SUBTEST_4( cholesky_verify_assert<Matrix3f>() );
   CALL_SUBTEST_7( cholesky_verify_assert<Matrix3d>() );
   CALL_SUBTEST_8( cholesky_verify_assert<MatrixXf>() );
@@ -191,6 +191,203 @@ template<typename MatrixType> void selfadjointeigensolver(const MatrixType& m)
   }
 }
 
+template<typename MatrixType> void selfadjointeigensolver_two_stage(Index size, Index bandwidth)
+{
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef Matrix<RealScalar,Dynamic,1> RealVectorType;
+
+  MatrixType a = MatrixType::Random(size,size);
+  MatrixType symmA = a.adjoint() * a;
+
+  MatrixType q = symmA;
+  RealVectorType diag(size), subdiag(size-1);
+  internal::tridiagonalization_two_stage_inplace(q, diag, subdiag, true, bandwidth);
+  MatrixType t = MatrixType::Zero(size,size);
+  t.diagonal() = diag.template cast<typename MatrixType::Scalar>();
+  t.diagonal(-1) = subdiag.template cast<typename MatrixType::Scalar>();
+  t.diagonal(1) = subdiag.template cast<typename MatrixType::Scalar>();
+  VERIFY_IS_UNITARY(q);
+  VERIFY_IS_APPROX(q * t * q.adjoint(), symmA);
+
+  // without Q, and only the lower triangular part referenced
+  MatrixType lower = symmA.template triangularView<Lower>();
+  RealVectorType diag2(size), subdiag2(size-1);
+  internal::tridiagonalization_two_stage_inplace(lower, diag2, subdiag2, false, bandwidth);
+  VERIFY_IS_APPROX(diag2, diag);
+  VERIFY_IS_APPROX(subdiag2, subdiag);
+
+  SelfAdjointEigenSolver<MatrixType> eig(symmA);
+  SelfAdjointEigenSolver<MatrixType> eigT;
+  eigT.computeFromTridiagonal(diag, subdiag, EigenvaluesOnly);
+  VERIFY_IS_APPROX(eigT.eigenvalues(), eig.eigenvalues());
+}
+
+template<int>
+void selfadjointeigensolver_two_stage_large()
+{
+  // above EIGEN_TRIDIAGONALIZATION_TWO_STAGE_THRESHOLD, the eigenvalues only are computed in two stages
+  Index size = EIGEN_TRIDIAGONALIZATION_TWO_STAGE_THRESHOLD + internal::random<int>(0,10);
+  MatrixXd a = MatrixXd::Random(size,size);
+  MatrixXd symmA = a.transpose() * a;
+  SelfAdjointEigenSolver<MatrixXd> eig(symmA);
+  SelfAdjointEigenSolver<MatrixXd> eigValues(symmA, EigenvaluesOnly);
+  VERIFY_IS_EQUAL(eigValues.info(), Success);
+  VERIFY_IS_APPROX(eigValues.eigenvalues(), eig.eigenvalues());
+}
+
+template<typename MatrixType> void selfadjointeigensolver_divide_conquer(Index size)
+{
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef Matrix<RealScalar,Dynamic,1> RealVectorType;
+  typedef Matrix<RealScalar,Dynamic,Dynamic> RealMatrixType;
+
+  // above EIGEN_SELFADJOINT_DIVIDE_CONQUER_THRESHOLD
+  MatrixType a = MatrixType::Random(size,size);
+  MatrixType symmA = a.adjoint() + a;
+  SelfAdjointEigenSolver<MatrixType> eig(symmA);
+  VERIFY_IS_EQUAL(eig.info(), Success);
+  VERIFY_IS_APPROX(symmA * eig.eigenvectors(), eig.eigenvectors() * eig.eigenvalues().asDiagonal());
+  VERIFY_IS_UNITARY(eig.eigenvectors());
+  VERIFY_IS_APPROX(eig.eigenvalues(), SelfAdjointEigenSolver<MatrixType>(symmA, EigenvaluesOnly).eigenvalues());
+
+  // tridiagonal matrices with many deflations: clusters of eigenvalues, zero and tiny sub-diagonal entries,
+  // and leaves of a few rows
+  Index n = internal::random<Index>(2,100);
+  for(int k = 0; k < 4; ++k)
+  {
+    RealVectorType diag = RealVectorType::Random(n), subdiag = RealVectorType::Random(n-1);
+    if(k==1) diag.setOnes();
+    if(k==2) subdiag.setConstant(RealScalar(1e-20));
+    if(k==3)
+    {
+      // glued Wilkinson matrices
+      for(Index i = 0; i < n; ++i)
+        diag(i) = RealScalar(std::abs(int(i%21) - 10));
+      subdiag.setOnes();
+      for(Index i = 20; i < n-1; i += 21)
+        subdiag(i) = RealScalar(1e-10);
+    }
+    for(Index i = 0; i < n-1; i += internal::random<Index>(2,n))
+      subdiag(i) = 0;
+    RealMatrixType t = RealMatrixType::Zero(n,n);
+    t.diagonal() = diag;
+    t.diagonal(-1) = subdiag;
+    t.diagonal(1) = subdiag;
+
+    RealVectorType eivals = diag;
+    RealMatrixType eivecs;
+    ComputationInfo info = internal::tridiagonal_divide_conquer(eivals, subdiag, 30, eivecs, internal::random<Index>(1,8));
+    VERIFY_IS_EQUAL(info, Success);
+    VERIFY((eivals.tail(n-1) - eivals.head(n-1)).minCoeff() >= RealScalar(0));
+    VERIFY_IS_APPROX(t * eivecs, eivecs * eivals.asDiagonal());
+    VERIFY_IS_UNITARY(eivecs);
+
+    SelfAdjointEigenSolver<RealMatrixType> ref;
+    ref.computeFromTridiagonal(diag, subdiag, EigenvaluesOnly);
+    VERIFY_IS_APPROX(eivals, ref.eigenvalues());
+  }
+}
+
+template<typename MatrixType> void selfadjointeigensolver_partial(Index size)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef Matrix<RealScalar,Dynamic,1> RealVectorType;
+
+  MatrixType a = MatrixType::Random(size,size);
+  MatrixType symmA = a.adjoint() + a;
+  if(internal::random<bool>())
+  {
+    // clusters of eigenvalues
+    RealVectorType d = RealVectorType::Random(size);
+    d.head(size/2).setConstant(RealScalar(0.5));
+    MatrixType q = MatrixType::Random(size,size).householderQr().householderQ();
+    symmA = q * d.template cast<Scalar>().asDiagonal() * q.adjoint();
+  }
+  SelfAdjointEigenSolver<MatrixType> full(symmA);
+  RealScalar scaling = full.eigenvalues().cwiseAbs().maxCoeff();
+
+  Index first = internal::random<Index>(0,size-1);
+  Index count = internal::random<Index>(0,size-first);
+  SelfAdjointEigenSolver<MatrixType> eig;
+  eig.computeIndexRange(symmA, first, count);
+  VERIFY_IS_EQUAL(eig.info(), Success);
+  VERIFY_IS_EQUAL(eig.eigenvalues().size(), count);
+  VERIFY_IS_EQUAL(eig.eigenvectors().cols(), count);
+  VERIFY_IS_APPROX(eig.eigenvalues() / scaling, full.eigenvalues().segment(first, count) / scaling);
+  VERIFY_IS_APPROX((symmA * eig.eigenvectors()) / scaling, (eig.eigenvectors() * eig.eigenvalues().asDiagonal()) / scaling);
+  VERIFY_IS_APPROX(eig.eigenvectors().adjoint() * eig.eigenvectors(), MatrixType::Identity(count,count));
+
+  eig.computeIndexRange(symmA, first, count, EigenvaluesOnly);
+  VERIFY_IS_APPROX(eig.eigenvalues() / scaling, full.eigenvalues().segment(first, count) / scaling);
+
+  // the bounds of the interval are taken between two distinct eigenvalues
+  const RealVectorType& values = full.eigenvalues();
+  Index lo = internal::random<Index>(0,size-1), hi = internal::random<Index>(lo,size);
+  while(lo > 0 && values(lo) - values(lo-1) <= test_precision<RealScalar>() * scaling) --lo;
+  while(hi < size && hi > 0 && values(hi) - values(hi-1) <= test_precision<RealScalar>() * scaling) ++hi;
+  RealScalar lower = lo > 0 ? (values(lo-1) + values(lo)) / 2 : values(0) - 1;
+  RealScalar upper = hi == lo ? lower : hi < size ? (values(hi-1) + values(hi)) / 2 : values(size-1) + 1;
+  eig.computeValueRange(symmA, lower, upper);
+  VERIFY_IS_EQUAL(eig.info(), Success);
+  VERIFY_IS_EQUAL(eig.eigenvalues().size(), hi-lo);
+  VERIFY_IS_APPROX(eig.eigenvalues() / scaling, values.segment(lo, hi-lo) / scaling);
+  VERIFY_IS_APPROX((symmA * eig.eigenvectors()) / scaling, (eig.eigenvectors() * eig.eigenvalues().asDiagonal()) / scaling);
+
+  // the whole spectrum
+  eig.computeIndexRange(symmA, 0, size);
+  VERIFY_IS_APPROX(eig.eigenvalues() / scaling, full.eigenvalues() / scaling);
+  VERIFY_IS_UNITARY(eig.eigenvectors());
+}
+
+template<typename MatrixType> void selfadjointeigensolver_partial_split(Index size)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef Matrix<RealScalar,Dynamic,1> RealVectorType;
+
+  // the zero matrix only has blocks of size one
+  Index first = internal::random<Index>(0,size-1);
+  Index count = internal::random<Index>(1,size-first);
+  SelfAdjointEigenSolver<MatrixType> eig;
+  eig.computeIndexRange(MatrixType::Zero(size,size), first, count);
+  VERIFY_IS_EQUAL(eig.info(), Success);
+  VERIFY((eig.eigenvectors().array() == eig.eigenvectors().array()).all());
+  VERIFY_IS_MUCH_SMALLER_THAN(eig.eigenvalues().norm(), RealScalar(1));
+  VERIFY_IS_APPROX(eig.eigenvectors().adjoint() * eig.eigenvectors(), MatrixType::Identity(count,count));
+
+  // a tridiagonal matrix with zero sub-diagonal entries, whose blocks share some eigenvalues
+  RealVectorType diag = RealVectorType::Random(size), subdiag = RealVectorType::Random(size);
+  for(Index i = 0; i < size-1; ++i)
+    if(internal::random<int>(0,3) == 0)
+      subdiag(i) = RealScalar(0);
+  Index half = size/2;
+  if(half > 0 && internal::random<bool>())
+  {
+    // two equal blocks
+    subdiag(half-1) = RealScalar(0);
+    diag.segment(half, half) = diag.head(half);
+    subdiag.segment(half, half-1) = subdiag.head(half-1);
+  }
+  MatrixType symmA = MatrixType::Zero(size,size);
+  symmA.diagonal() = diag.template cast<Scalar>();
+  symmA.diagonal(-1) = subdiag.head(size-1).template cast<Scalar>();
+  symmA.diagonal(1) = subdiag.head(size-1).template cast<Scalar>();
+  SelfAdjointEigenSolver<MatrixType> full(symmA);
+
+  eig.computeIndexRange(symmA, 0, size);
+  VERIFY_IS_EQUAL(eig.info(), Success);
+  VERIFY_IS_APPROX(eig.eigenvalues(), full.eigenvalues());
+  VERIFY_IS_APPROX(symmA * eig.eigenvectors(), eig.eigenvectors() * eig.eigenvalues().asDiagonal());
+  VERIFY_IS_UNITARY(eig.eigenvectors());
+
+  eig.computeIndexRange(symmA, first, count);
+  VERIFY_IS_EQUAL(eig.info(), Success);
+  VERIFY_IS_APPROX(eig.eigenvalues(), full.eigenvalues().segment(first, count));
+  VERIFY_IS_APPROX(symmA * eig.eigenvectors(), eig.eigenvectors() * eig.eigenvalues().asDiagonal());
+  VERIFY_IS_APPROX(eig.eigenvectors().adjoint() * eig.eigenvectors(), MatrixType::Identity(count,count));
+}
+
 template<int>
 void bug_854()
 {
@@ -257,6 +454,32 @@ void test_eigensolver_selfadjoint()
     CALL_SUBTEST_4( selfadjointeigensolver(MatrixXd(2,2)) );
     CALL_SUBTEST_6( selfadjointeigensolver(Matrix<double,1,1>()) );
     CALL_SUBTEST_7( selfadjointeigensolver(Matrix<double,2,2>()) );
+
+    // two-stage tridiagonalization, with a partial last panel and bandwidths larger than the matrix
+    s = internal::random<int>(2,EIGEN_TEST_MAX_SIZE/2);
+    CALL_SUBTEST_10( selfadjointeigensolver_two_stage<MatrixXd>(s, internal::random<int>(1,8)) );
+    CALL_SUBTEST_10( selfadjointeigensolver_two_stage<MatrixXd>(s, s+1) );
+    CALL_SUBTEST_11( selfadjointeigensolver_two_stage<MatrixXcd>(s, internal::random<int>(1,8)) );
+    CALL_SUBTEST_11( selfadjointeigensolver_two_stage<MatrixXf>(s, internal::random<int>(1,8)) );
+  }
+
+  CALL_SUBTEST_10( selfadjointeigensolver_two_stage_large<0>() );
+
+  s = internal::random<int>(EIGEN_SELFADJOINT_DIVIDE_CONQUER_THRESHOLD, 2*EIGEN_SELFADJOINT_DIVIDE_CONQUER_THRESHOLD);
+  CALL_SUBTEST_14( selfadjointeigensolver_divide_conquer<MatrixXd>(s) );
+  CALL_SUBTEST_14( selfadjointeigensolver_divide_conquer<MatrixXf>(s) );
+  CALL_SUBTEST_15( selfadjointeigensolver_divide_conquer<MatrixXcd>(s) );
+  CALL_SUBTEST_15(( selfadjointeigensolver_divide_conquer<Matrix<double,Dynamic,Dynamic,RowMajor> >(s) ));
+
+  for(int i = 0; i < g_repeat; i++) {
+    s = internal::random<int>(1,EIGEN_TEST_MAX_SIZE/2);
+    CALL_SUBTEST_16( selfadjointeigensolver_partial<MatrixXd>(s) );
+    CALL_SUBTEST_16( selfadjointeigensolver_partial<MatrixXf>(s) );
+    CALL_SUBTEST_17( selfadjointeigensolver_partial<MatrixXcd>(s) );
+    CALL_SUBTEST_17(( selfadjointeigensolver_partial<Matrix<double,Dynamic,Dynamic,RowMajor> >(s) ));
+    CALL_SUBTEST_16( selfadjointeigensolver_partial_split<MatrixXd>(s) );
+    CALL_SUBTEST_16( selfadjointeigensolver_partial_split<MatrixXf>(s) );
+    CALL_SUBTEST_17( selfadjointeigensolver_partial_split<MatrixXcd>(s) );
   }
   
   CALL_SUBTEST_13( bug_854<0>() );
@@ -0,0 +1,118 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define EIGEN_RUNTIME_NO_MALLOC
+#include "main.h"
+#include <Eigen/LU>
+
+template<typename MatrixType> void inline_storage(Index smallRows, Index smallCols, Index largeRows, Index largeCols)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename internal::plain_matrix_type<MatrixType>::type RefType;
+  enum { Capacity = internal::traits<MatrixType>::InlineSizeAtCompileTime };
+  VERIFY(Capacity != Dynamic);
+  VERIFY(MatrixType::MaxSizeAtCompileTime == Dynamic);
+
+  RefType ref = RefType::Random(smallRows, smallCols);
+  RefType largeRef = RefType::Random(largeRows, largeCols);
+
+  // small objects do not allocate
+  internal::set_is_malloc_allowed(false);
+  MatrixType a(ref);
+  MatrixType b = a;
+  MatrixType c;
+  c = a + b;
+  b.swap(c);
+  a.resize(smallRows, smallCols);
+  a = ref;
+  internal::set_is_malloc_allowed(true);
+  VERIFY_IS_EQUAL(a, ref);
+  VERIFY_IS_APPROX(b, ref + ref);
+  VERIFY(c.data() >= reinterpret_cast<Scalar*>(&c) && c.data() < reinterpret_cast<Scalar*>(&c + 1));
+
+  // larger objects spill to the heap
+  MatrixType large = largeRef;
+  VERIFY_IS_EQUAL(large, largeRef);
+  VERIFY(large.data() < reinterpret_cast<Scalar*>(&large) || large.data() >= reinterpret_cast<Scalar*>(&large + 1));
+
+  // swapping and moving between inline and heap coefficients
+  large.swap(a);
+  VERIFY_IS_EQUAL(a, largeRef);
+  VERIFY_IS_EQUAL(large, ref);
+  std::swap(a, large);
+  VERIFY_IS_EQUAL(a, ref);
+  VERIFY_IS_EQUAL(large, largeRef);
+  c = large;
+  VERIFY_IS_EQUAL(c, largeRef);
+  c = a;
+  VERIFY_IS_EQUAL(c, ref);
+#if EIGEN_HAS_RVALUE_REFERENCES
+  MatrixType moved(std::move(large));
+  VERIFY_IS_EQUAL(moved, largeRef);
+  MatrixType movedSmall(std::move(c));
+  VERIFY_IS_EQUAL(movedSmall, ref);
+  c = std::move(moved);
+  VERIFY_IS_EQUAL(c, largeRef);
+#endif
+
+  // conservative resizing preserves the coefficients across the inline and heap storages
+  c = ref;
+  c.conservativeResize(largeRows, largeCols);
+  VERIFY_IS_EQUAL(c.block(0, 0, smallRows, smallCols), ref);
+  c.conservativeResize(smallRows, smallCols);
+  VERIFY_IS_EQUAL(c, ref);
+  c = largeRef;
+  c.conservativeResize(smallRows, smallCols);
+  VERIFY_IS_EQUAL(c, largeRef.block(0, 0, smallRows, smallCols));
+
+  // expressions and products
+  c = largeRef;
+  VERIFY_IS_APPROX(c.matrix().adjoint() * c.matrix(), largeRef.matrix().adjoint() * largeRef.matrix());
+  a = ref;
+  VERIFY_IS_APPROX((a.matrix().adjoint() * a.matrix()).eval(), ref.matrix().adjoint() * ref.matrix());
+  VERIFY_IS_APPROX(a.transpose().eval(), ref.transpose());
+}
+
+template<typename Scalar> void inline_storage_decompositions()
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic,ColMajor|InlineStorage,4,4> MatrixType;
+  typedef Matrix<Scalar,Dynamic,1,ColMajor|InlineStorage,4,1> VectorType;
+  for(Index n = 1; n < 8; ++n)
+  {
+    MatrixType a = MatrixType::Random(n, n) + MatrixType::Identity(n, n) * Scalar(n);
+    VectorType b = VectorType::Random(n);
+    VectorType x = a.partialPivLu().solve(b);
+    VERIFY_IS_APPROX(a * x, b);
+    VERIFY_IS_APPROX(a.inverse() * a, MatrixType::Identity(n, n));
+  }
+}
+
+void inline_storage_array()
+{
+  typedef Array<float,Dynamic,1,ColMajor|InlineStorage,16,1> ArrayType;
+  ArrayXf ref = ArrayXf::Random(internal::random<int>(0,16));
+  internal::set_is_malloc_allowed(false);
+  ArrayType a = ref;
+  ArrayType b = a.abs2() + a;
+  internal::set_is_malloc_allowed(true);
+  VERIFY_IS_APPROX(b.matrix(), (ref.abs2() + ref).matrix());
+  b.conservativeResize(100);
+  VERIFY_IS_APPROX(b.head(ref.size()).matrix(), (ref.abs2() + ref).matrix());
+}
+
+void test_inline_storage()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1(( inline_storage<Matrix<double,Dynamic,Dynamic,ColMajor|InlineStorage,6,6> >(internal::random<int>(0,6), internal::random<int>(0,6), internal::random<int>(7,30), internal::random<int>(7,30)) ));
+    CALL_SUBTEST_2(( inline_storage<Matrix<float,Dynamic,1,ColMajor|InlineStorage,8,1> >(internal::random<int>(0,8), 1, internal::random<int>(9,100), 1) ));
+    CALL_SUBTEST_3(( inline_storage<Matrix<std::complex<double>,3,Dynamic,RowMajor|InlineStorage,3,4> >(3, internal::random<int>(0,4), 3, internal::random<int>(5,20)) ));
+    CALL_SUBTEST_4(( inline_storage<Matrix<int,Dynamic,Dynamic,ColMajor|DontAlign|InlineStorage,3,5> >(internal::random<int>(1,3), internal::random<int>(1,5), internal::random<int>(4,20), internal::random<int>(6,20)) ));
+  }
+  CALL_SUBTEST_1( inline_storage_decompositions<double>() );
+  CALL_SUBTEST_3( inline_storage_decompositions<std::complex<double> >() );
+  CALL_SUBTEST_2( inline_storage_array() );
+}
@@ -45,8 +45,11 @@
 #include <list>
 #if __cplusplus >= 201103L
 #include <random>
-#ifdef EIGEN_USE_THREADS
+#if defined(EIGEN_USE_THREADS) || defined(EIGEN_GEMM_THREADPOOL)
+#include <atomic>
+#include <condition_variable>
 #include <future>
+#include <mutex>
 #endif
 #endif
 
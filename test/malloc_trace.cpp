@@ -0,0 +1,169 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define EIGEN_MALLOC_TRACING
+#include <sstream>
+#include <thread>
+#include "main.h"
+
+static Index g_hook_calls = 0;
+static std::size_t g_hook_bytes = 0;
+
+void count_allocation(std::size_t size, const char*, const char*)
+{
+  ++g_hook_calls;
+  g_hook_bytes += size;
+}
+
+bool same_name(const char* a, const char* b)
+{
+  return a == b || (a && b && std::strcmp(a, b) == 0);
+}
+
+const MallocTraceRecord* find_record(const std::vector<MallocTraceRecord>& records, const char* label)
+{
+  for(std::size_t i = 0; i < records.size(); ++i)
+    if(same_name(records[i].label, label))
+      return &records[i];
+  return 0;
+}
+
+#if defined(__GXX_RTTI) || defined(_CPPRTTI) || defined(__cpp_rtti)
+template<typename T> const MallocTraceRecord* find_type(const std::vector<MallocTraceRecord>& records)
+{
+  for(std::size_t i = 0; i < records.size(); ++i)
+    if(same_name(records[i].type, typeid(T).name()))
+      return &records[i];
+  return 0;
+}
+#endif
+
+void malloc_trace_basic()
+{
+  resetMallocTrace();
+  VERIFY_IS_EQUAL(mallocTraceSummary().count, 0);
+
+  MatrixXd a = MatrixXd::Random(20, 30);
+  MallocTraceRecord total = mallocTraceSummary();
+  VERIFY_IS_EQUAL(total.count, 1);
+  VERIFY_IS_EQUAL(total.bytes, 20*30*sizeof(double));
+  std::vector<MallocTraceRecord> records = mallocTraceRecords();
+  VERIFY_IS_EQUAL(records.size(), std::size_t(1));
+  VERIFY(records[0].label == 0);
+#if defined(__GXX_RTTI) || defined(_CPPRTTI) || defined(__cpp_rtti)
+  // the allocation is recorded with the type of the matrix, not of its scalars
+  VERIFY(same_name(records[0].type, typeid(MatrixXd).name()));
+
+  // the temporary of a product is recorded with the type of the product, and its copy with the type of the matrix
+  MatrixXd c(5, 5);
+  resetMallocTrace();
+  c = a * a.transpose();
+  MatrixXd d = c;
+  records = mallocTraceRecords();
+  const MallocTraceRecord* product = find_type<Product<MatrixXd,Transpose<MatrixXd>,0> >(records);
+  VERIFY(product != 0);
+  VERIFY(product->maxBytes >= 20*20*sizeof(double));
+  const MallocTraceRecord* copy = find_type<MatrixXd>(records);
+  VERIFY(copy != 0);
+  VERIFY_IS_EQUAL(copy->count, 1);
+  VERIFY_IS_EQUAL(copy->bytes, 20*20*sizeof(double));
+  VERIFY(find_type<double>(records) == 0);
+
+  // equal labels with different addresses make a single record
+  resetMallocTrace();
+  std::string label = "copied label";
+  {
+    MallocTraceScope scope("copied label");
+    VectorXd v(10);
+  }
+  {
+    MallocTraceScope scope(label.c_str());
+    VectorXd v(10);
+  }
+  records = mallocTraceRecords();
+  VERIFY_IS_EQUAL(records.size(), std::size_t(1));
+  VERIFY_IS_EQUAL(records[0].count, 2);
+#endif
+
+  // no allocation, no record
+  resetMallocTrace();
+  Matrix3d m = Matrix3d::Random();
+  a.block(0, 0, 3, 3) += m;
+  VERIFY_IS_EQUAL(mallocTraceSummary().count, 0);
+
+  // the hidden temporaries of an expression are recorded with the label of the enclosing scope
+  static const char update[] = "update";
+  VectorXd x = VectorXd::Random(30), b = VectorXd::Random(20);
+  resetMallocTrace();
+  for(int i = 0; i < 3; ++i)
+  {
+    MallocTraceScope scope(update);
+    x.noalias() -= 1e-3 * (a.transpose() * (a * x - b));
+    {
+      MallocTraceScope inner("inner");
+      VectorXf y(5);
+    }
+  }
+  records = mallocTraceRecords();
+  const MallocTraceRecord* r = find_record(records, update);
+  VERIFY(r != 0);
+  VERIFY(r->count >= 3);
+  VERIFY(r->count % 3 == 0);
+  VERIFY_IS_EQUAL(r->maxBytes, 20*sizeof(double));
+  VERIFY(find_record(records, 0) == 0);
+
+  std::ostringstream os;
+  printMallocTrace(os);
+  VERIFY(os.str().find("update") != std::string::npos);
+  VERIFY(os.str().find("inner") != std::string::npos);
+}
+
+void malloc_trace_hook()
+{
+  resetMallocTrace();
+  VERIFY(setMallocTraceHook(count_allocation) == 0);
+  g_hook_calls = 0;
+  g_hook_bytes = 0;
+  {
+    MatrixXf a = MatrixXf::Random(10, 10);
+    MatrixXf b = a * a;
+    VectorXf v(4);
+    v.conservativeResize(8);
+  }
+  VERIFY(setMallocTraceHook(0) == count_allocation);
+  MallocTraceRecord total = mallocTraceSummary();
+  VERIFY(g_hook_calls >= 3);
+  VERIFY_IS_EQUAL(g_hook_calls, total.count);
+  VERIFY_IS_EQUAL(g_hook_bytes, total.bytes);
+}
+
+void malloc_trace_threads()
+{
+  static const char worker[] = "worker";
+  resetMallocTrace();
+  std::thread thread([]() {
+    MallocTraceScope scope(worker);
+    for(int i = 0; i < 10; ++i)
+      VectorXd v(100);
+  });
+  {
+    MallocTraceScope scope("main");
+    thread.join();
+  }
+  std::vector<MallocTraceRecord> records = mallocTraceRecords();
+  const MallocTraceRecord* r = find_record(records, worker);
+  VERIFY(r != 0);
+  VERIFY_IS_EQUAL(r->count, 10);
+  VERIFY_IS_EQUAL(r->bytes, 10*100*sizeof(double));
+}
+
+void test_malloc_trace()
+{
+  CALL_SUBTEST_1( malloc_trace_basic() );
+  CALL_SUBTEST_1( malloc_trace_hook() );
+  CALL_SUBTEST_2( malloc_trace_threads() );
+}
@@ -0,0 +1,139 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <Eigen/LU>
+#include <Eigen/Cholesky>
+
+// Returns a random square matrix of condition number cond
+template<typename MatrixType> MatrixType random_conditioned(Index size, typename MatrixType::RealScalar cond)
+{
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef Matrix<RealScalar,Dynamic,1> RealVectorType;
+  MatrixType u = MatrixType::Random(size, size).householderQr().householderQ();
+  MatrixType v = MatrixType::Random(size, size).householderQr().householderQ();
+  // singular values spread geometrically from 1 to 1/cond
+  RealVectorType sv(size);
+  for(Index i = 0; i < size; ++i)
+    sv(i) = std::pow(cond, -RealScalar(i) / RealScalar(size-1));
+  return u * sv.template cast<typename MatrixType::Scalar>().asDiagonal() * v.adjoint();
+}
+
+template<typename MatrixType> void mixed_precision_lu(Index size)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef Matrix<Scalar,MatrixType::RowsAtCompileTime,1> VectorType;
+  typedef Matrix<Scalar,MatrixType::RowsAtCompileTime,Dynamic> RhsType;
+  const RealScalar eps = NumTraits<RealScalar>::epsilon();
+
+  // a well conditioned system is refined to double precision accuracy
+  MatrixType a = random_conditioned<MatrixType>(size, RealScalar(100));
+  VectorType b = VectorType::Random(size);
+  MixedPrecisionSolver<MatrixType> solver(a);
+  VERIFY(!solver.usesFallback());
+  VectorType x = solver.solve(b);
+  VERIFY_IS_EQUAL(solver.info(), Success);
+  VERIFY(!solver.usesFallback());
+  VERIFY(solver.error() <= eps * std::sqrt(RealScalar(size)));
+  VectorType ref = PartialPivLU<MatrixType>(a).solve(b);
+  VERIFY((x - ref).norm() <= RealScalar(1e-12) * ref.norm());
+  // which the single precision factorization alone is not
+  VectorType lowX = solver.decomposition().solve(b.template cast<typename MixedPrecisionSolver<MatrixType>::LowScalar>()).template cast<Scalar>()
+                  / a.cwiseAbs().rowwise().sum().maxCoeff();
+  VERIFY((lowX - ref).norm() > (x - ref).norm());
+
+  // several right-hand sides
+  RhsType c = RhsType::Random(size, 3);
+  c.col(1).setZero();
+  RhsType y = solver.solve(c);
+  VERIFY(!solver.usesFallback());
+  VERIFY((a * y - c).norm() <= RealScalar(1e-12) * c.norm());
+  VERIFY_IS_EQUAL(y.col(1), VectorType::Zero(size));
+  VERIFY_IS_EQUAL(solver.solve(RhsType(size, 0)).cols(), 0);
+
+  // an ill conditioned system makes the refinement stall, and falls back to the double precision factorization
+  a = random_conditioned<MatrixType>(size, RealScalar(1e10));
+  solver.compute(a);
+  VERIFY(!solver.usesFallback());
+  x = solver.solve(b);
+  VERIFY(solver.usesFallback());
+  VERIFY_IS_EQUAL(solver.iterations(), 0);
+  VERIFY_IS_EQUAL(x, PartialPivLU<MatrixType>(a).solve(b));
+  y = solver.solve(c);
+  VERIFY_IS_EQUAL(y, PartialPivLU<MatrixType>(a).solve(c));
+
+  // huge and tiny systems are scaled to single precision
+  a = random_conditioned<MatrixType>(size, RealScalar(10));
+  const RealScalar scales[] = { RealScalar(1e60), RealScalar(1e-30) };
+  for(int k = 0; k < 2; ++k)
+  {
+    solver.compute(a * scales[k]);
+    x = solver.solve(b);
+    VERIFY(!solver.usesFallback());
+    VERIFY((a * x * scales[k] - b).norm() <= RealScalar(1e-12) * b.norm());
+    x = solver.solve(b * scales[k]);
+    VERIFY(!solver.usesFallback());
+    VERIFY((a * x - b).norm() <= RealScalar(1e-12) * b.norm());
+  }
+
+  // no refinement step allowed
+  solver.setMaxIterations(0).compute(a);
+  x = solver.solve(b);
+  VERIFY(solver.usesFallback());
+  VERIFY_IS_APPROX(a * x, b);
+  solver.setMaxIterations(30);
+}
+
+template<typename MatrixType> void mixed_precision_llt(Index size)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef Matrix<Scalar,MatrixType::RowsAtCompileTime,1> VectorType;
+  typedef typename internal::mixed_precision_matrix<MatrixType>::type LowMatrixType;
+
+  MatrixType u = random_conditioned<MatrixType>(size, RealScalar(10));
+  MatrixType a = u * u.adjoint();
+  VectorType b = VectorType::Random(size);
+
+  MixedPrecisionSolver<MatrixType, LLT<LowMatrixType> > llt(a);
+  VectorType x = llt.solve(b);
+  VERIFY(!llt.usesFallback());
+  VERIFY((a * x - b).norm() <= RealScalar(1e-12) * b.norm());
+
+  MixedPrecisionSolver<MatrixType, LDLT<LowMatrixType,Upper> > ldlt(a);
+  x = ldlt.solve(b);
+  VERIFY(!ldlt.usesFallback());
+  VERIFY((a * x - b).norm() <= RealScalar(1e-12) * b.norm());
+
+  // a failed single precision factorization falls back, and reports the failure of the double precision one
+  a(0,0) = -a(0,0);
+  llt.compute(a);
+  VERIFY(llt.usesFallback());
+  VERIFY_IS_EQUAL(llt.info(), NumericalIssue);
+}
+
+void mixed_precision_fixed()
+{
+  Matrix4d a = Matrix4d::Random() + 4 * Matrix4d::Identity();
+  Vector4d b = Vector4d::Random();
+  MixedPrecisionSolver<Matrix4d> solver(a);
+  Vector4d x = solver.solve(b);
+  VERIFY(!solver.usesFallback());
+  VERIFY((a * x - b).norm() <= 1e-13 * b.norm());
+}
+
+void test_mixed_precision()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( mixed_precision_lu<MatrixXd>(internal::random<int>(2,200)) );
+    CALL_SUBTEST_2( mixed_precision_lu<MatrixXcd>(internal::random<int>(2,100)) );
+    CALL_SUBTEST_3( mixed_precision_llt<MatrixXd>(internal::random<int>(2,200)) );
+    CALL_SUBTEST_3( mixed_precision_llt<MatrixXcd>(internal::random<int>(2,100)) );
+    CALL_SUBTEST_4( mixed_precision_fixed() );
+  }
+}
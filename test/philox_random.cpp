@@ -0,0 +1,135 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+
+// known answers of the reference implementation (Random123)
+void philox_known_answers()
+{
+  unsigned int key[2] = { 0u, 0u };
+  unsigned int x[4][1] = { {0u}, {0u}, {0u}, {0u} };
+  internal::philox4x32_10<1>(key, x, 1);
+  VERIFY_IS_EQUAL(x[0][0], 0x6627e8d5u);
+  VERIFY_IS_EQUAL(x[1][0], 0xe169c58du);
+  VERIFY_IS_EQUAL(x[2][0], 0xbc57ac4cu);
+  VERIFY_IS_EQUAL(x[3][0], 0x9b00dbd8u);
+
+  key[0] = key[1] = 0xffffffffu;
+  unsigned int y[4][2] = { {0xffffffffu, 0u}, {0xffffffffu, 0u}, {0xffffffffu, 0u}, {0xffffffffu, 0u} };
+  internal::philox4x32_10<2>(key, y, 1);
+  VERIFY_IS_EQUAL(y[0][0], 0x408f276du);
+  VERIFY_IS_EQUAL(y[1][0], 0x41c83b0eu);
+  VERIFY_IS_EQUAL(y[2][0], 0xa20bc7c6u);
+  VERIFY_IS_EQUAL(y[3][0], 0x6d5451fdu);
+}
+
+template<typename MatrixType> void philox_random(const MatrixType& m)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar, MatrixType::ColsAtCompileTime, MatrixType::RowsAtCompileTime,
+                 MatrixType::IsRowMajor ? ColMajor : RowMajor> TransposedType;
+  Index rows = m.rows();
+  Index cols = m.cols();
+  unsigned int seed = internal::random<unsigned int>();
+
+  // reproducible from the seed
+  PhiloxGenerator g1(seed), g2(seed);
+  MatrixType a = MatrixType::Random(rows, cols, g1);
+  MatrixType b = MatrixType::Random(rows, cols, g2);
+  VERIFY_IS_EQUAL(a, b);
+
+  // the next draws and the other streams are different
+  b = MatrixType::Random(rows, cols, g2);
+  PhiloxGenerator g3(seed, 1);
+  MatrixType c = MatrixType::Random(rows, cols, g3);
+  if(a.size()>4)
+  {
+    VERIFY(a != b);
+    VERIFY(a != c);
+  }
+
+  // the coefficients only depend on their index in the storage order
+  PhiloxGenerator g4(seed);
+  internal::scalar_uniform_random_op<Scalar> op(g4, rows, cols, MatrixType::IsRowMajor);
+  for(Index j = 0; j < cols; ++j)
+    for(Index i = 0; i < rows; ++i)
+      VERIFY_IS_EQUAL(a(i,j), op(i,j));
+  PhiloxGenerator g5(seed);
+  TransposedType t = TransposedType::Random(cols, rows, g5);
+  VERIFY_IS_EQUAL(t, a.transpose());
+
+  // setRandom draws like Random
+  PhiloxGenerator g6(seed);
+  MatrixType d(rows, cols);
+  d.setRandom(g6);
+  VERIFY_IS_EQUAL(d, a);
+  PhiloxGenerator g7(seed);
+  d.setRandomNormal(g7);
+  PhiloxGenerator g8(seed);
+  VERIFY_IS_EQUAL(d, MatrixType::RandomNormal(rows, cols, g8));
+}
+
+template<typename Scalar> void philox_distributions()
+{
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  const Index n = 100000;
+  PhiloxGenerator g(internal::random<unsigned int>(), internal::random<unsigned int>());
+
+  // uniform in [-1,1), of variance 1/3
+  const VectorType u = VectorType::Random(n, g);
+  VERIFY((u.real().array() >= RealScalar(-1)).all() && (u.real().array() < RealScalar(1)).all());
+  VERIFY((u.imag().array() >= RealScalar(-1)).all() && (u.imag().array() < RealScalar(1)).all());
+  VERIFY(numext::abs(u.mean()) < RealScalar(0.02));
+  VERIFY(numext::abs(u.squaredNorm()/RealScalar(n) - RealScalar(NumTraits<Scalar>::IsComplex ? 2 : 1)/RealScalar(3)) < RealScalar(0.02));
+
+  // standard normal
+  VectorType z = VectorType::RandomNormal(n, g);
+  VERIFY((z.array() == z.array()).all());
+  VERIFY(numext::abs(z.mean()) < RealScalar(0.02));
+  VERIFY(numext::abs(z.squaredNorm()/RealScalar(n) - RealScalar(NumTraits<Scalar>::IsComplex ? 2 : 1)) < RealScalar(0.03));
+  Index within = (z.real().array().abs() < RealScalar(1)).count();
+  VERIFY(numext::abs(RealScalar(within)/RealScalar(n) - RealScalar(0.6827)) < RealScalar(0.01));
+
+  // a segment starting at any index
+  PhiloxGenerator g1(7), g2(7);
+  VectorType v = VectorType::Random(101, g1);
+  internal::scalar_uniform_random_op<Scalar> op(g2, 101, 1, false);
+  for(Index i = 0; i < 101; ++i)
+    VERIFY_IS_EQUAL(v(i), op(i,0));
+}
+
+template<typename Scalar> void philox_integers()
+{
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  PhiloxGenerator g(internal::random<unsigned int>());
+  VectorType v = VectorType::Random(10000, g);
+  // the whole range is covered
+  VERIFY((v.array() < Scalar(0)).any());
+  VERIFY((v.array() > Scalar(0)).any());
+  VERIFY((v.array() > Scalar(NumTraits<Scalar>::highest()/2)).any());
+  VERIFY((v.array() < Scalar(NumTraits<Scalar>::lowest()/2)).any());
+}
+
+void test_philox_random()
+{
+  CALL_SUBTEST_1( philox_known_answers() );
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( philox_random(Matrix<float, 3, 5>()) );
+    CALL_SUBTEST_2( philox_random(MatrixXf(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_3( philox_random(MatrixXd(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_4( philox_random(MatrixXcd(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_5( philox_random(RowVectorXf(internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_5( philox_random(Matrix<double,Dynamic,Dynamic,RowMajor>(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+  }
+  CALL_SUBTEST_2( philox_distributions<float>() );
+  CALL_SUBTEST_3( philox_distributions<double>() );
+  CALL_SUBTEST_4( philox_distributions<std::complex<double> >() );
+  CALL_SUBTEST_6( philox_integers<int>() );
+  CALL_SUBTEST_6( philox_integers<long>() );
+  CALL_SUBTEST_6( philox_integers<short>() );
+}
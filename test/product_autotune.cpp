@@ -0,0 +1,129 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define EIGEN_GEMM_AUTOTUNING
+#include <chrono>
+#include <cstdio>
+#include "main.h"
+
+template<typename LhsScalar, typename RhsScalar>
+void blocking(Index rows, Index depth, Index cols, Index threads, Index& kc, Index& mc, Index& nc)
+{
+  kc = depth;
+  mc = rows;
+  nc = cols;
+  internal::computeProductBlockingSizes<LhsScalar,RhsScalar,1>(kc, mc, nc, threads);
+}
+
+void product_autotune_table()
+{
+  clearProductBlockingSizes();
+  Index kc0, mc0, nc0;
+  blocking<double,double>(600, 600, 600, 1, kc0, mc0, nc0);
+
+  setProductBlockingSizes<double,double>(600, 600, 600, 64, 48, 96);
+  Index kc, mc, nc;
+  blocking<double,double>(700, 300, 500, 1, kc, mc, nc);
+  VERIFY_IS_EQUAL(kc, 64);
+  VERIFY_IS_EQUAL(mc, 48);
+  VERIFY_IS_EQUAL(nc, 96);
+
+  // the tuned sizes are bounded by the dimensions of the product
+  setProductBlockingSizes<double,double>(100, 100, 100, 512, 512, 512);
+  blocking<double,double>(100, 40, 200, 1, kc, mc, nc);
+  VERIFY_IS_EQUAL(kc, 40);
+  VERIFY_IS_EQUAL(mc, 100);
+  VERIFY_IS_EQUAL(nc, 200);
+
+  // other scalar types, the multi-threaded products and the triangular products are not affected
+  Index kcf, mcf, ncf;
+  blocking<float,float>(600, 600, 600, 1, kcf, mcf, ncf);
+  clearProductBlockingSizes();
+  Index kcf0, mcf0, ncf0;
+  blocking<float,float>(600, 600, 600, 1, kcf0, mcf0, ncf0);
+  VERIFY(kcf == kcf0 && mcf == mcf0 && ncf == ncf0);
+  setProductBlockingSizes<double,double>(600, 600, 600, 64, 48, 96);
+  blocking<double,double>(600, 600, 600, 4, kc, mc, nc);
+  Index kcp, mcp, ncp;
+  clearProductBlockingSizes();
+  blocking<double,double>(600, 600, 600, 4, kcp, mcp, ncp);
+  VERIFY(kc == kcp && mc == mcp && nc == ncp);
+  setProductBlockingSizes<double,double>(600, 600, 600, 64, 48, 96);
+  kc = mc = nc = 600;
+  internal::computeProductBlockingSizes<double,double,4>(kc, mc, nc);
+  VERIFY(kc != 64);
+
+  // products are still correct with odd blocking sizes
+  setProductBlockingSizes<double,double>(600, 600, 600, 24, 13, 7);
+  MatrixXd a = MatrixXd::Random(600, 300), b = MatrixXd::Random(300, 400);
+  MatrixXd c = a * b;
+  VERIFY_IS_APPROX(c, a.lazyProduct(b));
+  setProductBlockingSizes<std::complex<float>,std::complex<float> >(300, 300, 300, 16, 12, 8);
+  MatrixXcf ac = MatrixXcf::Random(300, 300);
+  VERIFY_IS_APPROX(ac * ac, ac.lazyProduct(ac));
+
+  // a zero kc reverts to the heuristic
+  setProductBlockingSizes<double,double>(600, 600, 600, 0, 0, 0);
+  blocking<double,double>(600, 600, 600, 1, kc, mc, nc);
+  VERIFY(kc == kc0 && mc == mc0 && nc == nc0);
+  clearProductBlockingSizes();
+}
+
+void product_autotune_files()
+{
+  const char filename[] = "product_autotune_blocking.txt";
+  clearProductBlockingSizes();
+  setProductBlockingSizes<double,double>(600, 600, 600, 64, 48, 96);
+  setProductBlockingSizes<float,float>(2000, 100, 2000, 96, 72, 128, true);
+  VERIFY(saveProductBlockingSizes(filename));
+  clearProductBlockingSizes();
+
+  Index kc, mc, nc;
+  VERIFY(loadProductBlockingSizes(filename));
+  blocking<double,double>(600, 600, 600, 1, kc, mc, nc);
+  VERIFY(kc == 64 && mc == 48 && nc == 96);
+  blocking<float,float>(1500, 200, 3000, 2, kc, mc, nc);
+  VERIFY(kc == 96 && mc == 72 && nc == 128);
+
+  // a table tuned for other cache sizes is rejected and leaves the current sizes unchanged
+  std::ptrdiff_t l1 = l1CacheSize(), l2 = l2CacheSize(), l3 = l3CacheSize();
+  setCpuCacheSizes(l1, 2*l2, l3);
+  clearProductBlockingSizes();
+  setProductBlockingSizes<double,double>(600, 600, 600, 32, 24, 48);
+  VERIFY(!loadProductBlockingSizes(filename));
+  setCpuCacheSizes(l1, l2, l3);
+  blocking<double,double>(600, 600, 600, 1, kc, mc, nc);
+  VERIFY(kc == 32 && mc == 24 && nc == 48);
+
+  VERIFY(!loadProductBlockingSizes("product_autotune_missing.txt"));
+  std::FILE* file = std::fopen(filename, "w");
+  std::fputs("garbage\n", file);
+  std::fclose(file);
+  VERIFY(!loadProductBlockingSizes(filename));
+  std::remove(filename);
+  clearProductBlockingSizes();
+}
+
+template<typename Scalar> void product_autotune_run()
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  clearProductBlockingSizes();
+  const Index shapes[][3] = { { 300, 300, 300 } };
+  Index tuned = autotuneProductBlockingSizes<Scalar>(shapes, 1, 1);
+  VERIFY(tuned == 0 || tuned == 1);
+  MatrixType a = MatrixType::Random(400, 350), b = MatrixType::Random(350, 300);
+  VERIFY_IS_APPROX(a * b, a.lazyProduct(b));
+  clearProductBlockingSizes();
+}
+
+void test_product_autotune()
+{
+  CALL_SUBTEST_1( product_autotune_table() );
+  CALL_SUBTEST_1( product_autotune_files() );
+  CALL_SUBTEST_2( product_autotune_run<float>() );
+  CALL_SUBTEST_2( product_autotune_run<double>() );
+}
@@ -0,0 +1,84 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+
+template<typename MatrixType> void product_packed(const MatrixType& m)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic,ColMajor> ColMatrix;
+  typedef Matrix<Scalar,Dynamic,Dynamic,RowMajor> RowMatrix;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+
+  Index rows = m.rows();
+  Index depth = m.cols();
+  Index cols = internal::random<Index>(1,EIGEN_TEST_MAX_SIZE);
+
+  MatrixType a = MatrixType::Random(rows, depth);
+  ColMatrix b = ColMatrix::Random(depth, cols);
+  RowMatrix rb = b;
+  VectorType v = VectorType::Random(depth);
+  Scalar alpha = internal::random<Scalar>();
+
+  PackedGemmLhs<Scalar> pa(a, internal::random<Index>(0,cols));
+  VERIFY_IS_EQUAL(pa.rows(), rows);
+  VERIFY_IS_EQUAL(pa.cols(), depth);
+
+  ColMatrix ref = a * b;
+  ColMatrix res(rows, cols);
+  RowMatrix rres(rows, cols);
+
+  // the same packed operand can be reused many times
+  for(int k=0; k<2; ++k)
+  {
+    res = pa * b;
+    VERIFY_IS_APPROX(res, ref);
+  }
+  res.noalias() = pa * rb;
+  VERIFY_IS_APPROX(res, ref);
+  rres = pa * b;
+  VERIFY_IS_APPROX(rres, ref);
+  res = pa * (b + b);
+  VERIFY_IS_APPROX(res, Scalar(2)*ref);
+
+  VectorType x = pa * v;
+  VERIFY_IS_APPROX(x, a*v);
+
+  res = ref;
+  pa.scaleAndAddTo(res, b, alpha);
+  VERIFY_IS_APPROX(res, ref + alpha*ref);
+  res.setZero();
+  Index c = internal::random<Index>(1,cols);
+  typename ColMatrix::ColsBlockXpr resBlock = res.leftCols(c);
+  pa.scaleAndAddTo(resBlock, b.leftCols(c), alpha);
+  VERIFY_IS_APPROX(res.leftCols(c), alpha*ref.leftCols(c));
+
+  // sub-matrices and re-packing
+  Index r = internal::random<Index>(0,rows-1), nr = internal::random<Index>(1,rows-r);
+  pa.compute(a.middleRows(r,nr));
+  res.resize(nr, cols);
+  res = pa * b;
+  VERIFY_IS_APPROX(res, a.middleRows(r,nr)*b);
+
+  pa.compute(a.transpose());
+  VERIFY_IS_APPROX((pa * ref).eval(), (a.transpose() * ref).eval());
+}
+
+void test_product_packed()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( product_packed(MatrixXf(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_2( product_packed(MatrixXd(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_3( product_packed(MatrixXcf(internal::random<int>(1,EIGEN_TEST_MAX_SIZE/2), internal::random<int>(1,EIGEN_TEST_MAX_SIZE/2))) );
+    CALL_SUBTEST_4( product_packed(Matrix<double,Dynamic,Dynamic,RowMajor>(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_5( product_packed(MatrixXi(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+  }
+
+  // large products with many blocks along all the dimensions
+  CALL_SUBTEST_1( product_packed(MatrixXf(internal::random<int>(500,1000), internal::random<int>(500,1000))) );
+  CALL_SUBTEST_2( product_packed(MatrixXd(internal::random<int>(500,1000), internal::random<int>(500,1000))) );
+}
@@ -0,0 +1,125 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+
+typedef Matrix<signed char,Dynamic,Dynamic> MatrixXs8;
+typedef Matrix<unsigned char,Dynamic,Dynamic> MatrixXu8;
+
+template<typename MatrixType> MatrixType random_quantized(Index rows, Index cols)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  MatrixType m(rows, cols);
+  for(Index j = 0; j < cols; ++j)
+    for(Index i = 0; i < rows; ++i)
+      m(i,j) = Scalar(internal::random<int>(NumTraits<Scalar>::lowest(), NumTraits<Scalar>::highest()));
+  return m;
+}
+
+template<typename Kernel, typename RhsScalar> void quantized_kernel(Index rows, Index depth, Index cols)
+{
+  typedef Matrix<RhsScalar,Dynamic,Dynamic> RhsType;
+  MatrixXs8 a = random_quantized<MatrixXs8>(rows, depth);
+  RhsType b = random_quantized<RhsType>(depth, cols);
+  VectorXi za(rows), zb(cols);
+  for(Index i = 0; i < rows; ++i)
+    za(i) = internal::random<int>(-128,127);
+  for(Index j = 0; j < cols; ++j)
+    zb(j) = internal::random<int>(-128,255);
+
+  MatrixXi ref = a.cast<int>() * b.template cast<int>();
+  MatrixXi res(rows, cols);
+  internal::quantized_product_impl<Kernel>(a, b, static_cast<const VectorXi*>(0), static_cast<const VectorXi*>(0),
+                                           internal::quantized_store<MatrixXi>(res));
+  VERIFY_IS_EQUAL(res, ref);
+
+  ref = (a.cast<int>().colwise() - za) * (b.template cast<int>().rowwise() - zb.transpose());
+  internal::quantized_product_impl<Kernel>(a, b, &za, &zb, internal::quantized_store<MatrixXi>(res));
+  VERIFY_IS_EQUAL(res, ref);
+
+  // expressions with other storage orders
+  Matrix<RhsScalar,Dynamic,Dynamic,RowMajor> rb = b;
+  internal::quantized_product_impl<Kernel>(a.transpose().transpose(), rb, &za, &zb, internal::quantized_store<MatrixXi>(res));
+  VERIFY_IS_EQUAL(res, ref);
+}
+
+template<typename Kernel> void quantized_kernels()
+{
+  // dimensions around the register blocking of the kernel, and a depth larger than its cache blocking
+  Index sizes[][3] = { {1, 1, 1},
+                       {Kernel::mr, Kernel::kq, Kernel::nr},
+                       {Kernel::mr+1, 3*Kernel::kq-1, Kernel::nr-1},
+                       {internal::random<int>(1,100), internal::random<int>(1,100), internal::random<int>(1,100)},
+                       {37, 3000, 21} };
+  for(int i = 0; i < 5; ++i)
+  {
+    quantized_kernel<Kernel, signed char>(sizes[i][0], sizes[i][1], sizes[i][2]);
+    quantized_kernel<Kernel, unsigned char>(sizes[i][0], sizes[i][1], sizes[i][2]);
+  }
+
+  // saturating inputs
+  MatrixXs8 a = MatrixXs8::Constant(Kernel::mr, 64, -128);
+  MatrixXu8 b = MatrixXu8::Constant(64, Kernel::nr, 255);
+  MatrixXi res(a.rows(), b.cols());
+  internal::quantized_product_impl<Kernel>(a, b, static_cast<const VectorXi*>(0), static_cast<const VectorXi*>(0),
+                                           internal::quantized_store<MatrixXi>(res));
+  VERIFY_IS_EQUAL(res, MatrixXi::Constant(a.rows(), b.cols(), -128*255*64));
+  MatrixXs8 c = MatrixXs8::Constant(64, Kernel::nr, -128);
+  internal::quantized_product_impl<Kernel>(a, c, static_cast<const VectorXi*>(0), static_cast<const VectorXi*>(0),
+                                           internal::quantized_store<MatrixXi>(res));
+  VERIFY_IS_EQUAL(res, MatrixXi::Constant(a.rows(), c.cols(), 128*128*64));
+}
+
+void quantized_product()
+{
+  Index rows = internal::random<int>(1,200), depth = internal::random<int>(1,200), cols = internal::random<int>(1,200);
+  MatrixXs8 a = random_quantized<MatrixXs8>(rows, depth);
+  MatrixXu8 b = random_quantized<MatrixXu8>(depth, cols);
+  MatrixXi ref = a.cast<int>() * b.cast<int>();
+
+  MatrixXi res;
+  quantizedProduct(a, b, res);
+  VERIFY_IS_EQUAL(res, ref);
+
+  // blocks of the destination and of the operands
+  MatrixXi big = MatrixXi::Zero(rows+2, cols+3);
+  quantizedProduct(a, b, big.block(1, 2, rows, cols));
+  VERIFY_IS_EQUAL(big.block(1, 2, rows, cols), ref);
+  VERIFY_IS_EQUAL(big.row(0).squaredNorm(), 0);
+  quantizedProduct(a.topRows(rows/2), b.leftCols(cols/2), res);
+  VERIFY_IS_EQUAL(res, ref.topLeftCorner(rows/2, cols/2));
+
+  // zero points and scales
+  VectorXi za = VectorXi::Constant(rows, internal::random<int>(-128,127));
+  VectorXi zb = VectorXi::Constant(cols, internal::random<int>(0,255));
+  ref = (a.cast<int>().colwise() - za) * (b.cast<int>().rowwise() - zb.transpose());
+  quantizedProduct(a, b, za, zb, res);
+  VERIFY_IS_EQUAL(res, ref);
+
+  VectorXf sa = VectorXf::Random(rows).cwiseAbs(), sb = VectorXf::Random(cols).cwiseAbs();
+  MatrixXf fres;
+  quantizedProduct(a, b, za, zb, sa, sb, fres);
+  VERIFY_IS_APPROX(fres, sa.asDiagonal() * ref.cast<float>() * sb.asDiagonal());
+
+  // empty products
+  quantizedProduct(a.leftCols(0), b.topRows(0), res);
+  VERIFY_IS_EQUAL(res, MatrixXi::Zero(rows, cols));
+}
+
+void test_product_quantized()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( quantized_kernels<internal::quantized_gemm_kernel_generic>() );
+#ifdef EIGEN_VECTORIZE_AVX2
+    CALL_SUBTEST_2( quantized_kernels<internal::quantized_gemm_kernel_avx2>() );
+#endif
+#ifdef EIGEN_VECTORIZE_AVX512VNNI
+    CALL_SUBTEST_3( quantized_kernels<internal::quantized_gemm_kernel_avx512vnni>() );
+#endif
+    CALL_SUBTEST_4( quantized_product() );
+  }
+}
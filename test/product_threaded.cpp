@@ -0,0 +1,324 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define EIGEN_GEMM_THREADPOOL
+#include "main.h"
+#include <Eigen/LU>
+#include <Eigen/QR>
+#include <Eigen/Eigenvalues>
+#include <Eigen/SVD>
+#include <unsupported/Eigen/CXX11/ThreadPool>
+#include <future>
+#include <thread>
+
+template<typename MatrixType> void product_threaded(const MatrixType& m)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic,ColMajor> ColMatrix;
+  typedef Matrix<Scalar,Dynamic,Dynamic,RowMajor> RowMatrix;
+
+  Index rows = m.rows();
+  Index depth = m.cols();
+  Index cols = internal::random<Index>(1,3*EIGEN_TEST_MAX_SIZE);
+
+  MatrixType a = MatrixType::Random(rows, depth);
+  ColMatrix b = ColMatrix::Random(depth, cols);
+  RowMatrix rb = b;
+
+  // reference products computed on a single thread
+  ThreadPoolInterface* pool = setGemmThreadPool(0);
+  ColMatrix ref = a * b;
+  ColMatrix ref2 = a.adjoint() * ref;
+  setGemmThreadPool(pool);
+
+  ColMatrix res = a * b;
+  VERIFY_IS_APPROX(res, ref);
+  res.noalias() = a * rb;
+  VERIFY_IS_APPROX(res, ref);
+  RowMatrix rres = a * b;
+  VERIFY_IS_APPROX(rres, ref);
+  res.noalias() += a * b;
+  VERIFY_IS_APPROX(res, Scalar(2)*ref);
+  res = a.adjoint() * ref;
+  VERIFY_IS_APPROX(res, ref2);
+
+  PackedGemmLhs<Scalar> pa(a);
+  res = pa * b;
+  VERIFY_IS_APPROX(res, ref);
+}
+
+// products whose shapes lead to a 2D partitioning or to a split of the depth
+template<typename Scalar> void product_threaded_shapes()
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  typedef Matrix<Scalar,Dynamic,Dynamic,RowMajor> RowMatrix;
+  Index sizes[][3] = { {4000, 24, 100},   // tall and skinny
+                       {24, 4000, 100},   // short and wide
+                       {600, 600, 300},   // square
+                       {30, 40, 20000},   // small result with a large depth
+                       {120, 7, 5000} };
+  for(int i=0; i<5; ++i)
+  {
+    MatrixType a = MatrixType::Random(sizes[i][0], sizes[i][2]);
+    MatrixType b = MatrixType::Random(sizes[i][2], sizes[i][1]);
+
+    ThreadPoolInterface* pool = setGemmThreadPool(0);
+    MatrixType ref = a * b;
+    setGemmThreadPool(pool);
+
+    MatrixType res = a * b;
+    VERIFY_IS_APPROX(res, ref);
+    RowMatrix rres = a * b;
+    VERIFY_IS_APPROX(rres, ref);
+    res.noalias() -= a * b;
+    VERIFY_IS_MUCH_SMALLER_THAN(res.norm(), ref.norm());
+
+    PackedGemmLhs<Scalar> pa(a);
+    res = pa * b;
+    VERIFY_IS_APPROX(res, ref);
+  }
+}
+
+// products issued at the same time by several threads which do not belong to the pool
+template<typename Scalar> void product_threaded_concurrent()
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  const int callers = 3;
+  std::vector<MatrixType> a(callers), b(callers), ref(callers), res(callers);
+  ThreadPoolInterface* pool = setGemmThreadPool(0);
+  for(int t=0; t<callers; ++t)
+  {
+    a[t] = MatrixType::Random(internal::random<int>(200,400), internal::random<int>(200,400));
+    b[t] = MatrixType::Random(a[t].cols(), internal::random<int>(200,400));
+    ref[t] = a[t] * b[t];
+  }
+  setGemmThreadPool(pool);
+
+  std::vector<std::thread> threads;
+  for(int t=0; t<callers; ++t)
+    threads.push_back(std::thread([&a, &b, &res, t]() {
+      for(int k=0; k<8; ++k)
+        res[t].noalias() = a[t] * b[t];
+    }));
+  for(int t=0; t<callers; ++t)
+    threads[t].join();
+  for(int t=0; t<callers; ++t)
+    VERIFY_IS_APPROX(res[t], ref[t]);
+}
+
+// when the threads span several L3 caches, the threads sharing a packed lhs belong to the same L3
+template<typename Scalar> void product_threaded_l3_groups()
+{
+  VERIFY(l3CacheSharing() >= 0);
+  int group = l3CacheGroup(0);
+  VERIFY(group == 0 || group == -1);
+
+  for(Index l3_threads = 1; l3_threads <= 16; l3_threads *= 2)
+  {
+    internal::gemm_partition<Index> p = internal::compute_gemm_partition<Index>(2000, 2000, 16, 8, 4, l3_threads);
+    VERIFY_IS_EQUAL(p.row_groups * p.group_threads, 16);
+    VERIFY_IS_EQUAL(l3_threads % p.group_threads, 0);
+  }
+  internal::gemm_partition<Index> p = internal::compute_gemm_partition<Index>(2000, 2000, 8, 8, 4, 8);
+  internal::gemm_partition<Index> q = internal::compute_gemm_partition<Index>(2000, 2000, 8, 8, 4);
+  VERIFY(p.row_groups == q.row_groups && p.group_threads == q.group_threads);
+
+  std::ptrdiff_t l3Sharing = l3CacheSharing();
+  setL3CacheSharing(2);
+  product_threaded_shapes<Scalar>();
+  setL3CacheSharing(l3Sharing);
+}
+
+// large matrix-vector products, split either by rows or by columns
+template<typename Scalar> void product_threaded_gemv()
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  typedef Matrix<Scalar,Dynamic,Dynamic,RowMajor> RowMatrix;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  Index sizes[][2] = { {3000, 500}, {500, 3000}, {20, 30000}, {100000, 3} };
+  for(int i=0; i<4; ++i)
+  {
+    MatrixType a = MatrixType::Random(sizes[i][0], sizes[i][1]);
+    RowMatrix ra = a;
+    VectorType v = VectorType::Random(sizes[i][1]);
+    VectorType w = VectorType::Random(sizes[i][0]);
+    Scalar alpha = internal::random<Scalar>();
+
+    ThreadPoolInterface* pool = setGemmThreadPool(0);
+    VectorType ref = a * v;
+    VectorType ref2 = alpha * (a.adjoint() * w);
+    setGemmThreadPool(pool);
+
+    VectorType res = a * v;
+    VERIFY_IS_APPROX(res, ref);
+    res = ra * v;
+    VERIFY_IS_APPROX(res, ref);
+    res = alpha * (a.adjoint() * w);
+    VERIFY_IS_APPROX(res, ref2);
+    res = alpha * (ra.adjoint() * w);
+    VERIFY_IS_APPROX(res, ref2);
+    res.noalias() += a.adjoint() * (alpha * w);
+    VERIFY_IS_APPROX(res, Scalar(2)*ref2);
+    // destination with an inner stride
+    MatrixType dst = MatrixType::Zero(2, sizes[i][0]);
+    dst.row(1).noalias() += v.transpose() * a.transpose();
+    VERIFY_IS_APPROX(dst.row(1), ref.transpose());
+  }
+}
+
+// partial pivoting LU with the trailing updates distributed to the threads, and the look-ahead panel factorization
+template<typename MatrixType> void lu_threaded(Index size)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::RealScalar RealScalar;
+  // a = P L U with the rows of L - I summing to less than one half in magnitude: L is well conditioned and each pivot
+  // is much larger than the other candidates of its column, so that the rounding errors cannot change the pivots
+  // chosen by the threaded factorization
+  MatrixType l = MatrixType::Random(size, size) * (RealScalar(0.35) / RealScalar(size));
+  l.template triangularView<StrictlyUpper>().setZero();
+  l.diagonal().setOnes();
+  MatrixType u = MatrixType::Random(size, size);
+  u.template triangularView<StrictlyLower>().setZero();
+  u.diagonal().array() += Scalar(RealScalar(3));
+  PermutationMatrix<Dynamic> p(size);
+  p.setIdentity();
+  for(Index i=0; i<size; ++i)
+    p.applyTranspositionOnTheRight(i, internal::random<Index>(i, size-1));
+  MatrixType a = p * (l * u);
+  MatrixType b = MatrixType::Random(size, 3);
+
+  ThreadPoolInterface* pool = setGemmThreadPool(0);
+  PartialPivLU<MatrixType> ref(a);
+  setGemmThreadPool(pool);
+
+  PartialPivLU<MatrixType> lu(a);
+  VERIFY_IS_APPROX(lu.reconstructedMatrix(), a);
+  VERIFY_IS_APPROX(lu.solve(b), ref.solve(b));
+  VERIFY(lu.permutationP().indices() == ref.permutationP().indices());
+  PermutationMatrix<Dynamic> pinv = p.inverse();
+  VERIFY(lu.permutationP().indices() == pinv.indices());
+  VERIFY_IS_APPROX(lu.matrixLU(), ref.matrixLU());
+
+  // rank deficient matrices, with zero pivots within the look-ahead panels
+  a.col(size/2).setZero();
+  a.col(size-1) = a.col(0);
+  lu.compute(a);
+  VERIFY_IS_APPROX(lu.reconstructedMatrix(), a);
+  VERIFY(!(numext::isnan)(lu.matrixLU().norm()));
+  VERIFY_IS_MUCH_SMALLER_THAN(lu.matrixLU().diagonal().cwiseAbs().minCoeff(), RealScalar(1));
+  MatrixType c = MatrixType::Zero(size, size);
+  lu.compute(c);
+  VERIFY_IS_EQUAL(lu.matrixLU(), c);
+  VERIFY_IS_EQUAL(lu.determinant(), Scalar(0));
+}
+
+// tall and skinny QR with the blocks and the nodes of each level of the tree distributed to the threads
+template<typename MatrixType> void tsqr_threaded(Index rows, Index cols)
+{
+  typedef Matrix<typename MatrixType::Scalar,Dynamic,Dynamic> DenseMatrixType;
+  MatrixType a = MatrixType::Random(rows, cols);
+  MatrixType b = MatrixType::Random(rows, 2);
+
+  ThreadPoolInterface* pool = setGemmThreadPool(0);
+  TallSkinnyQR<MatrixType> ref;
+  ref.setBlockRows(4*cols).compute(a);
+  DenseMatrixType refX = ref.solve(b);
+  setGemmThreadPool(pool);
+
+  TallSkinnyQR<MatrixType> qr;
+  qr.setBlockRows(4*cols).compute(a);
+  VERIFY_IS_EQUAL(qr.blocks(), ref.blocks());
+  VERIFY_IS_APPROX(DenseMatrixType(qr.matrixR()), DenseMatrixType(ref.matrixR()));
+  VERIFY_IS_APPROX(qr.thinQ() * DenseMatrixType(qr.matrixR()), DenseMatrixType(a));
+  VERIFY_IS_APPROX(DenseMatrixType(qr.solve(b)), refX);
+}
+
+template<typename MatrixType> void eigensolver_threaded(Index size)
+{
+  MatrixType a = MatrixType::Random(size, size);
+  MatrixType s = a + a.adjoint();
+
+  ThreadPoolInterface* pool = setGemmThreadPool(0);
+  SelfAdjointEigenSolver<MatrixType> ref(s);
+  setGemmThreadPool(pool);
+
+  SelfAdjointEigenSolver<MatrixType> eig(s);
+  VERIFY_IS_EQUAL(eig.info(), Success);
+  VERIFY_IS_APPROX(eig.eigenvalues(), ref.eigenvalues());
+  VERIFY_IS_APPROX(s * eig.eigenvectors(), eig.eigenvectors() * eig.eigenvalues().asDiagonal());
+  VERIFY_IS_UNITARY(eig.eigenvectors());
+}
+
+template<typename MatrixType> void bdcsvd_threaded(Index rows, Index cols)
+{
+  MatrixType a = MatrixType::Random(rows, cols);
+
+  ThreadPoolInterface* pool = setGemmThreadPool(0);
+  BDCSVD<MatrixType> ref(a);
+  setGemmThreadPool(pool);
+
+  BDCSVD<MatrixType> svd(a, ComputeThinU | ComputeThinV);
+  VERIFY_IS_APPROX(svd.singularValues(), ref.singularValues());
+  VERIFY_IS_APPROX(svd.matrixU() * svd.singularValues().asDiagonal() * svd.matrixV().adjoint(), a);
+  VERIFY_IS_UNITARY(svd.matrixU());
+  VERIFY_IS_UNITARY(svd.matrixV());
+
+  svd.compute(a);
+  VERIFY_IS_APPROX(svd.singularValues(), ref.singularValues());
+}
+
+void test_product_threaded()
+{
+  ThreadPool pool(internal::random<int>(2,16));
+  VERIFY(setGemmThreadPool(&pool) == 0);
+  VERIFY(getGemmThreadPool() == &pool);
+  VERIFY_IS_EQUAL(nbThreads(), pool.NumThreads());
+
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( product_threaded(MatrixXf(internal::random<int>(1,3*EIGEN_TEST_MAX_SIZE), internal::random<int>(1,3*EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_2( product_threaded(MatrixXd(internal::random<int>(1,3*EIGEN_TEST_MAX_SIZE), internal::random<int>(1,3*EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_3( product_threaded(MatrixXcd(internal::random<int>(1,2*EIGEN_TEST_MAX_SIZE), internal::random<int>(1,2*EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_4( product_threaded(MatrixXi(internal::random<int>(1,3*EIGEN_TEST_MAX_SIZE), internal::random<int>(1,3*EIGEN_TEST_MAX_SIZE))) );
+  }
+
+  CALL_SUBTEST_5( product_threaded_shapes<float>() );
+  CALL_SUBTEST_5( product_threaded_gemv<float>() );
+  CALL_SUBTEST_5( product_threaded_concurrent<float>() );
+  CALL_SUBTEST_6( product_threaded_gemv<std::complex<double> >() );
+  CALL_SUBTEST_2( product_threaded_shapes<double>() );
+  CALL_SUBTEST_2( product_threaded_l3_groups<double>() );
+  CALL_SUBTEST_7( lu_threaded<MatrixXd>(internal::random<int>(256,700)) );
+  CALL_SUBTEST_7(( lu_threaded<Matrix<double,Dynamic,Dynamic,RowMajor> >(internal::random<int>(256,500)) ));
+  CALL_SUBTEST_8( lu_threaded<MatrixXcf>(internal::random<int>(256,400)) );
+  CALL_SUBTEST_7( tsqr_threaded<MatrixXd>(internal::random<int>(2000,20000), internal::random<int>(1,30)) );
+  CALL_SUBTEST_8( tsqr_threaded<MatrixXcf>(internal::random<int>(2000,10000), internal::random<int>(1,20)) );
+  CALL_SUBTEST_7( eigensolver_threaded<MatrixXd>(internal::random<int>(EIGEN_SELFADJOINT_DIVIDE_CONQUER_THRESHOLD,400)) );
+  CALL_SUBTEST_8( eigensolver_threaded<MatrixXcf>(internal::random<int>(EIGEN_SELFADJOINT_DIVIDE_CONQUER_THRESHOLD,300)) );
+  CALL_SUBTEST_7( bdcsvd_threaded<MatrixXd>(internal::random<int>(300,600), internal::random<int>(300,600)) );
+  CALL_SUBTEST_8( bdcsvd_threaded<MatrixXcf>(internal::random<int>(300,400), internal::random<int>(300,400)) );
+
+  // the number of threads can still be bounded by setNbThreads
+  setNbThreads(2);
+  VERIFY_IS_EQUAL(nbThreads(), 2);
+  CALL_SUBTEST_2( product_threaded(MatrixXd(internal::random<int>(200,400), internal::random<int>(200,400))) );
+  setNbThreads(0);
+
+  // all the tasks of a session, including the one run by the calling thread, disable nested parallelism
+  std::vector<char> nested(pool.NumThreads(), 0);
+  internal::parallelize_tasks(pool.NumThreads(), [&nested](Index i, Index) { nested[i] = internal::is_in_parallel_region(); });
+  VERIFY(std::find(nested.begin(), nested.end(), 0) == nested.end());
+  VERIFY(!internal::is_in_parallel_region());
+
+  // products issued from a thread of the pool are run sequentially
+  MatrixXd a = MatrixXd::Random(300,300), ref = a*a, res;
+  std::promise<void> done;
+  pool.Schedule([&]() { res = a*a; done.set_value(); });
+  done.get_future().wait();
+  VERIFY_IS_APPROX(res, ref);
+
+  setGemmThreadPool(0);
+}
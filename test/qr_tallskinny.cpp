@@ -0,0 +1,99 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <Eigen/QR>
+
+template<typename MatrixType> void qr_tallskinny(Index rows, Index cols, Index blockRows)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename MatrixType::RealScalar RealScalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrixType;
+
+  MatrixType a = MatrixType::Random(rows, cols);
+  TallSkinnyQR<MatrixType> qr;
+  qr.setBlockRows(blockRows).compute(a);
+  const Index size = (std::min)(rows, cols);
+  VERIFY_IS_EQUAL(qr.blocks(), (std::max)(rows / qr.blockRows(), Index(1)));
+
+  // A = Q R with a unitary Q
+  DenseMatrixType r = qr.matrixR();
+  VERIFY_IS_EQUAL(r.rows(), size);
+  VERIFY_IS_EQUAL(r.cols(), cols);
+  DenseMatrixType q = qr.thinQ();
+  VERIFY_IS_APPROX(q.adjoint() * q, DenseMatrixType::Identity(size, size));
+  VERIFY_IS_APPROX(q * r, DenseMatrixType(a));
+
+  // the full Q, and its adjoint
+  DenseMatrixType fullQ = DenseMatrixType::Identity(rows, rows);
+  qr.applyQOnTheLeft(fullQ);
+  VERIFY_IS_UNITARY(fullQ);
+  VERIFY_IS_APPROX(fullQ.leftCols(size), q);
+  DenseMatrixType c = fullQ;
+  qr.applyQAdjointOnTheLeft(c);
+  VERIFY_IS_APPROX(c, DenseMatrixType::Identity(rows, rows));
+  c = a;
+  qr.applyQAdjointOnTheLeft(c);
+  VERIFY_IS_APPROX(c.topRows(size), r);
+  VERIFY_IS_MUCH_SMALLER_THAN(c.bottomRows(rows-size).norm(), a.norm());
+
+  // R matches the one of HouseholderQR up to the signs of its rows
+  DenseMatrixType refR = HouseholderQR<MatrixType>(a).matrixQR().topRows(size).template triangularView<Upper>();
+  VERIFY_IS_APPROX(r.cwiseAbs(), refR.cwiseAbs());
+  if(qr.blocks()==1)
+    VERIFY_IS_EQUAL(r, refR);
+
+  // least-squares solutions
+  DenseMatrixType b = DenseMatrixType::Random(rows, 3);
+  DenseMatrixType x = qr.solve(b);
+  if(rows >= cols)
+  {
+    VERIFY_IS_APPROX(x, HouseholderQR<MatrixType>(a).solve(b));
+    VERIFY_IS_MUCH_SMALLER_THAN((a.adjoint() * (a * x - b)).norm(), a.norm() * b.norm());
+    VERIFY_IS_APPROX(DenseMatrixType(qr.solve(a)), DenseMatrixType::Identity(cols, cols));
+  }
+  else
+    VERIFY_IS_APPROX(a * x, b);
+}
+
+template<typename MatrixType> void qr_tallskinny_blocks()
+{
+  Index cols = internal::random<Index>(1, 20);
+  // a single block, a power of two and an odd number of blocks, and blocks of the minimal size
+  qr_tallskinny<MatrixType>(internal::random<Index>(cols, 50), cols, 0);
+  qr_tallskinny<MatrixType>(8*cols, cols, 2*cols);
+  qr_tallskinny<MatrixType>(internal::random<Index>(5*cols, 40*cols), cols, 2*cols+internal::random<Index>(0,cols));
+  qr_tallskinny<MatrixType>(internal::random<Index>(100, 300), internal::random<Index>(1, 3), 1);
+  // wide matrices are factorized as a single block
+  qr_tallskinny<MatrixType>(internal::random<Index>(1, 20), internal::random<Index>(21, 40), 1);
+}
+
+// a large matrix with the default blocks
+template<typename MatrixType> void qr_tallskinny_large(Index rows, Index cols)
+{
+  typedef Matrix<typename MatrixType::Scalar,Dynamic,Dynamic> DenseMatrixType;
+  MatrixType a = MatrixType::Random(rows, cols);
+  TallSkinnyQR<MatrixType> qr(a);
+  VERIFY(qr.blocks() > 1);
+  DenseMatrixType r = qr.matrixR();
+  VERIFY_IS_APPROX(qr.thinQ() * r, DenseMatrixType(a));
+  MatrixType b = MatrixType::Random(rows, 2);
+  VERIFY_IS_APPROX(DenseMatrixType(qr.solve(b)), DenseMatrixType(HouseholderQR<MatrixType>(a).solve(b)));
+}
+
+void test_qr_tallskinny()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( qr_tallskinny_blocks<MatrixXd>() );
+    CALL_SUBTEST_2( qr_tallskinny_blocks<MatrixXcf>() );
+    CALL_SUBTEST_3(( qr_tallskinny_blocks<Matrix<double,Dynamic,Dynamic,RowMajor> >() ));
+    CALL_SUBTEST_4(( qr_tallskinny<Matrix<float,Dynamic,4> >(internal::random<Index>(40,400), 4, 8) ));
+  }
+
+  CALL_SUBTEST_1( qr_tallskinny_large<MatrixXd>(100000, 10) );
+  CALL_SUBTEST_2( qr_tallskinny_large<MatrixXcf>(50000, 20) );
+}
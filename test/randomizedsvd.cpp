@@ -0,0 +1,127 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include "main.h"
+#include <Eigen/SVD>
+#include <Eigen/SparseCore>
+
+// Returns a rows-by-cols matrix whose singular values are decay^i, i being the index of the singular value
+template<typename MatrixType>
+MatrixType randomizedsvd_decaying(Index rows, Index cols, typename MatrixType::RealScalar decay, Index rank)
+{
+  typedef typename MatrixType::RealScalar RealScalar;
+  Index diagSize = (std::min)(rows, cols);
+  MatrixType u = MatrixType::Random(rows, diagSize).householderQr().householderQ() * MatrixType::Identity(rows, diagSize);
+  MatrixType v = MatrixType::Random(cols, diagSize).householderQr().householderQ() * MatrixType::Identity(cols, diagSize);
+  Matrix<RealScalar,Dynamic,1> s(diagSize);
+  for(Index i = 0; i < diagSize; ++i)
+    s(i) = i < rank ? std::pow(decay, RealScalar(i)) : RealScalar(0);
+  return u * s.asDiagonal() * v.adjoint();
+}
+
+template<typename MatrixType> void randomizedsvd(Index rows, Index cols)
+{
+  typedef typename MatrixType::RealScalar RealScalar;
+  const RealScalar decay = RealScalar(0.5);
+  Index k = internal::random<Index>(1, (std::min)(rows, cols));
+  MatrixType a = randomizedsvd_decaying<MatrixType>(rows, cols, decay, (std::min)(rows, cols));
+  JacobiSVD<MatrixType> ref(a);
+
+  RandomizedSVD<MatrixType> svd(a, k, ComputeThinU | ComputeThinV);
+  VERIFY_IS_EQUAL(svd.singularValues().size(), k);
+  VERIFY_IS_EQUAL(svd.matrixU().rows(), rows);
+  VERIFY_IS_EQUAL(svd.matrixU().cols(), k);
+  VERIFY_IS_EQUAL(svd.matrixV().rows(), cols);
+  VERIFY_IS_EQUAL(svd.matrixV().cols(), k);
+  VERIFY_IS_APPROX(svd.singularValues(), ref.singularValues().head(k));
+  // the singular values of the projection of a do not exceed those of a
+  VERIFY((svd.singularValues() - ref.singularValues().head(k)).maxCoeff() <= test_precision<RealScalar>() * ref.singularValues()(0));
+  VERIFY_IS_UNITARY(svd.matrixU());
+  VERIFY_IS_UNITARY(svd.matrixV());
+  // the approximation error is of the order of the (k+1)-th singular value
+  MatrixType approx = svd.matrixU() * svd.singularValues().asDiagonal() * svd.matrixV().adjoint();
+  RealScalar next = k < ref.singularValues().size() ? ref.singularValues()(k) : RealScalar(0);
+  VERIFY((a - approx).norm() <= RealScalar(2) * next * std::sqrt(RealScalar(k+1)) + test_precision<RealScalar>() * a.norm());
+
+  // the singular values only
+  RandomizedSVD<MatrixType> values;
+  values.setOversampling(5).setPowerIterations(3);
+  VERIFY_IS_EQUAL(values.oversampling(), 5);
+  VERIFY_IS_EQUAL(values.powerIterations(), 3);
+  values.compute(a, k);
+  VERIFY_IS_APPROX(values.singularValues(), ref.singularValues().head(k));
+
+  // the sample is drawn from the seed only
+  values.setSeed(1234);
+  VERIFY_IS_EQUAL(values.seed(), 1234u);
+  values.compute(a, k);
+  Matrix<RealScalar,Dynamic,1> seeded = values.singularValues();
+  values.compute(a, k);
+  VERIFY_IS_EQUAL(values.singularValues(), seeded);
+  VERIFY_IS_APPROX(seeded, ref.singularValues().head(k));
+
+  // a well-conditioned matrix of rank r <= k is reproduced exactly, and the solution of the least-squares problems
+  // matches the one of JacobiSVD
+  Index r = internal::random<Index>(1, (std::min)(k, Index(20)));
+  MatrixType b = randomizedsvd_decaying<MatrixType>(rows, cols, RealScalar(0.8), r);
+  svd.compute(b, k);
+  VERIFY_IS_EQUAL(svd.rank(), r);
+  VERIFY_IS_APPROX(svd.matrixU() * svd.singularValues().asDiagonal() * svd.matrixV().adjoint(), b);
+  MatrixType rhs = MatrixType::Random(rows, 3);
+  VERIFY_IS_APPROX(svd.solve(rhs), JacobiSVD<MatrixType>(b, ComputeThinU | ComputeThinV).solve(rhs));
+}
+
+template<typename Scalar> void randomizedsvd_sparse()
+{
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrixType;
+  Index rows = internal::random<Index>(100,300), cols = internal::random<Index>(100,300);
+  Index diagSize = (std::min)(rows, cols);
+  Index k = internal::random<Index>(1,20);
+
+  // a permuted diagonal matrix, whose singular values are the magnitudes of its coefficients
+  Matrix<RealScalar,Dynamic,1> values = Matrix<RealScalar,Dynamic,1>::Random(diagSize).cwiseAbs();
+  PermutationMatrix<Dynamic> rowPerm(rows), colPerm(cols);
+  rowPerm.setIdentity();
+  colPerm.setIdentity();
+  for(Index i = 0; i < diagSize; ++i)
+  {
+    std::swap(rowPerm.indices()(i), rowPerm.indices()(internal::random<Index>(i, rows-1)));
+    std::swap(colPerm.indices()(i), colPerm.indices()(internal::random<Index>(i, cols-1)));
+  }
+  std::vector<Triplet<Scalar> > triplets;
+  for(Index i = 0; i < diagSize; ++i)
+  {
+    RealScalar value = std::pow(RealScalar(0.7), RealScalar(i)) * (RealScalar(1) + values(i)) / RealScalar(2);
+    triplets.push_back(Triplet<Scalar>(rowPerm.indices()(i), colPerm.indices()(i), Scalar(value)));
+  }
+  SparseMatrix<Scalar> a(rows, cols);
+  a.setFromTriplets(triplets.begin(), triplets.end());
+  DenseMatrixType dense = a;
+
+  RandomizedSVD<SparseMatrix<Scalar> > svd(a, k, ComputeThinU | ComputeThinV);
+  JacobiSVD<DenseMatrixType> ref(dense);
+  VERIFY_IS_APPROX(svd.singularValues(), ref.singularValues().head(k));
+  VERIFY_IS_UNITARY(svd.matrixU());
+  VERIFY_IS_UNITARY(svd.matrixV());
+  VERIFY_IS_APPROX(a * svd.matrixV(), svd.matrixU() * svd.singularValues().asDiagonal());
+}
+
+void test_randomizedsvd()
+{
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1(( randomizedsvd<MatrixXd>(internal::random<Index>(1,200), internal::random<Index>(1,200)) ));
+    CALL_SUBTEST_2(( randomizedsvd<MatrixXf>(internal::random<Index>(1,100), internal::random<Index>(1,100)) ));
+    CALL_SUBTEST_3(( randomizedsvd<MatrixXcd>(internal::random<Index>(1,100), internal::random<Index>(1,100)) ));
+    CALL_SUBTEST_4(( randomizedsvd<Matrix<double,Dynamic,Dynamic,RowMajor> >(internal::random<Index>(1,100), internal::random<Index>(1,100)) ));
+    CALL_SUBTEST_5(( randomizedsvd_sparse<double>() ));
+    CALL_SUBTEST_5(( randomizedsvd_sparse<std::complex<float> >() ));
+  }
+
+  // an empty number of singular values
+  CALL_SUBTEST_1(( VERIFY_IS_EQUAL(RandomizedSVD<MatrixXd>(MatrixXd::Random(10,5), 0, ComputeThinU).matrixU().cols(), 0) ));
+}
@@ -0,0 +1,102 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define EIGEN_GEMM_THREADPOOL
+#define EIGEN_DETERMINISTIC_REDUCTION
+// split even small reductions, into many chunks
+#define EIGEN_REDUCTION_MIN_TASK_COST 64
+#define EIGEN_DETERMINISTIC_REDUCTION_CHUNK_SIZE 256
+#include "main.h"
+#include <unsupported/Eigen/CXX11/ThreadPool>
+
+template<typename Scalar> struct redux_results
+{
+  Scalar sum, prod, dot;
+  typename NumTraits<Scalar>::Real squaredNorm, blockSum, minCoeff, maxCoeff, stableNorm, blueNorm;
+};
+
+template<typename MatrixType>
+redux_results<typename MatrixType::Scalar> compute_reductions(const MatrixType& a, const MatrixType& b, Index r, Index nr)
+{
+  redux_results<typename MatrixType::Scalar> res;
+  res.sum = a.sum();
+  res.prod = (a.array()*0.01+1).prod();
+  res.dot = a.col(0).dot(b.col(0));
+  res.squaredNorm = a.squaredNorm();
+  res.blockSum = numext::real(a.middleRows(r,nr).sum());
+  res.minCoeff = a.real().minCoeff();
+  res.maxCoeff = b.real().maxCoeff();
+  Map<const Matrix<typename MatrixType::Scalar,Dynamic,1> > va(a.data(), a.size());
+  res.stableNorm = va.stableNorm();
+  res.blueNorm = va.blueNorm();
+  return res;
+}
+
+// the results must be bitwise identical whatever the number of threads
+template<typename MatrixType> void redux_threaded(const MatrixType& m)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  Index rows = m.rows();
+  Index cols = m.cols();
+  MatrixType a = MatrixType::Random(rows, cols);
+  MatrixType b = MatrixType::Random(rows, cols);
+  Index r = internal::random<Index>(0,rows-1), nr = internal::random<Index>(1,rows-r);
+
+  ThreadPoolInterface* pool = setGemmThreadPool(0);
+  redux_results<Scalar> ref = compute_reductions(a, b, r, nr);
+  setGemmThreadPool(pool);
+
+  for(int threads = 1; threads <= 8; threads *= 2)
+  {
+    setNbThreads(threads);
+    redux_results<Scalar> res = compute_reductions(a, b, r, nr);
+    VERIFY(res.sum == ref.sum);
+    VERIFY(res.prod == ref.prod);
+    VERIFY(res.dot == ref.dot);
+    VERIFY(res.squaredNorm == ref.squaredNorm);
+    VERIFY(res.blockSum == ref.blockSum);
+    VERIFY(res.minCoeff == ref.minCoeff);
+    VERIFY(res.maxCoeff == ref.maxCoeff);
+    VERIFY(res.stableNorm == ref.stableNorm);
+    VERIFY(res.blueNorm == ref.blueNorm);
+  }
+  setNbThreads(0);
+
+  // compare to a naive accumulation in double precision: the sum of the zero-mean coefficients nearly cancels,
+  // hence the error is relative to the sum of their absolute values
+  typedef typename internal::conditional<NumTraits<Scalar>::IsComplex, std::complex<double>, double>::type AccScalar;
+  AccScalar s(0);
+  RealScalar mn = numext::real(a(0,0));
+  for(Index j = 0; j < cols; ++j)
+    for(Index i = 0; i < rows; ++i)
+    {
+      s += AccScalar(a(i,j));
+      mn = (std::min)(mn, numext::real(a(i,j)));
+    }
+  VERIFY_IS_MUCH_SMALLER_THAN(ref.sum - Scalar(s), a.cwiseAbs().sum());
+  VERIFY_IS_EQUAL(ref.minCoeff, mn);
+  VERIFY_IS_APPROX(ref.squaredNorm, a.cwiseAbs2().eval().sum());
+  VERIFY_IS_APPROX(ref.stableNorm, a.norm());
+  VERIFY_IS_APPROX(ref.blueNorm, a.norm());
+}
+
+void test_redux_threaded()
+{
+  ThreadPool pool(8);
+  setGemmThreadPool(&pool);
+
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_1( redux_threaded(MatrixXf(internal::random<int>(1,10*EIGEN_TEST_MAX_SIZE), internal::random<int>(1,10*EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_2( redux_threaded(MatrixXd(internal::random<int>(1,10*EIGEN_TEST_MAX_SIZE), internal::random<int>(1,EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_3( redux_threaded(Matrix<double,Dynamic,Dynamic,RowMajor>(internal::random<int>(1,EIGEN_TEST_MAX_SIZE), internal::random<int>(1,10*EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_4( redux_threaded(MatrixXcd(internal::random<int>(1,5*EIGEN_TEST_MAX_SIZE), internal::random<int>(1,5*EIGEN_TEST_MAX_SIZE))) );
+    CALL_SUBTEST_5( redux_threaded(VectorXf(internal::random<int>(1,100000))) );
+  }
+
+  setGemmThreadPool(0);
+}
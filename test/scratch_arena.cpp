@@ -0,0 +1,127 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#define EIGEN_SCRATCH_ARENA
+#define EIGEN_RUNTIME_NO_MALLOC
+#include <thread>
+#include "main.h"
+
+template<typename MatrixType> void scratch_arena_product(Index size)
+{
+  MatrixType a = MatrixType::Random(size, size), b = MatrixType::Random(size, size), c(size, size);
+  MatrixType ref = a.lazyProduct(b);
+
+  // the first product allocates its blocking buffers
+  c.noalias() = a * b;
+  VERIFY_IS_APPROX(c, ref);
+  VERIFY(scratchArenaCachedBytes() > 0);
+
+  // the next ones reuse them
+  for(int k = 0; k < 2; ++k)
+  {
+    internal::set_is_malloc_allowed(k==0);
+    c.noalias() = a * b;
+    c.noalias() += a.transpose() * b;
+    c.noalias() -= a.transpose() * b;
+    c.template triangularView<Lower>() = a * b;
+  }
+  internal::set_is_malloc_allowed(true);
+  VERIFY_IS_APPROX(c.template triangularView<Lower>().toDenseMatrix(), ref.template triangularView<Lower>().toDenseMatrix());
+
+  // the arena of another thread is independent
+  std::size_t cached = scratchArenaCachedBytes();
+  std::size_t otherCached = 0;
+  std::thread thread([&]() {
+    MatrixType d = a * b;
+    otherCached = scratchArenaCachedBytes();
+    VERIFY_IS_APPROX(d, ref);
+  });
+  thread.join();
+  VERIFY(otherCached > 0);
+  VERIFY_IS_EQUAL(scratchArenaCachedBytes(), cached);
+
+  {
+    ScratchArenaScope scope;
+    c.noalias() = a * b;
+    VERIFY(scratchArenaCachedBytes() > 0);
+  }
+  VERIFY_IS_EQUAL(scratchArenaCachedBytes(), std::size_t(0));
+  VERIFY_IS_APPROX(c, ref);
+}
+
+void scratch_arena_limits()
+{
+  releaseScratchArena();
+  // at most EIGEN_SCRATCH_ARENA_BLOCKS_PER_CLASS buffers of each class are kept
+  void* ptrs[EIGEN_SCRATCH_ARENA_BLOCKS_PER_CLASS+1];
+  for(int k = 0; k <= EIGEN_SCRATCH_ARENA_BLOCKS_PER_CLASS; ++k)
+    ptrs[k] = internal::scratch_malloc(1000);
+  for(int k = 0; k <= EIGEN_SCRATCH_ARENA_BLOCKS_PER_CLASS; ++k)
+    internal::scratch_free(ptrs[k], 1000);
+  VERIFY_IS_EQUAL(scratchArenaCachedBytes(), std::size_t(1024*EIGEN_SCRATCH_ARENA_BLOCKS_PER_CLASS));
+
+  // buffers are reused within their size class, and are aligned
+  void* p = internal::scratch_malloc(600);
+  VERIFY_IS_EQUAL(scratchArenaCachedBytes(), std::size_t(1024*(EIGEN_SCRATCH_ARENA_BLOCKS_PER_CLASS-1)));
+  VERIFY((internal::UIntPtr(p) % EIGEN_DEFAULT_ALIGN_BYTES) == 0);
+  internal::scratch_free(p, 600);
+
+  // the temporaries too large for the stack
+  const std::size_t size = 2*EIGEN_STACK_ALLOCATION_LIMIT;
+  for(int k = 0; k < 2; ++k)
+  {
+    internal::set_is_malloc_allowed(k==0);
+    ei_declare_aligned_stack_constructed_variable(char, buffer, size, 0);
+    buffer[size-1] = 1;
+  }
+  internal::set_is_malloc_allowed(true);
+
+  releaseScratchArena();
+  VERIFY_IS_EQUAL(scratchArenaCachedBytes(), std::size_t(0));
+}
+
+// a thread_local object constructed before the arena of its thread, and thus destroyed after it
+template<typename MatrixType> struct scratch_arena_late_user
+{
+  scratch_arena_late_user() : size(0) {}
+  ~scratch_arena_late_user()
+  {
+    if(size==0)
+      return;
+    // the temporary buffers are allocated and freed directly
+    void* p = internal::scratch_malloc(1000);
+    internal::scratch_free(p, 1000);
+    MatrixType a = MatrixType::Random(size, size), b = MatrixType::Random(size, size);
+    MatrixType c = a * b;
+    VERIFY_IS_APPROX(c, a.lazyProduct(b));
+    VERIFY_IS_EQUAL(scratchArenaCachedBytes(), std::size_t(0));
+    releaseScratchArena();
+  }
+  Index size;
+};
+
+template<typename MatrixType> void scratch_arena_destroyed(Index size)
+{
+  std::thread thread([size]() {
+    static thread_local scratch_arena_late_user<MatrixType> user;
+    user.size = size;
+    MatrixType a = MatrixType::Random(size, size), b = MatrixType::Random(size, size);
+    MatrixType c = a * b;
+    VERIFY(scratchArenaCachedBytes() > 0);
+  });
+  thread.join();
+}
+
+void test_scratch_arena()
+{
+  CALL_SUBTEST_1( scratch_arena_limits() );
+  CALL_SUBTEST_1( scratch_arena_product<MatrixXf>(internal::random<int>(300,500)) );
+  CALL_SUBTEST_2( scratch_arena_product<MatrixXd>(internal::random<int>(300,500)) );
+  CALL_SUBTEST_3( scratch_arena_product<MatrixXcd>(internal::random<int>(100,200)) );
+  CALL_SUBTEST_1( scratch_arena_destroyed<MatrixXf>(internal::random<int>(300,500)) );
+  CALL_SUBTEST_3( scratch_arena_destroyed<MatrixXcd>(internal::random<int>(100,200)) );
+}
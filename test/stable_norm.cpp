@@ -190,6 +190,45 @@ template<typename MatrixType> void stable_norm(const MatrixType& m)
   }
 }
 
+// long vectors mixing small, medium and large coefficients, by blocks or not,
+// as classified by the vectorized and parallel versions of blueNorm
+template<typename Scalar> void stable_norm_mixed()
+{
+  using std::sqrt;
+  using std::abs;
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef long double LongScalar;
+  Index n = internal::random<Index>(1000,50000);
+  Scalar magnitudes[] = { (std::numeric_limits<Scalar>::min)() * Scalar(1e4), Scalar(1),
+                          (std::numeric_limits<Scalar>::max)() * Scalar(1e-4) / Scalar(n) };
+
+  for(int k = 0; k < 4; ++k)
+  {
+    VectorType v(n);
+    Index blockSize = k==3 ? 1 : internal::random<Index>(1,100);
+    for(Index i = 0; i < n; i += blockSize)
+    {
+      Index bs = (std::min)(blockSize, n-i);
+      // k<3: only some of the magnitudes
+      int m = internal::random<int>(0, k<3 ? k : 2);
+      v.segment(i,bs) = VectorType::Random(bs) * magnitudes[m];
+    }
+    LongScalar vmax = v.cwiseAbs().maxCoeff(), ssq = 0;
+    for(Index i = 0; i < n; ++i)
+      ssq += numext::abs2(LongScalar(v(i))/vmax);
+    Scalar ref = Scalar(vmax*sqrt(ssq));
+    VERIFY_IS_APPROX(v.blueNorm(), ref);
+    VERIFY_IS_APPROX(v.stableNorm(), ref);
+    VERIFY_IS_APPROX(v.segment(1,n-1).blueNorm(), v.segment(1,n-1).stableNorm());
+
+    // a NaN among small coefficients
+    VectorType w = VectorType::Random(n) * magnitudes[0];
+    w(internal::random<Index>(0,n-1)) = std::numeric_limits<Scalar>::quiet_NaN();
+    VERIFY((numext::isnan)(w.blueNorm()));
+    VERIFY((numext::isnan)(w.stableNorm()));
+  }
+}
+
 void test_stable_norm()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -198,5 +237,7 @@ void test_stable_norm()
     CALL_SUBTEST_3( stable_norm(VectorXd(internal::random<int>(10,2000))) );
     CALL_SUBTEST_4( stable_norm(VectorXf(internal::random<int>(10,2000))) );
     CALL_SUBTEST_5( stable_norm(VectorXcd(internal::random<int>(10,2000))) );
+    CALL_SUBTEST_3( stable_norm_mixed<double>() );
+    CALL_SUBTEST_4( stable_norm_mixed<float>() );
   }
 }
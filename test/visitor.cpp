@@ -115,6 +115,98 @@ template<typename VectorType> void vectorVisitor(const VectorType& w)
   VERIFY(eigen_maxidx == (std::min)(idx0,idx2));
 }
 
+// reference min and max with index, with the semantic of the sequential visit: the first coefficient initializes the result,
+// which is then updated by the strictly lower (resp. greater) coefficients only.
+template<typename MatrixType>
+void sequentialMinMax(const MatrixType& m, Index& minrow, Index& mincol, Index& maxrow, Index& maxcol)
+{
+  typename MatrixType::Scalar minc = m(0,0), maxc = m(0,0);
+  minrow = mincol = maxrow = maxcol = 0;
+  for(Index j = 0; j < m.cols(); j++)
+    for(Index i = 0; i < m.rows(); i++)
+    {
+      if(m(i,j) < minc) { minc = m(i,j); minrow = i; mincol = j; }
+      if(m(i,j) > maxc) { maxc = m(i,j); maxrow = i; maxcol = j; }
+    }
+}
+
+template<typename MatrixType>
+void checkMinMaxIndex(const MatrixType& m)
+{
+  Index minrow, mincol, maxrow, maxcol, r, c;
+  sequentialMinMax(m, minrow, mincol, maxrow, maxcol);
+  typename MatrixType::Scalar minc = m.minCoeff(&r,&c);
+  VERIFY(r == minrow && c == mincol);
+  VERIFY((numext::isnan)(minc) ? (numext::isnan)(m(minrow,mincol)) : minc == m(minrow,mincol));
+  typename MatrixType::Scalar maxc = m.maxCoeff(&r,&c);
+  VERIFY(r == maxrow && c == maxcol);
+  VERIFY((numext::isnan)(maxc) ? (numext::isnan)(m(maxrow,maxcol)) : maxc == m(maxrow,maxcol));
+}
+
+// large objects visited with packets: ties, special values, and various expressions
+template<typename Scalar> void vectorizedVisitor(bool nan)
+{
+  typedef Matrix<Scalar,Dynamic,1> VectorType;
+  typedef Matrix<Scalar,Dynamic,Dynamic> MatrixType;
+  Index size = internal::random<Index>(1,2000);
+  // few distinct values to get many ties
+  VectorType v = VectorType::Random(size) / Scalar(16);
+  v = v.array().round();
+
+  checkMinMaxIndex(v);
+  checkMinMaxIndex(v.transpose());
+  checkMinMaxIndex(v.array().abs());
+  if(size>1)
+  {
+    Map<VectorType> map(v.data()+1, size-1);
+    checkMinMaxIndex(map);
+  }
+  if(nan)
+  {
+    VectorType w = v;
+    w(internal::random<Index>(0,size-1)) = NumTraits<Scalar>::quiet_NaN();
+    checkMinMaxIndex(w);
+    w(internal::random<Index>(0,size-1)) = NumTraits<Scalar>::infinity();
+    w(internal::random<Index>(0,size-1)) = -NumTraits<Scalar>::infinity();
+    checkMinMaxIndex(w);
+    w(0) = NumTraits<Scalar>::quiet_NaN();
+    checkMinMaxIndex(w);
+  }
+
+  Index rows = internal::random<Index>(1,300), cols = internal::random<Index>(1,30);
+  MatrixType m = (MatrixType::Random(rows,cols) * Scalar(100)).array().round();
+  checkMinMaxIndex(m);
+  if(rows>1 && cols>1)
+  {
+    checkMinMaxIndex(m.block(1,1,rows-1,cols-1).eval());
+    checkMinMaxIndex(m.block(1,1,rows-1,cols-1));
+  }
+  checkMinMaxIndex(Matrix<Scalar,Dynamic,Dynamic,RowMajor>(m));
+}
+
+// a visitor of the user whose functor_traits only define a Cost
+template<typename Scalar> struct sum_visitor
+{
+  Scalar sum;
+  void init(const Scalar& value, Index, Index) { sum = value; }
+  void operator()(const Scalar& value, Index, Index) { sum += value; }
+};
+
+namespace Eigen { namespace internal {
+template<typename Scalar> struct functor_traits<sum_visitor<Scalar> > { enum { Cost = NumTraits<Scalar>::AddCost }; };
+} }
+
+template<typename Scalar> void userVisitor()
+{
+  Matrix<Scalar,Dynamic,1> v = Matrix<Scalar,Dynamic,1>::Random(internal::random<Index>(1,2000));
+  sum_visitor<Scalar> visitor;
+  v.visit(visitor);
+  VERIFY_IS_EQUAL(visitor.sum, v.sum());
+  Matrix<Scalar,4,4> m = Matrix<Scalar,4,4>::Random();
+  m.visit(visitor);
+  VERIFY_IS_EQUAL(visitor.sum, m.sum());
+}
+
 void test_visitor()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -132,4 +224,10 @@ void test_visitor()
     CALL_SUBTEST_9( vectorVisitor(RowVectorXd(10)) );
     CALL_SUBTEST_10( vectorVisitor(VectorXf(33)) );
   }
+  for(int i = 0; i < g_repeat; i++) {
+    CALL_SUBTEST_11( vectorizedVisitor<float>(true) );
+    CALL_SUBTEST_11( vectorizedVisitor<double>(true) );
+    CALL_SUBTEST_12( vectorizedVisitor<int>(false) );
+    CALL_SUBTEST_12( userVisitor<int>() );
+  }
 }
@@ -128,8 +128,9 @@ struct ThreadPoolDevice {
   }
 
   EIGEN_STRONG_INLINE size_t lastLevelCacheSize() const {
-    // The l3 cache size is shared between all the cores.
-    return l3CacheSize() / num_threads_;
+    // The l3 cache size is shared between the cores of a group, which might be all the cores.
+    const std::ptrdiff_t l3_sharing = l3CacheSharing();
+    return l3CacheSize() / (l3_sharing > 0 ? numext::mini<std::ptrdiff_t>(num_threads_, l3_sharing) : num_threads_);
   }
 
   EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE int majorDeviceVersion() const {